@@ -0,0 +1,100 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "allocationcounter.h"
+
+#include <cerrno>
+#include <cstdlib>
+
+namespace
+{
+// Plain per-thread integer: no constructor, so touching it from inside malloc can't allocate
+thread_local quint64 s_allocations = 0;
+}
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void *__libc_valloc(size_t size);
+void *__libc_pvalloc(size_t size);
+
+void *malloc(size_t size) noexcept
+{
+    ++s_allocations;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept
+{
+    ++s_allocations;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) noexcept
+{
+    ++s_allocations;
+    return __libc_realloc(pointer, size);
+}
+
+void *memalign(size_t alignment, size_t size) noexcept
+{
+    ++s_allocations;
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) noexcept
+{
+    ++s_allocations;
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **pointer, size_t alignment, size_t size) noexcept
+{
+    // glibc has no __libc_ entry for this one, so do its argument checks in front of memalign
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0) {
+        return EINVAL;
+    }
+    ++s_allocations;
+    void *memory = __libc_memalign(alignment, size);
+    if (!memory) {
+        return ENOMEM;
+    }
+    *pointer = memory;
+    return 0;
+}
+
+void *valloc(size_t size) noexcept
+{
+    ++s_allocations;
+    return __libc_valloc(size);
+}
+
+void *pvalloc(size_t size) noexcept
+{
+    ++s_allocations;
+    return __libc_pvalloc(size);
+}
+}
+#endif
+
+namespace AllocationCounter
+{
+bool available()
+{
+#if defined(__GLIBC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+quint64 count()
+{
+    return s_allocations;
+}
+}
@@ -0,0 +1,24 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * Heap allocations made by the calling thread.
+ *
+ * Qt containers allocate through malloc rather than operator new, so on glibc every
+ * allocating entry point (malloc, calloc, realloc and the aligned variants) is wrapped
+ * to count calls before forwarding to the libc implementation. Elsewhere nothing is
+ * counted and available() is false.
+ *
+ * Only linked into the benchmarks, never into the application.
+ */
+namespace AllocationCounter
+{
+bool available();
+quint64 count();
+}
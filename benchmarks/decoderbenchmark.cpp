@@ -0,0 +1,209 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include <QDBusArgument>
+#include <QDBusObjectPath>
+#include <QTest>
+
+#include <functional>
+
+#include "microbenchmark.h"
+#include "portaldecoders.h"
+#include "samplepayloads.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+using SamplePayloads::GenericShortcuts;
+using SamplePayloads::GenericStreams;
+
+std::pair<int, int> genericIntPair(const QVariant &value)
+{
+    int first = 0;
+    int second = 0;
+    const auto argument = value.value<QDBusArgument>();
+    argument.beginStructure();
+    argument >> first >> second;
+    argument.endStructure();
+    return {first, second};
+}
+
+// Every decoder takes the received argument by value: reading detaches the copy, so the sample stays at its start
+quint64 genericStreams(QDBusArgument argument)
+{
+    GenericStreams decoded;
+    argument >> decoded;
+    quint64 checksum = 0;
+    for (const auto &[nodeId, properties] : std::as_const(decoded)) {
+        checksum += nodeId + properties.value(u"source_type"_s).toUInt() + genericIntPair(properties.value(u"size"_s)).first
+            + properties.value(u"id"_s).toString().size();
+    }
+    return checksum;
+}
+
+quint64 flatStreams(QDBusArgument argument, QList<PortalDecoders::Stream> &streams)
+{
+    PortalDecoders::decodeStreams(argument, streams);
+    quint64 checksum = 0;
+    for (const auto &stream : std::as_const(streams)) {
+        checksum += stream.nodeId + stream.sourceType + stream.size.width() + stream.id.size();
+    }
+    return checksum;
+}
+
+quint64 genericShortcuts(QDBusArgument argument)
+{
+    GenericShortcuts decoded;
+    argument >> decoded;
+    quint64 checksum = 0;
+    for (const auto &[id, properties] : std::as_const(decoded)) {
+        checksum += id.size() + properties.value(u"description"_s).toString().size() + properties.value(u"trigger_description"_s).toString().size();
+    }
+    return checksum;
+}
+
+quint64 flatShortcuts(QDBusArgument argument, QList<PortalDecoders::Shortcut> &shortcuts)
+{
+    PortalDecoders::decodeShortcuts(argument, shortcuts);
+    quint64 checksum = 0;
+    for (const auto &shortcut : std::as_const(shortcuts)) {
+        checksum += shortcut.id.size() + shortcut.description.size() + shortcut.triggerDescription.size();
+    }
+    return checksum;
+}
+
+quint64 genericLocation(QDBusArgument argument)
+{
+    QVariantMap decoded;
+    argument >> decoded;
+    quint64 timestamp = 0;
+    const auto timestampArgument = decoded.value(u"Timestamp"_s).value<QDBusArgument>();
+    timestampArgument.beginStructure();
+    timestampArgument >> timestamp;
+    timestampArgument.endStructure();
+    return quint64(decoded.value(u"Latitude"_s).toDouble() + decoded.value(u"Longitude"_s).toDouble() + decoded.value(u"Accuracy"_s).toDouble()) + timestamp;
+}
+
+quint64 flatLocation(QDBusArgument argument, PortalDecoders::Location &location)
+{
+    PortalDecoders::decodeLocation(argument, location);
+    return quint64(location.latitude + location.longitude + location.accuracy) + location.timestampSeconds;
+}
+
+quint64 genericPrint(QDBusArgument argument)
+{
+    QVariantMap results;
+    argument >> results;
+    QVariantMap settings;
+    QVariantMap pageSetup;
+    results.value(u"settings"_s).value<QDBusArgument>() >> settings;
+    results.value(u"page-setup"_s).value<QDBusArgument>() >> pageSetup;
+    return quint64(settings.value(u"n-copies"_s).toString().toInt() + pageSetup.value(u"MarginTop"_s).toDouble()
+                   + pageSetup.value(u"Orientation"_s).toString().size())
+        + results.value(u"token"_s).toUInt();
+}
+
+quint64 flatPrint(QDBusArgument argument, PortalDecoders::PrintSetup &setup)
+{
+    // Response(u, a{sv}) reaches the slot as a QVariantMap either way, only the nested dictionaries differ
+    QVariantMap results;
+    argument >> results;
+    PortalDecoders::decodePrintSetup(results, setup);
+    return quint64(setup.copies + setup.marginTop + setup.orientation.size()) + setup.token;
+}
+}
+
+/// Times the flat PortalDecoders against generic QVariantMap demarshalling, on messages that went over the session bus
+class DecoderBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void decode_data();
+    void decode();
+
+private:
+    struct Case {
+        QString name;
+        std::function<quint64()> generic;
+        std::function<quint64()> flat;
+    };
+
+    QList<Case> m_cases;
+
+    // Reused across iterations, as a long-lived caller would
+    QList<PortalDecoders::Stream> m_streams;
+    QList<PortalDecoders::Shortcut> m_shortcuts;
+    PortalDecoders::Location m_location;
+    PortalDecoders::PrintSetup m_setup;
+};
+
+void DecoderBenchmark::initTestCase()
+{
+    SamplePayloads::registerDBusTypes();
+
+    const QDBusObjectPath session(u"/org/freedesktop/portal/desktop/session/1_1/t1"_s);
+    const QList<QDBusMessage> samples = MicroBenchmark::roundTrip({
+        {QVariant::fromValue(SamplePayloads::streams(4))},
+        {QVariant::fromValue(SamplePayloads::streams(64))},
+        {QVariant::fromValue(SamplePayloads::shortcuts(100))},
+        {QVariant::fromValue(SamplePayloads::shortcuts(10000))},
+        {QVariant::fromValue(session), SamplePayloads::location()},
+        {0U, SamplePayloads::printResults()},
+    });
+    QVERIFY2(!samples.isEmpty(), "the samples need a session bus to round-trip over");
+
+    // Taken out of the messages once, so no iteration pays for copying their argument lists
+    const auto argumentAt = [&samples](int sample, int index) {
+        return samples.at(sample).arguments().at(index).value<QDBusArgument>();
+    };
+    const QDBusArgument fewStreams = argumentAt(0, 0);
+    const QDBusArgument manyStreams = argumentAt(1, 0);
+    const QDBusArgument fewShortcuts = argumentAt(2, 0);
+    const QDBusArgument manyShortcuts = argumentAt(3, 0);
+    const QDBusArgument location = argumentAt(4, 1);
+    const QDBusArgument print = argumentAt(5, 1);
+
+    m_cases = {
+        {u"streams x4"_s, [=] { return genericStreams(fewStreams); }, [=, this] { return flatStreams(fewStreams, m_streams); }},
+        {u"streams x64"_s, [=] { return genericStreams(manyStreams); }, [=, this] { return flatStreams(manyStreams, m_streams); }},
+        {u"shortcuts x100"_s, [=] { return genericShortcuts(fewShortcuts); }, [=, this] { return flatShortcuts(fewShortcuts, m_shortcuts); }},
+        {u"shortcuts x10000"_s, [=] { return genericShortcuts(manyShortcuts); }, [=, this] { return flatShortcuts(manyShortcuts, m_shortcuts); }},
+        {u"location"_s, [=] { return genericLocation(location); }, [=, this] { return flatLocation(location, m_location); }},
+        {u"print setup"_s, [=] { return genericPrint(print); }, [=, this] { return flatPrint(print, m_setup); }},
+    };
+}
+
+void DecoderBenchmark::decode_data()
+{
+    QTest::addColumn<int>("index");
+    QTest::addColumn<bool>("flat");
+    for (int i = 0; i < m_cases.size(); ++i) {
+        QTest::addRow("%s QVariantMap", qPrintable(m_cases.at(i).name)) << i << false;
+        QTest::addRow("%s flat", qPrintable(m_cases.at(i).name)) << i << true;
+    }
+}
+
+void DecoderBenchmark::decode()
+{
+    QFETCH(int, index);
+    QFETCH(bool, flat);
+    const Case &c = m_cases.at(index);
+    QCOMPARE(c.flat(), c.generic());
+
+    const std::function<quint64()> &operation = flat ? c.flat : c.generic;
+    MicroBenchmark::reportAllocations(operation);
+    quint64 checksum = 0;
+    QBENCHMARK {
+        checksum += operation();
+    }
+    QVERIFY(checksum > 0);
+}
+
+QTEST_GUILESS_MAIN(DecoderBenchmark)
+
+#include "decoderbenchmark.moc"
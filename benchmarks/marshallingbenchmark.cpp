@@ -0,0 +1,150 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include <QDBusArgument>
+#include <QTest>
+
+#include "microbenchmark.h"
+#include "portalicon.h"
+#include "samplepayloads.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+/// Marshals into a fresh QDBusArgument, which is backed by a real libdbus message just like an outgoing call
+template<typename T>
+void marshal(const T &value)
+{
+    QDBusArgument argument;
+    argument << value;
+}
+
+/// Taken by value: reading detaches the copy, so the received sample stays at its start for the next iteration
+quint64 demarshalIcon(QDBusArgument argument)
+{
+    PortalIcon icon;
+    argument >> icon;
+    return icon.str.size() + icon.data.variant().toByteArray().size() + icon.data.variant().toStringList().size();
+}
+}
+
+/// Times the hand-written D-Bus (de)marshallers at realistic and extreme payload sizes
+class MarshallingBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void marshalIcon_data();
+    void marshalIcon();
+    void demarshalIcon_data();
+    void demarshalIcon();
+    void marshalStreams();
+    void marshalShortcuts_data();
+    void marshalShortcuts();
+
+private:
+    QList<PortalIcon> m_icons;
+    /// m_icons after a trip over the session bus
+    QList<QDBusArgument> m_received;
+};
+
+void MarshallingBenchmark::initTestCase()
+{
+    SamplePayloads::registerDBusTypes();
+
+    m_icons = {
+        PortalIcon::fromThemedNames({u"utilities-terminal"_s, u"application-x-executable"_s}),
+        PortalIcon::fromBytes(SamplePayloads::pngIcon(64)),
+        PortalIcon::fromBytes(SamplePayloads::pngIcon(512)),
+    };
+    QList<QList<QVariant>> arguments;
+    for (const PortalIcon &icon : std::as_const(m_icons)) {
+        arguments.append({QVariant::fromValue(icon)});
+    }
+    const QList<QDBusMessage> samples = MicroBenchmark::roundTrip(arguments);
+    QVERIFY2(!samples.isEmpty(), "the icons need a session bus to round-trip over");
+    for (const QDBusMessage &sample : samples) {
+        m_received.append(sample.arguments().at(0).value<QDBusArgument>());
+    }
+}
+
+void MarshallingBenchmark::marshalIcon_data()
+{
+    QTest::addColumn<int>("icon");
+    QTest::newRow("themed") << 0;
+    QTest::newRow("bytes 64px") << 1;
+    QTest::newRow("bytes 512px") << 2;
+}
+
+void MarshallingBenchmark::marshalIcon()
+{
+    QFETCH(int, icon);
+    const PortalIcon &portalIcon = m_icons.at(icon);
+    if (const QByteArray bytes = portalIcon.data.variant().toByteArray(); !bytes.isEmpty()) {
+        qInfo("%.1f KiB PNG", bytes.size() / 1024.0);
+    }
+    MicroBenchmark::reportAllocations([&portalIcon] {
+        marshal(portalIcon);
+    });
+    QBENCHMARK {
+        marshal(portalIcon);
+    }
+}
+
+void MarshallingBenchmark::demarshalIcon_data()
+{
+    marshalIcon_data();
+}
+
+void MarshallingBenchmark::demarshalIcon()
+{
+    QFETCH(int, icon);
+    const QDBusArgument &received = m_received.at(icon);
+    QCOMPARE(demarshalIcon(received), demarshalIcon(received));
+    MicroBenchmark::reportAllocations([&received] {
+        demarshalIcon(received);
+    });
+    quint64 checksum = 0;
+    QBENCHMARK {
+        checksum += demarshalIcon(received);
+    }
+    QVERIFY(checksum > 0);
+}
+
+void MarshallingBenchmark::marshalStreams()
+{
+    const SamplePayloads::GenericStreams streams = SamplePayloads::streams(64);
+    MicroBenchmark::reportAllocations([&streams] {
+        marshal(streams);
+    });
+    QBENCHMARK {
+        marshal(streams);
+    }
+}
+
+void MarshallingBenchmark::marshalShortcuts_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("x100") << 100;
+    QTest::newRow("x10000") << 10000;
+}
+
+void MarshallingBenchmark::marshalShortcuts()
+{
+    QFETCH(int, count);
+    const SamplePayloads::GenericShortcuts shortcuts = SamplePayloads::shortcuts(count);
+    MicroBenchmark::reportAllocations([&shortcuts] {
+        marshal(shortcuts);
+    });
+    QBENCHMARK {
+        marshal(shortcuts);
+    }
+}
+
+QTEST_GUILESS_MAIN(MarshallingBenchmark)
+
+#include "marshallingbenchmark.moc"
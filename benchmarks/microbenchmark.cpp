@@ -0,0 +1,63 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "microbenchmark.h"
+
+#include <QDBusConnection>
+#include <QDebug>
+#include <QEventLoop>
+#include <QTimer>
+
+using namespace Qt::StringLiterals;
+
+namespace MicroBenchmark
+{
+void Collector::received(const QDBusMessage &message)
+{
+    messages.append(message);
+}
+
+QList<QDBusMessage> roundTrip(const QList<QList<QVariant>> &arguments)
+{
+    static const QString path = u"/org/kde/XdgPortalTest/MicroBenchmark"_s;
+    static const QString interface = u"org.kde.XdgPortalTest.MicroBenchmark"_s;
+    static const QString member = u"Sample"_s;
+
+    // Only messages read off a socket carry arguments in wire form, locally built ones hold plain QVariants
+    QDBusConnection sender = QDBusConnection::connectToBus(QDBusConnection::SessionBus, u"xdg-portal-test-kde-microbenchmark"_s);
+    if (!sender.isConnected()) {
+        qWarning() << "Couldn't connect to the session bus:" << sender.lastError().message();
+        return {};
+    }
+
+    Collector collector;
+    QDBusConnection::sessionBus().connect(sender.baseService(), path, interface, member, &collector, SLOT(received(QDBusMessage)));
+    for (const QList<QVariant> &sample : arguments) {
+        QDBusMessage message = QDBusMessage::createSignal(path, interface, member);
+        message.setArguments(sample);
+        sender.send(message);
+    }
+
+    // A bus delivers the messages of one sender in order
+    QEventLoop loop;
+    QTimer poll;
+    QObject::connect(&poll, &QTimer::timeout, &loop, [&collector, &loop, &arguments] {
+        if (collector.messages.size() == arguments.size()) {
+            loop.quit();
+        }
+    });
+    poll.start(10);
+    QTimer::singleShot(10000, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    QDBusConnection::sessionBus().disconnect(sender.baseService(), path, interface, member, &collector, SLOT(received(QDBusMessage)));
+    QDBusConnection::disconnectFromBus(sender.name());
+    if (collector.messages.size() != arguments.size()) {
+        qWarning() << "Only received" << collector.messages.size() << "of" << arguments.size() << "samples";
+        return {};
+    }
+    return collector.messages;
+}
+}
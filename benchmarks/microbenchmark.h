@@ -0,0 +1,44 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusMessage>
+#include <QList>
+#include <QObject>
+
+#include "allocationcounter.h"
+
+/// Shared pieces of the marshalling and decoder benchmarks
+namespace MicroBenchmark
+{
+/// Logs the heap allocations of one call of @p operation, after a warm-up call so reused buffers already have their capacity
+template<typename Operation>
+void reportAllocations(Operation operation)
+{
+    if (!AllocationCounter::available()) {
+        return;
+    }
+    operation();
+    const quint64 allocations = AllocationCounter::count();
+    operation();
+    qInfo("allocations/op: %llu", AllocationCounter::count() - allocations);
+}
+
+/// Sends @p arguments as signals from a private connection and returns what the session bus connection received, in wire form
+QList<QDBusMessage> roundTrip(const QList<QList<QVariant>> &arguments);
+
+/// Receiving end of roundTrip(), QDBusConnection::connect needs a slot
+class Collector : public QObject
+{
+    Q_OBJECT
+
+public:
+    QList<QDBusMessage> messages;
+
+public Q_SLOTS:
+    void received(const QDBusMessage &message);
+};
+}
@@ -0,0 +1,136 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "samplepayloads.h"
+
+#include <QBuffer>
+#include <QDBusArgument>
+#include <QDBusMetaType>
+#include <QImage>
+#include <QPainter>
+#include <QRadialGradient>
+
+#include "portalicon.h"
+
+using namespace Qt::StringLiterals;
+
+namespace SamplePayloads
+{
+namespace
+{
+QVariant intPair(int first, int second)
+{
+    QDBusArgument argument;
+    argument.beginStructure();
+    argument << first << second;
+    argument.endStructure();
+    return QVariant::fromValue(argument);
+}
+
+/// Keys no decoder knows about, backends are free to add those
+void addUnknownKeys(QVariantMap &map, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        map.insert(u"x-unknown-%1"_s.arg(i), u"value %1"_s.arg(i));
+    }
+}
+}
+
+void registerDBusTypes()
+{
+    qDBusRegisterMetaType<GenericStreams>();
+    qDBusRegisterMetaType<QPair<uint, QVariantMap>>();
+    qDBusRegisterMetaType<GenericShortcuts>();
+    qDBusRegisterMetaType<QPair<QString, QVariantMap>>();
+    PortalIcon::registerDBusType();
+}
+
+GenericStreams streams(int count)
+{
+    GenericStreams streams;
+    for (int i = 0; i < count; ++i) {
+        QVariantMap properties{{u"id"_s, u"stream%1"_s.arg(i)},
+                               {u"position"_s, intPair(1920 * (i % 8), 1080 * (i / 8))},
+                               {u"size"_s, intPair(1920, 1080)},
+                               {u"source_type"_s, 1U},
+                               {u"mapping_id"_s, u"output%1"_s.arg(i)}};
+        addUnknownKeys(properties, 3);
+        streams.append({uint(40 + i), properties});
+    }
+    return streams;
+}
+
+GenericShortcuts shortcuts(int count)
+{
+    GenericShortcuts shortcuts;
+    shortcuts.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QVariantMap properties{{u"description"_s, u"Shortcut %1"_s.arg(i)}, {u"trigger_description"_s, u"Meta+Shift+%1"_s.arg(i)}};
+        addUnknownKeys(properties, 1);
+        shortcuts.append({u"shortcut%1"_s.arg(i), properties});
+    }
+    return shortcuts;
+}
+
+QVariantMap location()
+{
+    QDBusArgument timestamp;
+    timestamp.beginStructure();
+    timestamp << quint64(1760000000) << quint64(123456);
+    timestamp.endStructure();
+
+    QVariantMap location{{u"Latitude"_s, 48.1371},
+                         {u"Longitude"_s, 11.5754},
+                         {u"Altitude"_s, 519.0},
+                         {u"Accuracy"_s, 25.0},
+                         {u"Speed"_s, 1.5},
+                         {u"Heading"_s, 270.0},
+                         {u"Description"_s, u"Marienplatz"_s},
+                         {u"Timestamp"_s, QVariant::fromValue(timestamp)}};
+    addUnknownKeys(location, 2);
+    return location;
+}
+
+QVariantMap printResults()
+{
+    QVariantMap settings{{u"n-copies"_s, u"2"_s}, {u"page-ranges"_s, u"1-3"_s}};
+    // A real GTK dialog sends a couple dozen settings, most of which this application ignores
+    addUnknownKeys(settings, 20);
+    QVariantMap pageSetup{{u"Orientation"_s, u"landscape"_s},
+                          {u"MarginTop"_s, 10.0},
+                          {u"MarginBottom"_s, 10.0},
+                          {u"MarginLeft"_s, 15.0},
+                          {u"MarginRight"_s, 15.0},
+                          {u"Width"_s, 210.0},
+                          {u"Height"_s, 297.0},
+                          {u"PPDName"_s, u"A4"_s}};
+    return {{u"settings"_s, settings}, {u"page-setup"_s, pageSetup}, {u"token"_s, 7U}};
+}
+
+QByteArray pngIcon(int size)
+{
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    QRadialGradient gradient(size / 3.0, size / 3.0, size);
+    gradient.setColorAt(0, QColor(61, 174, 233));
+    gradient.setColorAt(1, QColor(35, 38, 41));
+    painter.setBrush(gradient);
+    painter.setPen(Qt::NoPen);
+    painter.drawRoundedRect(image.rect().adjusted(size / 16, size / 16, -size / 16, -size / 16), size / 8.0, size / 8.0);
+    painter.setPen(QPen(Qt::white, qMax(1, size / 64)));
+    for (int i = 1; i < 8; ++i) {
+        painter.drawLine(size / 4, i * size / 8, 3 * size / 4, size - i * size / 8);
+    }
+    painter.end();
+
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return bytes;
+}
+}
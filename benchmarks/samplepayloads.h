@@ -0,0 +1,30 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QVariantMap>
+
+/// Deterministic portal payloads for the benchmarks, shaped like what the backends send
+namespace SamplePayloads
+{
+/// a(ua{sv}) the way QtDBus demarshals it without a custom type
+using GenericStreams = QList<QPair<uint, QVariantMap>>;
+/// a(sa{sv}), the same as the Shortcuts of the GlobalShortcuts tab
+using GenericShortcuts = QList<QPair<QString, QVariantMap>>;
+
+void registerDBusTypes();
+
+GenericStreams streams(int count);
+GenericShortcuts shortcuts(int count);
+QVariantMap location();
+/// The a{sv} of a PreparePrint Response
+QVariantMap printResults();
+/// PNG of a @p size x @p size image with enough detail to not compress to nothing
+QByteArray pngIcon(int size);
+}
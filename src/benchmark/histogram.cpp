@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "histogram.h"
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+Histogram::Histogram()
+    : m_buckets(bucketCount, 0)
+{
+}
+
+void Histogram::add(qint64 nsecs)
+{
+    ++m_count;
+    // Clock offsets between processes can make cross-process deltas slightly negative
+    if (nsecs < 0) {
+        ++m_negative;
+        return;
+    }
+
+    int bucket = 0;
+    for (qint64 limit = firstBucketNsecs; nsecs >= limit && bucket < bucketCount - 1; limit *= 2) {
+        ++bucket;
+    }
+    ++m_buckets[bucket];
+}
+
+void Histogram::clear()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_negative = 0;
+}
+
+qint64 Histogram::count() const
+{
+    return m_count;
+}
+
+QString Histogram::render(int width) const
+{
+    const qint64 peak = std::max(*std::max_element(m_buckets.cbegin(), m_buckets.cend()), m_negative);
+    if (peak == 0) {
+        return u"(no samples)"_s;
+    }
+
+    const auto line = [peak, width](const QString &label, qint64 value) {
+        return u"%1 |%2 %3\n"_s.arg(label, 12).arg(QString(int(value * width / peak), u'#'), -width).arg(value);
+    };
+
+    QString text;
+    if (m_negative > 0) {
+        text += line(u"< 0 ms"_s, m_negative);
+    }
+    qint64 lower = 0;
+    for (int bucket = 0; bucket < bucketCount; ++bucket) {
+        const qint64 upper = firstBucketNsecs << bucket;
+        if (m_buckets.at(bucket) > 0) {
+            const QString label = bucket == bucketCount - 1 ? u">= %1 ms"_s.arg(lower / 1e6) : u"< %1 ms"_s.arg(upper / 1e6);
+            text += line(label, m_buckets.at(bucket));
+        }
+        lower = upper;
+    }
+    return text;
+}
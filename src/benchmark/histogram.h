@@ -0,0 +1,31 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QList>
+#include <QString>
+
+/// Latency histogram with power of two buckets, starting at 100 µs
+class Histogram
+{
+public:
+    Histogram();
+
+    void add(qint64 nsecs);
+    void clear();
+    qint64 count() const;
+
+    /// Text rendering with one bar per non-empty bucket, meant for a monospace label
+    QString render(int width = 40) const;
+
+private:
+    static constexpr int bucketCount = 16;
+    static constexpr qint64 firstBucketNsecs = 100000;
+
+    QList<qint64> m_buckets;
+    qint64 m_count = 0;
+    qint64 m_negative = 0;
+};
@@ -0,0 +1,87 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "latencystats.h"
+
+#include <algorithm>
+#include <cmath>
+
+void LatencyStats::add(qint64 nsecs)
+{
+    m_samples.append(nsecs);
+    m_total += nsecs;
+    m_sorted = m_samples.size() < 2 || (m_sorted && m_samples.at(m_samples.size() - 2) <= nsecs);
+}
+
+void LatencyStats::clear()
+{
+    m_samples.clear();
+    m_sorted = true;
+    m_total = 0;
+}
+
+qsizetype LatencyStats::count() const
+{
+    return m_samples.size();
+}
+
+qint64 LatencyStats::min() const
+{
+    if (m_samples.isEmpty()) {
+        return 0;
+    }
+    sort();
+    return m_samples.constFirst();
+}
+
+qint64 LatencyStats::max() const
+{
+    if (m_samples.isEmpty()) {
+        return 0;
+    }
+    sort();
+    return m_samples.constLast();
+}
+
+qint64 LatencyStats::mean() const
+{
+    if (m_samples.isEmpty()) {
+        return 0;
+    }
+    return m_total / m_samples.size();
+}
+
+qint64 LatencyStats::percentile(double fraction) const
+{
+    if (m_samples.isEmpty()) {
+        return 0;
+    }
+    sort();
+    const auto index = qBound<qsizetype>(0, qsizetype(std::ceil(fraction * m_samples.size())) - 1, m_samples.size() - 1);
+    return m_samples.at(index);
+}
+
+QString LatencyStats::summary() const
+{
+    if (m_samples.isEmpty()) {
+        return QStringLiteral("n=0");
+    }
+    return QStringLiteral("n=%1 min=%2 p50=%3 p99=%4 max=%5 mean=%6 ms")
+        .arg(count())
+        .arg(formatMsecs(min()), formatMsecs(percentile(0.5)), formatMsecs(percentile(0.99)), formatMsecs(max()), formatMsecs(mean()));
+}
+
+QString LatencyStats::formatMsecs(qint64 nsecs)
+{
+    return QString::number(nsecs / 1000000.0, 'f', 3);
+}
+
+void LatencyStats::sort() const
+{
+    if (!m_sorted) {
+        std::sort(m_samples.begin(), m_samples.end());
+        m_sorted = true;
+    }
+}
@@ -0,0 +1,36 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QList>
+#include <QString>
+
+/// Collects latency samples (in nanoseconds) and summarizes them
+class LatencyStats
+{
+public:
+    void add(qint64 nsecs);
+    void clear();
+
+    qsizetype count() const;
+    qint64 min() const;
+    qint64 max() const;
+    qint64 mean() const;
+    /// @p fraction in [0, 1], e.g. 0.99 for the 99th percentile
+    qint64 percentile(double fraction) const;
+
+    /// One line summary in milliseconds, e.g. "n=10 min=0.1 p50=0.2 p99=0.9 max=1.0 ms"
+    QString summary() const;
+
+    static QString formatMsecs(qint64 nsecs);
+
+private:
+    void sort() const;
+
+    mutable QList<qint64> m_samples;
+    mutable bool m_sorted = true;
+    qint64 m_total = 0;
+};
@@ -0,0 +1,111 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "processinfo.h"
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDir>
+#include <QFile>
+
+#include <unistd.h>
+
+using namespace Qt::StringLiterals;
+
+namespace ProcessInfo
+{
+qint64 servicePid(const QString &service, const QDBusConnection &bus)
+{
+    if (!bus.isConnected()) {
+        return 0;
+    }
+    auto reply = bus.interface()->servicePid(service);
+    if (!reply.isValid()) {
+        return 0;
+    }
+    return reply.value();
+}
+
+QString portalBackendService()
+{
+    const QStringList services = QDBusConnection::sessionBus().interface()->registeredServiceNames().value();
+    for (const QString &service : services) {
+        if (service.startsWith("org.freedesktop.impl.portal.desktop."_L1)) {
+            return service;
+        }
+    }
+    return {};
+}
+
+qint64 residentKiB(qint64 pid)
+{
+    if (pid <= 0) {
+        return -1;
+    }
+
+    QFile status(u"/proc/%1/status"_s.arg(pid));
+    if (!status.open(QFile::ReadOnly)) {
+        return -1;
+    }
+
+    // procfs files report a size of 0, so read line by line instead of relying on atEnd()
+    for (QByteArray line = status.readLine(); !line.isEmpty(); line = status.readLine()) {
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+        }
+    }
+    return -1;
+}
+
+qint64 contextSwitches(qint64 pid)
+{
+    if (pid <= 0) {
+        return -1;
+    }
+
+    // /proc/<pid>/status only counts the main thread, the D-Bus worker threads wake up most
+    const QDir tasks(u"/proc/%1/task"_s.arg(pid));
+    const QStringList threads = tasks.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    if (threads.isEmpty()) {
+        return -1;
+    }
+
+    qint64 switches = 0;
+    for (const QString &thread : threads) {
+        QFile status(tasks.filePath(thread + u"/status"_s));
+        if (!status.open(QFile::ReadOnly)) {
+            // Exited since the listing
+            continue;
+        }
+        for (QByteArray line = status.readLine(); !line.isEmpty(); line = status.readLine()) {
+            if (line.startsWith("voluntary_ctxt_switches:") || line.startsWith("nonvoluntary_ctxt_switches:")) {
+                switches += line.mid(line.indexOf(':') + 1).trimmed().toLongLong();
+            }
+        }
+    }
+    return switches;
+}
+
+qint64 cpuNsecs(qint64 pid)
+{
+    if (pid <= 0) {
+        return -1;
+    }
+
+    QFile stat(u"/proc/%1/stat"_s.arg(pid));
+    if (!stat.open(QFile::ReadOnly)) {
+        return -1;
+    }
+
+    // The command name may contain spaces and parentheses, the fields after it are fixed: utime and stime are the 12th and 13th
+    const QByteArray line = stat.readLine();
+    const QList<QByteArray> fields = line.mid(line.lastIndexOf(')') + 2).split(' ');
+    if (fields.size() < 13) {
+        return -1;
+    }
+    const qint64 ticks = fields.at(11).toLongLong() + fields.at(12).toLongLong();
+    return ticks * 1000000000 / sysconf(_SC_CLK_TCK);
+}
+}
@@ -0,0 +1,27 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusConnection>
+#include <QString>
+
+namespace ProcessInfo
+{
+/// Pid of the owner of a bus name, or 0 if unknown
+qint64 servicePid(const QString &service, const QDBusConnection &bus = QDBusConnection::sessionBus());
+
+/// Well-known name of the first running org.freedesktop.impl.portal.desktop.* backend
+QString portalBackendService();
+
+/// VmRSS of @p pid in KiB, or -1 if it can't be read (e.g. from inside the sandbox)
+qint64 residentKiB(qint64 pid);
+
+/// Voluntary plus involuntary context switches of all live threads of @p pid so far, roughly its wakeups; -1 if unknown
+qint64 contextSwitches(qint64 pid);
+
+/// User plus system CPU time @p pid has used so far, in nanoseconds; -1 if unknown
+qint64 cpuNsecs(qint64 pid);
+}
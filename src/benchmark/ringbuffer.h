@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QList>
+
+/// Fixed capacity FIFO that overwrites the oldest entry; slots are reused, so filling one in place doesn't allocate
+template<typename T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(qsizetype capacity)
+        : m_items(qMax<qsizetype>(1, capacity))
+    {
+    }
+
+    /// The slot for a new newest entry, evicting the oldest one when full; it still holds whatever was there before
+    T &next()
+    {
+        T &slot = m_items[m_head];
+        m_head = (m_head + 1) % m_items.size();
+        m_size = qMin(m_size + 1, m_items.size());
+        return slot;
+    }
+
+    void append(const T &item)
+    {
+        next() = item;
+    }
+
+    /// Drops the newest entry, e.g. after next() turned out to be unusable
+    void removeLast()
+    {
+        if (m_size == 0) {
+            return;
+        }
+        m_head = (m_head + m_items.size() - 1) % m_items.size();
+        --m_size;
+    }
+
+    void clear()
+    {
+        m_head = 0;
+        m_size = 0;
+    }
+
+    qsizetype size() const
+    {
+        return m_size;
+    }
+
+    qsizetype capacity() const
+    {
+        return m_items.size();
+    }
+
+    bool isEmpty() const
+    {
+        return m_size == 0;
+    }
+
+    /// @p index 0 is the oldest entry
+    const T &at(qsizetype index) const
+    {
+        return m_items.at((m_head - m_size + index + m_items.size()) % m_items.size());
+    }
+
+    const T &last() const
+    {
+        return at(m_size - 1);
+    }
+
+private:
+    QList<T> m_items;
+    qsizetype m_head = 0;
+    qsizetype m_size = 0;
+};
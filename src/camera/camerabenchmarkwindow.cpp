@@ -0,0 +1,460 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "camerabenchmarkwindow.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include <gst/gst.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "portalcommon.h"
+#include "powerprofile/powerprofilewatcher.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+enum Column {
+    AccessColumn,
+    RemoteColumn,
+    FirstFrameColumn,
+    FramesColumn,
+    RateColumn,
+    IntervalColumn,
+    IntervalTailColumn,
+    IntervalMaxColumn,
+    JitterColumn,
+    ResultColumn,
+    ColumnCount,
+};
+
+// AccessCamera asks for permission the first time
+constexpr int accessTimeout = 120000;
+constexpr int firstFrameTimeout = 10000;
+// PipeWire needs a moment to release the camera before the next run opens it again
+constexpr int runPause = 500;
+
+const char standInDescription[] =
+    "videotestsrc is-live=true pattern=ball ! video/x-raw,width=1280,height=720,framerate=30/1 ! "
+    "pipewiresink mode=provide client-name=xdg-portal-test-camera stream-properties=\"props,media.class=Video/Source,media.role=Camera\"";
+
+QString msecs(qint64 nsecs)
+{
+    return nsecs < 0 ? QString() : LatencyStats::formatMsecs(nsecs);
+}
+}
+
+CameraBenchmarkWindow::CameraBenchmarkWindow(QWidget *parent)
+    : QWidget(parent)
+{
+    auto description = new QLabel(i18n("Requests the camera through AccessCamera, opens its PipeWire remote and plays it into a headless sink "
+                                       "for the given time. Without a camera, start the stand-in: a 30 fps videotestsrc published as a "
+                                       "camera source."));
+    description->setWordWrap(true);
+
+    m_standInButton = new QPushButton(i18n("Start virtual camera"));
+    connect(m_standInButton, &QPushButton::clicked, this, &CameraBenchmarkWindow::toggleStandIn);
+
+    m_node = new QLineEdit;
+    m_node->setPlaceholderText(i18n("Any camera"));
+
+    m_duration = new QSpinBox;
+    m_duration->setRange(1, 600);
+    m_duration->setValue(10);
+    m_duration->setSuffix(i18n(" s"));
+
+    m_repetitions = new QSpinBox;
+    m_repetitions->setRange(1, 100);
+    m_repetitions->setValue(3);
+
+    m_startButton = new QPushButton(i18n("Run"));
+    connect(m_startButton, &QPushButton::clicked, this, [this] {
+        if (m_running) {
+            stop();
+        } else {
+            start();
+        }
+    });
+
+    auto form = new QFormLayout;
+    form->addRow(QString(), m_standInButton);
+    form->addRow(i18n("PipeWire node:"), m_node);
+    form->addRow(i18n("Streaming time:"), m_duration);
+    form->addRow(i18n("Repetitions:"), m_repetitions);
+    form->addRow(QString(), m_startButton);
+
+    m_status = new QLabel;
+    m_status->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_status->setWordWrap(true);
+
+    m_table = new QTableWidget(0, ColumnCount);
+    m_table->setHorizontalHeaderLabels({i18n("AccessCamera (ms)"),
+                                        i18n("OpenPipeWireRemote (ms)"),
+                                        i18n("First frame (ms)"),
+                                        i18n("Frames"),
+                                        i18n("FPS"),
+                                        i18n("Interval p50 (ms)"),
+                                        i18n("Interval p99 (ms)"),
+                                        i18n("Interval max (ms)"),
+                                        i18n("Jitter σ (ms)"),
+                                        i18n("Result")});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_status);
+    layout->addWidget(m_table, 1);
+
+    m_collectTimer.setInterval(200);
+    connect(&m_collectTimer, &QTimer::timeout, this, &CameraBenchmarkWindow::collectFrames);
+    m_stopTimer.setSingleShot(true);
+    connect(&m_stopTimer, &QTimer::timeout, this, [this] {
+        finishRun();
+    });
+    m_timeout.setSingleShot(true);
+    connect(&m_timeout, &QTimer::timeout, this, [this] {
+        if (!m_requestPath.isEmpty()) {
+            QDBusConnection::sessionBus().asyncCall(
+                QDBusMessage::createMethodCall(desktopPortalService(), m_requestPath, portalRequestInterface(), u"Close"_s));
+            finishRun(i18n("No response to AccessCamera"));
+        } else {
+            finishRun(i18n("No frame"));
+        }
+    });
+}
+
+CameraBenchmarkWindow::~CameraBenchmarkWindow()
+{
+    stop();
+    if (m_standIn) {
+        gst_element_set_state(m_standIn, GST_STATE_NULL);
+        gst_object_unref(m_standIn);
+    }
+}
+
+void CameraBenchmarkWindow::toggleStandIn()
+{
+    if (m_standIn) {
+        gst_element_set_state(m_standIn, GST_STATE_NULL);
+        gst_object_unref(m_standIn);
+        m_standIn = nullptr;
+        m_standInButton->setText(i18n("Start virtual camera"));
+        return;
+    }
+
+    GError *error = nullptr;
+    m_standIn = gst_parse_launch(standInDescription, &error);
+    if (error) {
+        m_status->setText(i18n("Couldn't create the virtual camera: %1", QString::fromUtf8(error->message)));
+        g_error_free(error);
+        if (m_standIn) {
+            gst_object_unref(m_standIn);
+            m_standIn = nullptr;
+        }
+        return;
+    }
+    gst_element_set_state(m_standIn, GST_STATE_PLAYING);
+    m_standInButton->setText(i18n("Stop virtual camera"));
+}
+
+void CameraBenchmarkWindow::start()
+{
+    m_runs.clear();
+    m_table->setRowCount(0);
+    m_running = true;
+    m_startButton->setText(i18n("Stop"));
+    m_clock.start();
+    runNext();
+}
+
+void CameraBenchmarkWindow::stop()
+{
+    teardown();
+    m_running = false;
+    m_startButton->setText(i18n("Run"));
+}
+
+void CameraBenchmarkWindow::runNext()
+{
+    if (!m_running) {
+        return;
+    }
+    if (m_runs.size() >= m_repetitions->value()) {
+        finish();
+        return;
+    }
+    m_runs.append(Run());
+    m_table->insertRow(m_runs.size() - 1);
+    m_status->setText(i18n("Run %1 of %2: waiting for AccessCamera", m_runs.size(), m_repetitions->value()));
+
+    const QString token = nextRequestToken();
+    m_requestPath = portalRequestPath(token);
+    QDBusConnection::sessionBus().connect(desktopPortalService(),
+                                          m_requestPath,
+                                          portalRequestInterface(),
+                                          portalRequestResponse(),
+                                          this,
+                                          SLOT(accessResponse(uint,QVariantMap)));
+
+    QDBusMessage message =
+        QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), u"org.freedesktop.portal.Camera"_s, u"AccessCamera"_s);
+    message << QVariantMap{{u"handle_token"_s, token}};
+    m_requestStart = m_clock.nsecsElapsed();
+    const QString requestPath = m_requestPath;
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, requestPath](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (requestPath != m_requestPath || !watcher->isError()) {
+            return;
+        }
+        qWarning() << "AccessCamera failed:" << watcher->error().message();
+        finishRun(watcher->error().message());
+    });
+    m_timeout.start(accessTimeout);
+}
+
+void CameraBenchmarkWindow::accessResponse(uint response, const QVariantMap &results)
+{
+    Q_UNUSED(results)
+    QDBusConnection::sessionBus().disconnect(desktopPortalService(),
+                                             m_requestPath,
+                                             portalRequestInterface(),
+                                             portalRequestResponse(),
+                                             this,
+                                             SLOT(accessResponse(uint,QVariantMap)));
+    m_requestPath.clear();
+    m_timeout.stop();
+    if (response != 0) {
+        finishRun(i18n("Access denied (%1)", response));
+        return;
+    }
+    m_runs.last().accessNsecs = m_clock.nsecsElapsed() - m_requestStart;
+    openRemote();
+}
+
+void CameraBenchmarkWindow::openRemote()
+{
+    QDBusMessage message =
+        QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), u"org.freedesktop.portal.Camera"_s, u"OpenPipeWireRemote"_s);
+    message << QVariantMap();
+    const qint64 requested = m_clock.nsecsElapsed();
+    const int run = m_runs.size();
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, requested, run](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (!m_running || run != m_runs.size()) {
+            return;
+        }
+        QDBusPendingReply<QDBusUnixFileDescriptor> reply = *watcher;
+        if (reply.isError()) {
+            qWarning() << "OpenPipeWireRemote failed:" << reply.error().message();
+            finishRun(reply.error().message());
+            return;
+        }
+        m_runs.last().remoteNsecs = m_clock.nsecsElapsed() - requested;
+        m_remote = reply.value();
+        startPipeline();
+    });
+}
+
+void CameraBenchmarkWindow::startPipeline()
+{
+    // fakesink instead of a video sink, nothing but the stream itself gets timed
+    QString launch = u"pipewiresrc fd=%1 do-timestamp=true"_s.arg(m_remote.fileDescriptor());
+    if (!m_node->text().trimmed().isEmpty()) {
+        launch += u" path=%1"_s.arg(m_node->text().trimmed());
+    }
+    launch += u" ! fakesink name=sink signal-handoffs=true sync=false"_s;
+
+    GError *error = nullptr;
+    m_pipeline = gst_parse_launch(launch.toUtf8().constData(), &error);
+    if (error) {
+        const QString message = QString::fromUtf8(error->message);
+        g_error_free(error);
+        finishRun(message);
+        return;
+    }
+    GstElement *sink = gst_bin_get_by_name(GST_BIN(m_pipeline), "sink");
+    g_signal_connect(sink, "handoff", G_CALLBACK(&CameraBenchmarkWindow::handoff), this);
+    gst_object_unref(sink);
+
+    m_status->setText(i18n("Run %1 of %2: streaming", m_runs.size(), m_repetitions->value()));
+    m_lastFrame = -1;
+    m_pipelineStart = m_clock.nsecsElapsed();
+    if (gst_element_set_state(m_pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        finishRun(i18n("Couldn't start the pipeline"));
+        return;
+    }
+    m_collectTimer.start();
+    m_timeout.start(firstFrameTimeout);
+}
+
+void CameraBenchmarkWindow::handoff(GstElement *sink, GstBuffer *buffer, GstPad *pad, CameraBenchmarkWindow *window)
+{
+    Q_UNUSED(sink)
+    Q_UNUSED(buffer)
+    Q_UNUSED(pad)
+    const qint64 now = window->m_clock.nsecsElapsed();
+    QMutexLocker locker(&window->m_framesMutex);
+    window->m_frames.append(now);
+}
+
+void CameraBenchmarkWindow::collectFrames()
+{
+    if (!m_pipeline) {
+        return;
+    }
+    GstBus *bus = gst_element_get_bus(m_pipeline);
+    GstMessage *message = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+    gst_object_unref(bus);
+    if (message) {
+        GError *error = nullptr;
+        gst_message_parse_error(message, &error, nullptr);
+        const QString text = QString::fromUtf8(error->message);
+        g_error_free(error);
+        gst_message_unref(message);
+        finishRun(text);
+        return;
+    }
+
+    drainFrames();
+    updateRow(m_runs.size() - 1);
+}
+
+void CameraBenchmarkWindow::drainFrames()
+{
+    QList<qint64> frames;
+    {
+        QMutexLocker locker(&m_framesMutex);
+        frames.swap(m_frames);
+    }
+    if (frames.isEmpty() || m_runs.isEmpty()) {
+        return;
+    }
+
+    Run &run = m_runs.last();
+    for (const qint64 frame : std::as_const(frames)) {
+        if (m_lastFrame < 0) {
+            run.firstFrameNsecs = frame - m_pipelineStart;
+            if (m_pipeline) {
+                m_timeout.stop();
+                m_stopTimer.start(m_duration->value() * 1000);
+            }
+        } else {
+            const qint64 interval = frame - m_lastFrame;
+            run.intervals.add(interval);
+            const double ms = double(interval) / 1e6;
+            run.intervalSum += ms;
+            run.intervalSquares += ms * ms;
+        }
+        ++run.frames;
+        m_lastFrame = frame;
+    }
+    run.streamingNsecs = m_lastFrame - m_pipelineStart - run.firstFrameNsecs;
+}
+
+void CameraBenchmarkWindow::teardown()
+{
+    if (!m_requestPath.isEmpty()) {
+        QDBusConnection::sessionBus().disconnect(desktopPortalService(),
+                                                 m_requestPath,
+                                                 portalRequestInterface(),
+                                                 portalRequestResponse(),
+                                                 this,
+                                                 SLOT(accessResponse(uint,QVariantMap)));
+        m_requestPath.clear();
+    }
+    m_collectTimer.stop();
+    m_stopTimer.stop();
+    m_timeout.stop();
+    if (m_pipeline) {
+        gst_element_set_state(m_pipeline, GST_STATE_NULL);
+        gst_object_unref(m_pipeline);
+        m_pipeline = nullptr;
+    }
+    m_remote = QDBusUnixFileDescriptor();
+}
+
+void CameraBenchmarkWindow::finishRun(const QString &error)
+{
+    teardown();
+    if (!m_running) {
+        return;
+    }
+    // The streaming thread has stopped, what it left behind still counts
+    drainFrames();
+    m_runs.last().error = error;
+    updateRow(m_runs.size() - 1);
+    QTimer::singleShot(runPause, this, &CameraBenchmarkWindow::runNext);
+}
+
+void CameraBenchmarkWindow::finish()
+{
+    stop();
+
+    LatencyStats access;
+    LatencyStats firstFrame;
+    QList<double> rates;
+    for (const Run &run : std::as_const(m_runs)) {
+        if (run.accessNsecs >= 0) {
+            access.add(run.accessNsecs);
+        }
+        if (run.firstFrameNsecs >= 0) {
+            firstFrame.add(run.firstFrameNsecs);
+        }
+        if (run.streamingNsecs > 0) {
+            rates.append(double(run.intervals.count()) * 1e9 / double(run.streamingNsecs));
+        }
+    }
+    std::sort(rates.begin(), rates.end());
+    m_status->setText(i18n("%1 runs in %2 mode: AccessCamera p50 %3 ms, first frame p50 %4 ms, median %5 fps",
+                           m_runs.size(),
+                           PowerProfileWatcher::instance().modeName(),
+                           access.count() > 0 ? LatencyStats::formatMsecs(access.percentile(0.5)) : i18n("n/a"),
+                           firstFrame.count() > 0 ? LatencyStats::formatMsecs(firstFrame.percentile(0.5)) : i18n("n/a"),
+                           rates.isEmpty() ? i18n("n/a") : QString::number(rates.at(rates.size() / 2), 'f', 1)));
+}
+
+void CameraBenchmarkWindow::updateRow(int row)
+{
+    const Run &run = m_runs.at(row);
+    const auto set = [this, row](int column, const QString &text) {
+        m_table->setItem(row, column, new QTableWidgetItem(text));
+    };
+    const qsizetype intervals = run.intervals.count();
+
+    set(AccessColumn, msecs(run.accessNsecs));
+    set(RemoteColumn, msecs(run.remoteNsecs));
+    set(FirstFrameColumn, msecs(run.firstFrameNsecs));
+    set(FramesColumn, QString::number(run.frames));
+    set(RateColumn, run.streamingNsecs > 0 ? QString::number(double(intervals) * 1e9 / double(run.streamingNsecs), 'f', 1) : QString());
+    set(IntervalColumn, intervals > 0 ? msecs(run.intervals.percentile(0.5)) : QString());
+    set(IntervalTailColumn, intervals > 0 ? msecs(run.intervals.percentile(0.99)) : QString());
+    set(IntervalMaxColumn, intervals > 0 ? msecs(run.intervals.max()) : QString());
+    if (intervals > 1) {
+        const double mean = run.intervalSum / double(intervals);
+        const double variance = qMax(0.0, run.intervalSquares / double(intervals) - mean * mean);
+        set(JitterColumn, QString::number(std::sqrt(variance), 'f', 2));
+    }
+    set(ResultColumn, run.error.isEmpty() ? (m_pipeline ? i18n("streaming") : i18n("done")) : run.error);
+}
@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusUnixFileDescriptor>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QTimer>
+#include <QWidget>
+
+#include "benchmark/latencystats.h"
+
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+
+typedef struct _GstBuffer GstBuffer;
+typedef struct _GstElement GstElement;
+typedef struct _GstPad GstPad;
+
+/**
+ * Goes through org.freedesktop.portal.Camera the way a video call would: AccessCamera, then
+ * OpenPipeWireRemote, and plays the remote into a headless fakesink for a fixed time.
+ *
+ * Every run reports the access and remote latency, the time from starting the pipeline to
+ * its first frame, and the frame rate with the spread of the frame intervals. The frames
+ * are timed in fakesink's handoff, on the streaming thread, so the GUI doesn't add jitter.
+ *
+ * A videotestsrc published through pipewiresink as a Camera role source can stand in for
+ * a real camera.
+ */
+class CameraBenchmarkWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit CameraBenchmarkWindow(QWidget *parent = nullptr);
+    ~CameraBenchmarkWindow() override;
+
+public Q_SLOTS:
+    void start();
+    void stop();
+
+private Q_SLOTS:
+    void accessResponse(uint response, const QVariantMap &results);
+
+private:
+    struct Run {
+        qint64 accessNsecs = -1;
+        qint64 remoteNsecs = -1;
+        qint64 firstFrameNsecs = -1;
+        qint64 frames = 0;
+        qint64 streamingNsecs = 0;
+        LatencyStats intervals;
+        /// For the standard deviation of the intervals, in ms
+        double intervalSum = 0;
+        double intervalSquares = 0;
+        QString error;
+    };
+
+    static void handoff(GstElement *sink, GstBuffer *buffer, GstPad *pad, CameraBenchmarkWindow *window);
+
+    void toggleStandIn();
+    void runNext();
+    void openRemote();
+    void startPipeline();
+    void collectFrames();
+    void drainFrames();
+    void teardown();
+    void finishRun(const QString &error = QString());
+    void finish();
+    void updateRow(int row);
+
+    QLineEdit *m_node;
+    QSpinBox *m_duration;
+    QSpinBox *m_repetitions;
+    QPushButton *m_standInButton;
+    QPushButton *m_startButton;
+    QLabel *m_status;
+    QTableWidget *m_table;
+
+    GstElement *m_standIn = nullptr;
+    GstElement *m_pipeline = nullptr;
+    QDBusUnixFileDescriptor m_remote;
+
+    QList<Run> m_runs;
+    bool m_running = false;
+    QString m_requestPath;
+    QElapsedTimer m_clock;
+    qint64 m_requestStart = 0;
+    qint64 m_pipelineStart = 0;
+    qint64 m_lastFrame = -1;
+    QTimer m_collectTimer;
+    QTimer m_stopTimer;
+    QTimer m_timeout;
+
+    /// Written from the streaming thread, drained by collectFrames()
+    QMutex m_framesMutex;
+    QList<qint64> m_frames;
+};
@@ -0,0 +1,197 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "dragsource.h"
+
+#include <QApplication>
+#include <QCheckBox>
+#include <QDrag>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFormLayout>
+#include <QLabel>
+#include <QMimeData>
+#include <QMouseEvent>
+#include <QSpinBox>
+#include <QTemporaryDir>
+#include <QUrl>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include <chrono>
+
+#include "benchmark/latencystats.h"
+
+using namespace Qt::StringLiterals;
+
+DragSource::DragSource(QWidget *parent)
+    : QWidget(parent)
+{
+    m_formats = new QSpinBox;
+    m_formats->setRange(0, 256);
+    m_formats->setValue(4);
+
+    m_kibPerFormat = new QSpinBox;
+    m_kibPerFormat->setRange(0, 1024 * 1024);
+    m_kibPerFormat->setValue(1024);
+    m_kibPerFormat->setSuffix(i18n(" KiB"));
+
+    m_uris = new QSpinBox;
+    m_uris->setRange(0, 100000);
+    m_uris->setValue(0);
+
+    m_useFileTransfer = new QCheckBox(i18n("Hand the files over through the FileTransfer portal"));
+    // That's the path sandboxed applications take
+    m_useFileTransfer->setChecked(QFile::exists(u"/.flatpak-info"_s));
+
+    m_handle = new QLabel(i18n("Drag from here, into another instance to go through the compositor"));
+    m_handle->setFrameStyle(QFrame::Raised | QFrame::StyledPanel);
+    m_handle->setAlignment(Qt::AlignCenter);
+    m_handle->setMinimumHeight(48);
+    m_handle->setCursor(Qt::OpenHandCursor);
+    m_handle->installEventFilter(this);
+
+    m_report = new QLabel;
+    m_report->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Formats:"), m_formats);
+    form->addRow(i18n("Size per format:"), m_kibPerFormat);
+    form->addRow(i18n("Files in URI list:"), m_uris);
+    form->addRow(QString(), m_useFileTransfer);
+
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins({});
+    layout->addLayout(form);
+    layout->addWidget(m_handle);
+    layout->addWidget(m_report);
+}
+
+DragSource::~DragSource() = default;
+
+QString DragSource::markerFormat()
+{
+    return u"application/x-xdg-portal-test-drag"_s;
+}
+
+qint64 DragSource::monotonicNsecs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool DragSource::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched != m_handle) {
+        return false;
+    }
+    if (event->type() == QEvent::MouseButtonPress) {
+        m_pressPosition = static_cast<QMouseEvent *>(event)->position().toPoint();
+    } else if (event->type() == QEvent::MouseMove) {
+        auto mouseEvent = static_cast<QMouseEvent *>(event);
+        if ((mouseEvent->buttons() & Qt::LeftButton)
+            && (mouseEvent->position().toPoint() - m_pressPosition).manhattanLength() >= QApplication::startDragDistance()) {
+            startDrag();
+            return true;
+        }
+    }
+    return false;
+}
+
+QStringList DragSource::files(int count)
+{
+    if (m_files.size() == count) {
+        return m_files;
+    }
+
+    m_directory = std::make_unique<QTemporaryDir>();
+    m_files.clear();
+    m_files.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QString path = m_directory->filePath(u"file%1.txt"_s.arg(i));
+        QFile file(path);
+        if (!file.open(QFile::WriteOnly)) {
+            qWarning() << "Couldn't create" << path << file.errorString();
+            break;
+        }
+        file.write(QByteArray::number(i) + '\n');
+        m_files.append(path);
+    }
+    return m_files;
+}
+
+QMimeData *DragSource::createMimeData()
+{
+    auto mimeData = new QMimeData;
+
+    const qsizetype bytes = qsizetype(m_kibPerFormat->value()) * 1024;
+    if (m_payload.size() != bytes) {
+        // Not all the same byte, in case anything on the way compresses
+        m_payload.resize(bytes);
+        for (qsizetype i = 0; i < bytes; ++i) {
+            m_payload[i] = char(i % 251);
+        }
+    }
+    for (int i = 0; i < m_formats->value(); ++i) {
+        // Implicitly shared, the formats don't cost a copy each
+        mimeData->setData(u"application/x-xdg-portal-test-%1"_s.arg(i), m_payload);
+    }
+
+    m_fileTransferKey.clear();
+    m_fileTransferTiming = {};
+    if (m_uris->value() > 0) {
+        const QStringList paths = files(m_uris->value());
+        QList<QUrl> urls;
+        urls.reserve(paths.size());
+        for (const QString &path : paths) {
+            urls.append(QUrl::fromLocalFile(path));
+        }
+        mimeData->setUrls(urls);
+
+        if (m_useFileTransfer->isChecked()) {
+            m_fileTransferKey = m_fileTransfer.registerFiles(paths, false, &m_fileTransferTiming);
+            if (m_fileTransferKey.isEmpty()) {
+                qWarning() << "FileTransfer registration failed:" << m_fileTransfer.lastError();
+            } else {
+                mimeData->setData(FileTransferClient::mimeType(), m_fileTransferKey.toUtf8());
+            }
+        }
+    }
+
+    // Set last, so that the setup above isn't counted as transfer time
+    mimeData->setData(markerFormat(), QByteArray::number(monotonicNsecs()));
+    return mimeData;
+}
+
+void DragSource::startDrag()
+{
+    QElapsedTimer timer;
+    timer.start();
+    QMimeData *mimeData = createMimeData();
+    const qint64 setupNsecs = timer.nsecsElapsed();
+
+    auto drag = new QDrag(this);
+    drag->setMimeData(mimeData);
+    timer.restart();
+    const Qt::DropAction action = drag->exec(Qt::CopyAction);
+    const qint64 dragNsecs = timer.nsecsElapsed();
+    if (action == Qt::IgnoreAction && !m_fileTransferKey.isEmpty()) {
+        // Nobody will retrieve the files, which is what stops an autostop transfer
+        m_fileTransfer.stopTransfer(m_fileTransferKey);
+    }
+
+    QString report = i18n("Setup: %1 ms, drag: %2 ms, %3",
+                          LatencyStats::formatMsecs(setupNsecs),
+                          LatencyStats::formatMsecs(dragNsecs),
+                          action == Qt::IgnoreAction ? i18n("not dropped") : i18n("dropped"));
+    if (m_fileTransferTiming.startNsecs >= 0) {
+        report += u'\n'
+            + i18n("FileTransfer: StartTransfer %1 ms, AddFiles %2 ms in %3 calls",
+                   LatencyStats::formatMsecs(m_fileTransferTiming.startNsecs),
+                   LatencyStats::formatMsecs(m_fileTransferTiming.addNsecs),
+                   m_fileTransferTiming.addCalls);
+    }
+    m_report->setText(report);
+}
@@ -0,0 +1,63 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QWidget>
+
+#include <memory>
+
+#include "filetransfer/filetransferclient.h"
+
+class QCheckBox;
+class QLabel;
+class QMimeData;
+class QSpinBox;
+class QTemporaryDir;
+
+/**
+ * Starts drags with synthetic payloads: a number of formats of a given size and a URI list
+ * of generated files, optionally handed over through the FileTransfer portal.
+ *
+ * Drags within one instance are short-circuited by Qt, so drop into a second instance to
+ * measure the compositor path. The drag carries its start time, which the drop site uses to
+ * compute the enter latency.
+ */
+class DragSource : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DragSource(QWidget *parent = nullptr);
+    ~DragSource() override;
+
+    /// Format that carries the CLOCK_MONOTONIC start time of the drag, in nanoseconds
+    static QString markerFormat();
+    /// CLOCK_MONOTONIC in nanoseconds, comparable between processes
+    static qint64 monotonicNsecs();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    QMimeData *createMimeData();
+    QStringList files(int count);
+    void startDrag();
+
+    QSpinBox *m_formats;
+    QSpinBox *m_kibPerFormat;
+    QSpinBox *m_uris;
+    QCheckBox *m_useFileTransfer;
+    QLabel *m_handle;
+    QLabel *m_report;
+
+    QPoint m_pressPosition;
+    std::unique_ptr<QTemporaryDir> m_directory;
+    QStringList m_files;
+    QByteArray m_payload;
+    FileTransferClient m_fileTransfer;
+    FileTransferClient::Timing m_fileTransferTiming;
+    QString m_fileTransferKey;
+};
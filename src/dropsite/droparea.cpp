@@ -4,11 +4,18 @@
 
 #include "droparea.h"
 
+#include <QCoreApplication>
 #include <QDragEnterEvent>
+#include <QElapsedTimer>
+#include <QImage>
 #include <QMimeData>
+#include <QPointer>
+#include <QThreadPool>
 
 #include <KUrlMimeData>
 
+#include "dragsource.h"
+
 DropArea::DropArea(QWidget *parent)
     : QLabel(parent)
 {
@@ -19,8 +26,24 @@ DropArea::DropArea(QWidget *parent)
     clear();
 }
 
+const QList<DropPayload> &DropArea::payloads() const
+{
+    return payloads_;
+}
+
+qint64 DropArea::enteredNsecs() const
+{
+    return entered;
+}
+
+qint64 DropArea::droppedNsecs() const
+{
+    return dropped_;
+}
+
 void DropArea::dragEnterEvent(QDragEnterEvent *event)
 {
+    entered = DragSource::monotonicNsecs();
     setText(tr("<drop content>"));
     setBackgroundRole(QPalette::Highlight);
 
@@ -35,18 +58,54 @@ void DropArea::dragMoveEvent(QDragMoveEvent *event)
 
 void DropArea::dropEvent(QDropEvent *event)
 {
+    dropped_ = DragSource::monotonicNsecs();
     const QMimeData *mimeData = event->mimeData();
 
-    if (mimeData->hasImage()) {
-        setPixmap(qvariant_cast<QPixmap>(mimeData->imageData()));
-    } else if (mimeData->hasHtml()) {
-        setText(mimeData->html());
+    // Each format is transferred exactly once; over Wayland every data() call reads the whole offer through a pipe
+    ++dropCount;
+    payloads_.clear();
+    const QStringList formats = mimeData->formats();
+    for (const QString &format : formats) {
+        QElapsedTimer timer;
+        timer.start();
+        DropPayload payload{format, mimeData->data(format)};
+        payload.nsecs = timer.nsecsElapsed();
+        payloads_.append(payload);
+    }
+
+    const auto find = [this](const auto &predicate) -> const DropPayload * {
+        for (const DropPayload &payload : std::as_const(payloads_)) {
+            if (predicate(payload.format)) {
+                return &payload;
+            }
+        }
+        return nullptr;
+    };
+
+    if (const DropPayload *image = find([](const QString &format) {
+            return format.startsWith(QLatin1String("image/")) || format == QLatin1String("application/x-qt-image");
+        })) {
+        setText(tr("Decoding image…"));
+        decodeImage(image->data);
+    } else if (const DropPayload *html = find([](const QString &format) {
+                   return format == QLatin1String("text/html");
+               })) {
+        setText(QString::fromUtf8(html->data));
         setTextFormat(Qt::RichText);
-    } else if (mimeData->hasText()) {
-        setText(mimeData->text());
+    } else if (const DropPayload *text = find([](const QString &format) {
+                   return format == QLatin1String("text/plain") || format == QLatin1String("text/plain;charset=utf-8");
+               })) {
+        setText(QString::fromUtf8(text->data));
         setTextFormat(Qt::PlainText);
     } else if (mimeData->hasUrls()) {
-        QList<QUrl> urlList = KUrlMimeData::urlsFromMimeData(mimeData);
+        // Parsed from what was already read rather than from the offer again
+        QMimeData urls;
+        for (const DropPayload &payload : std::as_const(payloads_)) {
+            if (payload.format.endsWith(QLatin1String("uri-list")) || payload.format.endsWith(QLatin1String("urilist"))) {
+                urls.setData(payload.format, payload.data);
+            }
+        }
+        QList<QUrl> urlList = KUrlMimeData::urlsFromMimeData(&urls);
         QString text;
         for (int i = 0; i < urlList.size() && i < 32; ++i) {
             text += urlList.at(i).path() + QLatin1Char('\n');
@@ -58,6 +117,41 @@ void DropArea::dropEvent(QDropEvent *event)
 
     setBackgroundRole(QPalette::Dark);
     event->acceptProposedAction();
+    Q_EMIT dropped(payloads_);
+}
+
+void DropArea::decodeImage(const QByteArray &data)
+{
+    const quint64 drop = dropCount;
+    const QSize size = contentsRect().size();
+    QPointer<DropArea> area(this);
+    QThreadPool::globalInstance()->start([area, drop, data, size] {
+        QImage image = QImage::fromData(data);
+        if (!image.isNull() && (image.width() > size.width() || image.height() > size.height())) {
+            image = image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+        // The area may be gone by now, so queue to the application and check there
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [area, drop, image] {
+                if (area) {
+                    area->imageDecoded(drop, image);
+                }
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void DropArea::imageDecoded(quint64 drop, const QImage &image)
+{
+    if (drop != dropCount) {
+        return;
+    }
+    if (image.isNull()) {
+        setText(tr("Cannot decode image"));
+        return;
+    }
+    setPixmap(QPixmap::fromImage(image));
 }
 
 void DropArea::dragLeaveEvent(QDragLeaveEvent *event)
@@ -66,8 +160,24 @@ void DropArea::dragLeaveEvent(QDragLeaveEvent *event)
     event->accept();
 }
 
+qint64 DropArea::payloadBytes() const
+{
+    qint64 bytes = 0;
+    for (const DropPayload &payload : payloads_) {
+        bytes += payload.data.size();
+    }
+    return bytes;
+}
+
+void DropArea::releasePayloads()
+{
+    payloads_.clear();
+    payloads_.squeeze();
+}
+
 void DropArea::clear()
 {
+    ++dropCount;
     setText(tr("<drop content>"));
     setBackgroundRole(QPalette::Dark);
 
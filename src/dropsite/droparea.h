@@ -6,8 +6,17 @@
 
 #include <QLabel>
 
+class QImage;
 class QMimeData;
 
+/// One format of a drop, read once when it was dropped
+struct DropPayload {
+    QString format;
+    QByteArray data;
+    /// Time the transfer of this format took
+    qint64 nsecs = 0;
+};
+
 class DropArea : public QLabel
 {
     Q_OBJECT
@@ -15,11 +24,23 @@ class DropArea : public QLabel
 public:
     explicit DropArea(QWidget *parent = nullptr);
 
+    /// Payloads of the last drop, in the order the source offered them
+    const QList<DropPayload> &payloads() const;
+    /// Bytes held by the payloads of the last drop
+    qint64 payloadBytes() const;
+    /// CLOCK_MONOTONIC times of the last drag enter and drop, in nanoseconds
+    qint64 enteredNsecs() const;
+    qint64 droppedNsecs() const;
+
 public Q_SLOTS:
     void clear();
+    /// Frees the payloads of the last drop, under memory pressure
+    void releasePayloads();
 
 Q_SIGNALS:
+    /// The offered formats changed; only formats() of @p mimeData should be used, reading data blocks on the source
     void changed(const QMimeData *mimeData = nullptr);
+    void dropped(const QList<DropPayload> &payloads);
 
 protected:
     void dragEnterEvent(QDragEnterEvent *event) override;
@@ -28,5 +49,13 @@ protected:
     void dropEvent(QDropEvent *event) override;
 
 private:
+    void decodeImage(const QByteArray &data);
+    void imageDecoded(quint64 drop, const QImage &image);
+
     QLabel *label = nullptr;
+    QList<DropPayload> payloads_;
+    /// Counts drops, so that a decode finishing after the next drop is dropped
+    quint64 dropCount = 0;
+    qint64 entered = 0;
+    qint64 dropped_ = 0;
 };
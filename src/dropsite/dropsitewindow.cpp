@@ -2,12 +2,51 @@
 // SPDX-FileCopyrightText: 2016 The Qt Company Ltd. <https://www.qt.io/licensing/>
 // SPDX-FileCopyrightText: 2022 Harald Sitter <sitter@kde.org>
 
+#include <QDBusPendingCallWatcher>
 #include <QtWidgets>
 
 #include <KUrlMimeData>
 
+#include "benchmark/latencystats.h"
+#include "dragsource.h"
 #include "droparea.h"
 #include "dropsitewindow.h"
+#include "filetransfer/filetransferclient.h"
+#include "memorymonitor/cacheregistry.h"
+
+namespace
+{
+enum Column {
+    FormatColumn,
+    SizeColumn,
+    TimeColumn,
+    RateColumn,
+    ContentColumn,
+    ColumnCount,
+};
+
+// What the table shows of each format; the rest is only rendered when a row is opened
+constexpr int previewBytes = 32;
+constexpr int previewCharacters = 256;
+constexpr int previewUrls = 32;
+// Hex dumps beyond this get too large for a text view
+constexpr qsizetype fullHexBytes = 1024 * 1024;
+
+bool isText(const QString &format)
+{
+    return format.startsWith(QLatin1String("text/")) || format == QLatin1String("application/x-kde4-urilist");
+}
+
+QString hexDump(const QByteArray &data, qsizetype bytes)
+{
+    QString text;
+    text.reserve(qMin(bytes, data.size()) * 3);
+    for (qsizetype i = 0; i < data.size() && i < bytes; ++i) {
+        text.append(QStringLiteral("%1 ").arg(uchar(data[i]), 2, 16, QLatin1Char('0')).toUpper());
+    }
+    return text;
+}
+}
 
 DropSiteWindow::DropSiteWindow(QWidget *parent)
     : QWidget(parent)
@@ -15,21 +54,27 @@ DropSiteWindow::DropSiteWindow(QWidget *parent)
     abstractLabel =
         new QLabel(tr("This example accepts drags from other "
                       "applications and displays the MIME types "
-                      "provided by the drag object."));
+                      "provided by the drag object. Each format is "
+                      "read once on drop; double-click a row for its "
+                      "full content."));
     abstractLabel->setWordWrap(true);
     abstractLabel->adjustSize();
 
+    dragSource = new DragSource;
+
     dropArea = new DropArea;
     connect(dropArea, &DropArea::changed, this, &DropSiteWindow::updateFormatsTable);
+    connect(dropArea, &DropArea::dropped, this, &DropSiteWindow::showPayloads);
 
     QStringList labels;
-    labels << tr("Format") << tr("Content");
+    labels << tr("Format") << tr("Size") << tr("Transfer (ms)") << tr("Rate") << tr("Content");
 
     formatsTable = new QTableWidget;
-    formatsTable->setColumnCount(2);
+    formatsTable->setColumnCount(ColumnCount);
     formatsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     formatsTable->setHorizontalHeaderLabels(labels);
     formatsTable->horizontalHeader()->setStretchLastSection(true);
+    connect(formatsTable, &QTableWidget::cellDoubleClicked, this, &DropSiteWindow::showFullContent);
 
     clearButton = new QPushButton(tr("Clear"));
     copyButton = new QPushButton(tr("Copy"));
@@ -42,11 +87,25 @@ DropSiteWindow::DropSiteWindow(QWidget *parent)
     connect(clearButton, &QAbstractButton::clicked, dropArea, &DropArea::clear);
     connect(copyButton, &QAbstractButton::clicked, this, &DropSiteWindow::copy);
 
+    transferLabel = new QLabel;
+    transferLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
     auto  mainLayout = new QVBoxLayout(this);
     mainLayout->addWidget(abstractLabel);
+    mainLayout->addWidget(dragSource);
     mainLayout->addWidget(dropArea);
+    mainLayout->addWidget(transferLabel);
     mainLayout->addWidget(formatsTable);
     mainLayout->addWidget(buttonBox);
+
+    // The table rows only hold bounded previews, but refer to the payloads by row
+    CacheRegistry::instance().add(tr("Drop payloads"), CacheRegistry::Medium, this, [this] {
+        return dropArea->payloadBytes();
+    }, [this] {
+        formatsTable->setRowCount(0);
+        copyButton->setEnabled(false);
+        dropArea->releasePayloads();
+    });
 }
 
 void DropSiteWindow::updateFormatsTable(const QMimeData *mimeData)
@@ -57,44 +116,149 @@ void DropSiteWindow::updateFormatsTable(const QMimeData *mimeData)
         return;
     }
 
+    // While dragging only the offered formats are listed, reading any of them would stall the drag
     const QStringList formats = mimeData->formats();
     for (const QString &format : formats) {
-        auto formatItem = new QTableWidgetItem(format);
-        formatItem->setFlags(Qt::ItemIsEnabled);
-        formatItem->setTextAlignment(Qt::AlignTop | Qt::AlignLeft);
+        int row = formatsTable->rowCount();
+        formatsTable->insertRow(row);
+        formatsTable->setItem(row, FormatColumn, new QTableWidgetItem(format));
+        formatsTable->setItem(row, ContentColumn, new QTableWidgetItem(tr("Read on drop")));
+    }
 
+    formatsTable->resizeColumnToContents(FormatColumn);
+}
+
+void DropSiteWindow::showPayloads(const QList<DropPayload> &payloads)
+{
+    formatsTable->setRowCount(0);
+    for (const DropPayload &payload : payloads) {
         QString text;
-        if (format == QLatin1String("text/plain")) {
-            text = mimeData->text().simplified();
-        } else if (format == QLatin1String("text/html")) {
-            text = mimeData->html().simplified();
-        } else if (format == QLatin1String("text/uri-list")) {
-            QList<QUrl> urlList = KUrlMimeData::urlsFromMimeData(mimeData);
-            for (int i = 0; i < urlList.size() && i < 32; ++i) {
-                text.append(urlList.at(i).toString() + QLatin1Char(' '));
+        if (payload.format == QLatin1String("text/uri-list")) {
+            const QList<QByteArray> urls = payload.data.split('\n');
+            for (int i = 0; i < urls.size() && i < previewUrls; ++i) {
+                text.append(QString::fromUtf8(urls.at(i).trimmed()) + QLatin1Char(' '));
             }
+        } else if (isText(payload.format)) {
+            // Decoding a prefix may cut a multi-byte character, which only costs a replacement character at the end
+            text = QString::fromUtf8(payload.data.left(previewCharacters * 4)).left(previewCharacters).simplified();
         } else {
-            QByteArray data = mimeData->data(format);
-            for (int i = 0; i < data.size() && i < 32; ++i) {
-                text.append(QStringLiteral("%1 ").arg(uchar(data[i]), 2, 16, QLatin1Char('0')).toUpper());
-            }
+            text = hexDump(payload.data, previewBytes);
         }
 
         int row = formatsTable->rowCount();
         formatsTable->insertRow(row);
-        formatsTable->setItem(row, 0, new QTableWidgetItem(format));
-        formatsTable->setItem(row, 1, new QTableWidgetItem(text));
+        formatsTable->setItem(row, FormatColumn, new QTableWidgetItem(payload.format));
+        formatsTable->setItem(row, SizeColumn, new QTableWidgetItem(QLocale().formattedDataSize(payload.data.size())));
+        formatsTable->setItem(row, TimeColumn, new QTableWidgetItem(QString::number(payload.nsecs / 1000000.0, 'f', 2)));
+        if (payload.nsecs > 0) {
+            const qint64 bytesPerSecond = qint64(double(payload.data.size()) * 1e9 / double(payload.nsecs));
+            formatsTable->setItem(row, RateColumn, new QTableWidgetItem(tr("%1/s").arg(QLocale().formattedDataSize(bytesPerSecond))));
+        }
+        formatsTable->setItem(row, ContentColumn, new QTableWidgetItem(text));
     }
 
-    formatsTable->resizeColumnToContents(0);
+    formatsTable->resizeColumnToContents(FormatColumn);
     copyButton->setEnabled(formatsTable->rowCount() > 0);
+    updateTransferReport(payloads);
+}
+
+void DropSiteWindow::updateTransferReport(const QList<DropPayload> &payloads)
+{
+    qint64 bytes = 0;
+    qint64 nsecs = 0;
+    qint64 started = 0;
+    QString fileTransferKey;
+    for (const DropPayload &payload : payloads) {
+        bytes += payload.data.size();
+        nsecs += payload.nsecs;
+        if (payload.format == DragSource::markerFormat()) {
+            started = payload.data.toLongLong();
+        } else if (payload.format == FileTransferClient::mimeType()) {
+            fileTransferKey = QString::fromUtf8(payload.data);
+        }
+    }
+
+    QStringList lines;
+    lines.append(tr("Transferred %1 in %2 formats within %3 ms (%4/s)")
+                     .arg(QLocale().formattedDataSize(bytes))
+                     .arg(payloads.size())
+                     .arg(LatencyStats::formatMsecs(nsecs))
+                     .arg(QLocale().formattedDataSize(nsecs > 0 ? qint64(double(bytes) * 1e9 / double(nsecs)) : 0)));
+    // Only drags from our own drag source carry their start time
+    if (started > 0) {
+        lines.append(tr("Drag start to enter: %1 ms, enter to drop: %2 ms")
+                         .arg(LatencyStats::formatMsecs(dropArea->enteredNsecs() - started))
+                         .arg(LatencyStats::formatMsecs(dropArea->droppedNsecs() - dropArea->enteredNsecs())));
+    }
+    const int serial = ++transferReportSerial;
+    if (!fileTransferKey.isEmpty()) {
+        // The portal may take a while to export the files, so don't wait for it on the GUI thread
+        lines.append(tr("FileTransfer: RetrieveFiles pending…"));
+        QElapsedTimer timer;
+        timer.start();
+        auto watcher = new QDBusPendingCallWatcher(FileTransferClient().retrieveFilesAsync(fileTransferKey), this);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, serial, timer, lines](QDBusPendingCallWatcher *watcher) {
+            watcher->deleteLater();
+            const qint64 retrieveNsecs = timer.nsecsElapsed();
+            if (serial != transferReportSerial) {
+                return;
+            }
+            QDBusPendingReply<QStringList> reply = *watcher;
+            QStringList report = lines;
+            report.last() = reply.isError()
+                ? tr("FileTransfer: RetrieveFiles failed: %1").arg(reply.error().message())
+                : tr("FileTransfer: RetrieveFiles returned %1 files in %2 ms").arg(reply.value().size()).arg(LatencyStats::formatMsecs(retrieveNsecs));
+            transferLabel->setText(report.join(QLatin1Char('\n')));
+        });
+    }
+    transferLabel->setText(lines.join(QLatin1Char('\n')));
+}
+
+void DropSiteWindow::showFullContent(int row)
+{
+    const QList<DropPayload> &payloads = dropArea->payloads();
+    if (row < 0 || row >= payloads.size() || formatsTable->item(row, FormatColumn)->text() != payloads.at(row).format) {
+        return;
+    }
+    const DropPayload &payload = payloads.at(row);
+
+    QString text;
+    if (isText(payload.format)) {
+        text = QString::fromUtf8(payload.data);
+    } else {
+        text = hexDump(payload.data, fullHexBytes);
+        if (payload.data.size() > fullHexBytes) {
+            text += QLatin1Char('\n') + tr("(%1 more bytes not shown)").arg(payload.data.size() - fullHexBytes);
+        }
+    }
+
+    auto dialog = new QDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setWindowTitle(payload.format);
+    auto view = new QPlainTextEdit(text);
+    view->setReadOnly(true);
+    if (!isText(payload.format)) {
+        view->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    }
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(buttons, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+    auto layout = new QVBoxLayout(dialog);
+    layout->addWidget(view);
+    layout->addWidget(buttons);
+    dialog->resize(640, 480);
+    dialog->show();
 }
 
 void DropSiteWindow::copy()
 {
     QString text;
     for (int row = 0, rowCount = formatsTable->rowCount(); row < rowCount; ++row) {
-        text += formatsTable->item(row, 0)->text() + ": " + formatsTable->item(row, 1)->text() + '\n';
+        QStringList columns;
+        for (int column = 0; column < ColumnCount; ++column) {
+            const QTableWidgetItem *item = formatsTable->item(row, column);
+            columns.append(item ? item->text() : QString());
+        }
+        text += columns.join(QLatin1String(": ")) + '\n';
     }
     QGuiApplication::clipboard()->setText(text);
 }
@@ -6,12 +6,14 @@
 
 #include <QWidget>
 
+#include "droparea.h"
+
+class DragSource;
 class QDialogButtonBox;
 class QLabel;
 class QMimeData;
 class QPushButton;
 class QTableWidget;
-class DropArea;
 
 class DropSiteWindow : public QWidget
 {
@@ -22,12 +24,20 @@ public:
 
 public Q_SLOTS:
     void updateFormatsTable(const QMimeData *mimeData);
+    void showPayloads(const QList<DropPayload> &payloads);
+    void showFullContent(int row);
     void copy();
 
 private:
+    void updateTransferReport(const QList<DropPayload> &payloads);
+
+    DragSource *dragSource;
     DropArea *dropArea;
     QLabel *abstractLabel;
+    QLabel *transferLabel;
     QTableWidget *formatsTable;
+    /// Bumped per drop, so a RetrieveFiles reply for an older drop doesn't touch the report
+    int transferReportSerial = 0;
 
     QPushButton *clearButton;
     QPushButton *copyButton;
@@ -0,0 +1,328 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "launcherchurnwindow.h"
+
+#include <QComboBox>
+#include <QDBusConnection>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusVariant>
+#include <QFile>
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include <portalsrequest_interface.h>
+
+#include "iconcache.h"
+
+using namespace Qt::StringLiterals;
+
+static QString launcherInterface()
+{
+    return u"org.freedesktop.portal.DynamicLauncher"_s;
+}
+
+static QVariant launcherIcon()
+{
+    auto &iconCache = IconCache::instance();
+    const PortalIcon icon = iconCache.portalIcon(iconCache.themedIcon(u"utilities-terminal"_s, 128), false);
+    return QVariant::fromValue(QDBusVariant(QVariant::fromValue(icon)));
+}
+
+LauncherChurnWindow::LauncherChurnWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent)
+    : QWidget(parent)
+    , m_parentWindowId(parentWindowId)
+{
+    QFile templateFile(u":/data/webapp.desktop.in"_s);
+    if (templateFile.open(QFile::ReadOnly)) {
+        m_template = QString::fromUtf8(templateFile.readAll());
+    } else {
+        qWarning() << "Couldn't read desktop entry template" << templateFile.errorString();
+    }
+
+    auto description = new QLabel(i18n("Installs launchers with distinct ids from a desktop entry template, queries them with "
+                                       "GetDesktopEntry/GetIcon and uninstalls them again. Only works inside the sandbox."));
+    description->setWordWrap(true);
+
+    m_count = new QSpinBox;
+    m_count->setRange(1, 100000);
+    m_count->setValue(100);
+
+    m_parallel = new QSpinBox;
+    m_parallel->setRange(1, 256);
+    m_parallel->setValue(1);
+
+    m_tokenMode = new QComboBox;
+    m_tokenMode->addItems({i18n("RequestInstallToken (non-interactive)"), i18n("PrepareInstall (dialog per launcher)")});
+
+    m_startButton = new QPushButton(i18n("Run churn"));
+    connect(m_startButton, &QPushButton::clicked, this, &LauncherChurnWindow::start);
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Launchers:"), m_count);
+    form->addRow(i18n("Operations in flight:"), m_parallel);
+    form->addRow(i18n("Install token:"), m_tokenMode);
+    form->addRow(QString(), m_startButton);
+
+    m_status = new QLabel;
+    m_status->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    m_table = new QTableWidget(OperationCount, 6);
+    m_table->setHorizontalHeaderLabels({i18n("Calls"), i18n("p50 (ms)"), i18n("p99 (ms)"), i18n("Max (ms)"), i18n("Mean (ms)"), i18n("Throughput (/s)")});
+    m_table->setVerticalHeaderLabels({i18n("Install token"), u"Install"_s, u"GetDesktopEntry"_s, u"GetIcon"_s, u"Uninstall"_s});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_status);
+    layout->addWidget(m_table);
+
+    m_clock.start();
+    updateReport();
+}
+
+QString LauncherChurnWindow::desktopEntry(const QString &desktopTemplate, int index)
+{
+    QString entry = desktopTemplate;
+    entry.replace("@NAME@"_L1, u"Churn %1"_s.arg(index));
+    entry.replace("@INDEX@"_L1, QString::number(index));
+    entry.replace("@URL@"_L1, u"https://kde.org/?launcher=%1"_s.arg(index));
+    return entry;
+}
+
+QString LauncherChurnWindow::desktopFileId(int index)
+{
+    return u"org.kde.xdg-portal-test-kde.churn%1.desktop"_s.arg(index);
+}
+
+void LauncherChurnWindow::start()
+{
+    for (auto &stats : m_stats) {
+        stats.clear();
+    }
+    m_busyNsecs = {};
+    m_active = {};
+    m_total = m_count->value();
+    m_next = 0;
+    m_inFlight = 0;
+    m_installed.clear();
+    m_errors = 0;
+    m_startButton->setEnabled(false);
+    m_status->setText(i18n("Installing…"));
+
+    for (int i = 0; i < qMin(m_parallel->value(), m_total); ++i) {
+        installNext();
+    }
+}
+
+QDBusMessage LauncherChurnWindow::launcherCall(const QString &method) const
+{
+    return QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), launcherInterface(), method);
+}
+
+void LauncherChurnWindow::call(Operation operation,
+                               const QDBusMessage &message,
+                               const std::function<void(const QDBusMessage &)> &onSuccess,
+                               const std::function<void()> &onDone)
+{
+    const qint64 start = beginOperation(operation);
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, operation, start, onSuccess, onDone](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        endOperation(operation, start);
+        if (watcher->isError()) {
+            qWarning() << "DynamicLauncher call failed:" << watcher->error().message();
+            ++m_errors;
+            onDone();
+        } else {
+            onSuccess(watcher->reply());
+        }
+    });
+}
+
+qint64 LauncherChurnWindow::beginOperation(Operation operation)
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    if (m_active[operation]++ == 0) {
+        m_busySince[operation] = now;
+    }
+    return now;
+}
+
+void LauncherChurnWindow::endOperation(Operation operation, qint64 start)
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    m_stats[operation].add(now - start);
+    if (--m_active[operation] == 0) {
+        m_busyNsecs[operation] += now - m_busySince[operation];
+    }
+}
+
+void LauncherChurnWindow::installNext()
+{
+    if (m_next >= m_total) {
+        if (m_inFlight == 0) {
+            finishInstall();
+        }
+        return;
+    }
+
+    ++m_inFlight;
+    requestToken(m_next++);
+}
+
+void LauncherChurnWindow::requestToken(int index)
+{
+    const auto chainDone = [this] {
+        --m_inFlight;
+        installNext();
+    };
+
+    const QString name = u"Churn %1"_s.arg(index);
+    if (m_tokenMode->currentIndex() == 0) {
+        QDBusMessage message = launcherCall(u"RequestInstallToken"_s);
+        message << name << launcherIcon() << QVariantMap{};
+        call(PrepareInstall, message, [this, index](const QDBusMessage &reply) {
+            install(index, reply.arguments().value(0).toString());
+        }, chainDone);
+        return;
+    }
+
+    const QString token = nextRequestToken();
+    QDBusMessage message = launcherCall(u"PrepareInstall"_s);
+    message << m_parentWindowId() << name << launcherIcon()
+            << QVariantMap{{u"launcher_type"_s, 2U}, {u"target"_s, u"https://kde.org/?launcher=%1"_s.arg(index)}, {u"handle_token"_s, token}};
+
+    // Subscribed before the call, a fast backend can respond before the method reply arrives
+    auto req = new OrgFreedesktopPortalRequestInterface(desktopPortalService(), portalRequestPath(token), QDBusConnection::sessionBus(), this);
+    // The interesting latency is the time until Response, which includes the dialog
+    const qint64 start = beginOperation(PrepareInstall);
+    connect(req, &OrgFreedesktopPortalRequestInterface::Response, this, [this, req, index, start, chainDone](uint response, const QVariantMap &results) {
+        req->deleteLater();
+        endOperation(PrepareInstall, start);
+        if (response != 0) {
+            ++m_errors;
+            chainDone();
+            return;
+        }
+        install(index, results.value(u"token"_s).toString());
+    });
+
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, req, start, chainDone](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<QDBusObjectPath> reply = *watcher;
+        if (reply.isError()) {
+            qWarning() << "Couldn't call PrepareInstall:" << reply.error().message();
+            delete req;
+            endOperation(PrepareInstall, start);
+            ++m_errors;
+            chainDone();
+        }
+    });
+}
+
+void LauncherChurnWindow::install(int index, const QString &token)
+{
+    QDBusMessage message = launcherCall(u"Install"_s);
+    message << token << desktopFileId(index) << desktopEntry(m_template, index) << QVariantMap{};
+    call(Install, message, [this, index](const QDBusMessage &) {
+        m_installed.append(index);
+        query(index);
+    }, [this] {
+        --m_inFlight;
+        installNext();
+    });
+}
+
+void LauncherChurnWindow::query(int index)
+{
+    const auto chainDone = [this] {
+        --m_inFlight;
+        installNext();
+    };
+
+    QDBusMessage entryMessage = launcherCall(u"GetDesktopEntry"_s);
+    entryMessage << desktopFileId(index);
+    call(GetDesktopEntry, entryMessage, [this, index, chainDone](const QDBusMessage &) {
+        QDBusMessage iconMessage = launcherCall(u"GetIcon"_s);
+        iconMessage << desktopFileId(index);
+        call(GetIcon, iconMessage, [chainDone](const QDBusMessage &) {
+            chainDone();
+        }, chainDone);
+    }, chainDone);
+}
+
+void LauncherChurnWindow::finishInstall()
+{
+    updateReport();
+
+    m_status->setText(i18n("Uninstalling…"));
+    m_next = 0;
+    // uninstallNext() finishes right away when nothing got installed
+    for (int i = 0; i < qMax<qsizetype>(1, qMin<qsizetype>(m_parallel->value(), m_installed.size())); ++i) {
+        uninstallNext();
+    }
+}
+
+void LauncherChurnWindow::uninstallNext()
+{
+    if (m_next >= m_installed.size()) {
+        if (m_inFlight == 0) {
+            finishUninstall();
+        }
+        return;
+    }
+
+    ++m_inFlight;
+    QDBusMessage message = launcherCall(u"Uninstall"_s);
+    message << desktopFileId(m_installed.at(m_next++)) << QVariantMap{};
+    const auto chainDone = [this] {
+        --m_inFlight;
+        uninstallNext();
+    };
+    call(Uninstall, message, [chainDone](const QDBusMessage &) {
+        chainDone();
+    }, chainDone);
+}
+
+void LauncherChurnWindow::finishUninstall()
+{
+    m_startButton->setEnabled(true);
+    updateReport();
+}
+
+void LauncherChurnWindow::updateReport()
+{
+    for (int operation = 0; operation < OperationCount; ++operation) {
+        const LatencyStats &stats = m_stats[operation];
+        const qint64 busy = m_busyNsecs[operation];
+        const QStringList columns = {
+            QString::number(stats.count()),
+            LatencyStats::formatMsecs(stats.percentile(0.5)),
+            LatencyStats::formatMsecs(stats.percentile(0.99)),
+            LatencyStats::formatMsecs(stats.max()),
+            LatencyStats::formatMsecs(stats.mean()),
+            busy > 0 ? QString::number(stats.count() / (busy / 1e9), 'f', 1) : QString(),
+        };
+        for (int column = 0; column < columns.size(); ++column) {
+            m_table->setItem(operation, column, new QTableWidgetItem(columns.at(column)));
+        }
+    }
+
+    if (m_startButton->isEnabled()) {
+        m_status->setText(i18n("Launchers: %1, installed: %2, errors: %3", m_total, m_installed.size(), m_errors));
+    }
+}
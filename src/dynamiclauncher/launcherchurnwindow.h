@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusMessage>
+#include <QElapsedTimer>
+#include <QWidget>
+
+#include <array>
+#include <functional>
+
+#include "benchmark/latencystats.h"
+#include "portalcommon.h"
+
+class QComboBox;
+class QLabel;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+
+/// Installs, queries and uninstalls many DynamicLauncher entries to see how the backend copes
+class LauncherChurnWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LauncherChurnWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent = nullptr);
+
+    /// Fills the desktop entry template with the values for launcher @p index
+    static QString desktopEntry(const QString &desktopTemplate, int index);
+    static QString desktopFileId(int index);
+
+public Q_SLOTS:
+    void start();
+
+private:
+    enum Operation {
+        PrepareInstall,
+        Install,
+        GetDesktopEntry,
+        GetIcon,
+        Uninstall,
+        OperationCount,
+    };
+
+    void installNext();
+    void requestToken(int index);
+    void install(int index, const QString &token);
+    void query(int index);
+    void finishInstall();
+    void uninstallNext();
+    void finishUninstall();
+    void call(Operation operation, const QDBusMessage &message, const std::function<void(const QDBusMessage &)> &onSuccess, const std::function<void()> &onDone);
+    /// Marks a call of @p operation as sent, returns its start time
+    qint64 beginOperation(Operation operation);
+    void endOperation(Operation operation, qint64 start);
+    QDBusMessage launcherCall(const QString &method) const;
+    void updateReport();
+
+    ParentWindowIdFunction m_parentWindowId;
+
+    QSpinBox *m_count;
+    QSpinBox *m_parallel;
+    QComboBox *m_tokenMode;
+    QPushButton *m_startButton;
+    QLabel *m_status;
+    QTableWidget *m_table;
+
+    QString m_template;
+    QElapsedTimer m_clock;
+    std::array<LatencyStats, OperationCount> m_stats;
+    /// Time during which at least one call of the operation was in flight, for its throughput
+    std::array<qint64, OperationCount> m_busyNsecs = {};
+    std::array<qint64, OperationCount> m_busySince = {};
+    std::array<int, OperationCount> m_active = {};
+    int m_total = 0;
+    int m_next = 0;
+    int m_inFlight = 0;
+    /// Indices of the launchers that got installed, the only ones to uninstall
+    QList<int> m_installed;
+    int m_errors = 0;
+};
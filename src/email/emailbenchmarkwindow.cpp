@@ -0,0 +1,490 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "emailbenchmarkwindow.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QDBusPendingCallWatcher>
+#include <QDBusUnixFileDescriptor>
+#include <QFile>
+#include <QFileInfo>
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QLocale>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QTemporaryDir>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include "openuri/stubhandler.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+enum Column {
+    SizeColumn,
+    CountColumn,
+    TotalColumn,
+    CallColumn,
+    ResponseColumn,
+    ResponseTailColumn,
+    LaunchColumn,
+    ReceivedColumn,
+    FailuresColumn,
+    ColumnCount,
+};
+
+constexpr int responseTimeout = 30000;
+constexpr int launchTimeout = 10000;
+constexpr qint64 kib = 1024;
+
+/// Least squares slope of @p y over @p x, 0 without spread in @p x
+double slope(const QList<double> &x, const QList<double> &y)
+{
+    const qsizetype n = x.size();
+    if (n < 2) {
+        return 0;
+    }
+    double sumX = 0;
+    double sumY = 0;
+    double sumXY = 0;
+    double sumXX = 0;
+    for (qsizetype i = 0; i < n; ++i) {
+        sumX += x.at(i);
+        sumY += y.at(i);
+        sumXY += x.at(i) * y.at(i);
+        sumXX += x.at(i) * x.at(i);
+    }
+    const double denominator = double(n) * sumXX - sumX * sumX;
+    return qFuzzyIsNull(denominator) ? 0 : (double(n) * sumXY - sumX * sumY) / denominator;
+}
+}
+
+EmailBenchmarkWindow::EmailBenchmarkWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent)
+    : QWidget(parent)
+    , m_parentWindowId(parentWindowId)
+    , m_stub(new StubHandler(u"mail-stub-handler"_s, u"x-scheme-handler/mailto"_s, QString(), this))
+{
+    qDBusRegisterMetaType<QList<QDBusUnixFileDescriptor>>();
+
+    auto description = new QLabel(i18n("Composes emails with generated attachments passed as file descriptors. A stub mailto handler stands in "
+                                       "for the mail client while a run is going: it becomes the default and records what it receives, and "
+                                       "the previous default comes back when the run ends."));
+    description->setWordWrap(true);
+
+    m_sizes = new QLineEdit(u"64, 1024, 16384"_s);
+    m_counts = new QLineEdit(u"0, 1, 4, 16, 64"_s);
+
+    m_repetitions = new QSpinBox;
+    m_repetitions->setRange(1, 100);
+    m_repetitions->setValue(3);
+
+    m_stubButton = new QPushButton;
+    connect(m_stubButton, &QPushButton::clicked, this, [this] {
+        m_stubInstalledForRun = false;
+        if (m_stub->isInstalled()) {
+            m_stub->uninstall();
+        } else if (QString error; !m_stub->install(&error)) {
+            m_status->setText(error);
+        }
+        updateStubButton();
+    });
+
+    m_startButton = new QPushButton(i18n("Run"));
+    connect(m_startButton, &QPushButton::clicked, this, [this] {
+        if (m_running) {
+            stop();
+        } else {
+            start();
+        }
+    });
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Attachment sizes (KiB):"), m_sizes);
+    form->addRow(i18n("Attachment counts:"), m_counts);
+    form->addRow(i18n("Repetitions:"), m_repetitions);
+    form->addRow(QString(), m_stubButton);
+    form->addRow(QString(), m_startButton);
+
+    m_status = new QLabel;
+    m_status->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_status->setWordWrap(true);
+
+    m_table = new QTableWidget(0, ColumnCount);
+    m_table->setHorizontalHeaderLabels({i18n("Attachment"),
+                                        i18n("Count"),
+                                        i18n("Total"),
+                                        i18n("Call p50 (ms)"),
+                                        i18n("Response p50 (ms)"),
+                                        i18n("Response max (ms)"),
+                                        i18n("Launch p50 (ms)"),
+                                        i18n("Received"),
+                                        i18n("Failed / not launched")});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_status);
+    layout->addWidget(m_table, 1);
+
+    connect(m_stub, &StubHandler::launched, this, &EmailBenchmarkWindow::handlerLaunched);
+
+    m_timeout.setSingleShot(true);
+    connect(&m_timeout, &QTimer::timeout, this, [this] {
+        if (!m_responded) {
+            QDBusConnection::sessionBus().asyncCall(
+                QDBusMessage::createMethodCall(desktopPortalService(), m_requestPath, portalRequestInterface(), u"Close"_s));
+            finishRun(true);
+        } else {
+            ++m_steps[m_currentStep].missingLaunches;
+            finishRun(false);
+        }
+    });
+
+    updateStubButton();
+}
+
+EmailBenchmarkWindow::~EmailBenchmarkWindow()
+{
+    stop();
+    // Never leave the stub behind as the handler once the application is gone
+    if (m_stub->isInstalled()) {
+        m_stub->uninstall();
+    }
+}
+
+void EmailBenchmarkWindow::updateStubButton()
+{
+    m_stubButton->setText(m_stub->isInstalled() ? i18n("Uninstall stub mail handler") : i18n("Install stub mail handler"));
+}
+
+QStringList EmailBenchmarkWindow::attachments(qint64 bytes, int count)
+{
+    if (!m_directory) {
+        m_directory = std::make_unique<QTemporaryDir>();
+    }
+    QStringList &files = m_files[bytes];
+    if (files.size() >= count) {
+        return files.mid(0, count);
+    }
+
+    // Not all zeroes, in case something on the way compresses
+    QByteArray block(64 * kib, Qt::Uninitialized);
+    for (qsizetype i = 0; i < block.size(); ++i) {
+        block[i] = char(i * 131 + 7);
+    }
+    while (files.size() < count) {
+        const QString path = m_directory->filePath(u"attachment-%1k-%2.bin"_s.arg(bytes / kib).arg(files.size()));
+        QFile file(path);
+        if (!file.open(QFile::WriteOnly)) {
+            qWarning() << "Couldn't create" << path << file.errorString();
+            return {};
+        }
+        for (qint64 written = 0; written < bytes; written += block.size()) {
+            file.write(block.constData(), qMin<qint64>(block.size(), bytes - written));
+        }
+        files.append(path);
+    }
+    return files;
+}
+
+void EmailBenchmarkWindow::start()
+{
+    const auto numbers = [](const QString &text, int minimum) {
+        QList<int> values;
+        const QStringList parts = text.split(u',', Qt::SkipEmptyParts);
+        for (const QString &part : parts) {
+            bool ok = false;
+            const int value = part.trimmed().toInt(&ok);
+            if (ok && value >= minimum) {
+                values.append(value);
+            }
+        }
+        return values;
+    };
+    m_steps.clear();
+    const QList<int> sizes = numbers(m_sizes->text(), 1);
+    const QList<int> counts = numbers(m_counts->text(), 0);
+    for (const int size : sizes) {
+        for (const int count : counts) {
+            Step step;
+            step.attachmentBytes = size * kib;
+            step.count = count;
+            m_steps.append(step);
+        }
+    }
+    if (m_steps.isEmpty()) {
+        return;
+    }
+
+    if (!m_stub->isInstalled()) {
+        QString error;
+        if (!m_stub->install(&error)) {
+            m_status->setText(error);
+            return;
+        }
+        m_stubInstalledForRun = true;
+        updateStubButton();
+    }
+
+    m_table->setRowCount(m_steps.size());
+    for (int row = 0; row < m_steps.size(); ++row) {
+        updateRow(row);
+    }
+    m_currentStep = 0;
+    m_currentRepetition = 0;
+    m_running = true;
+    m_startButton->setText(i18n("Stop"));
+    m_stub->watch();
+    runNext();
+}
+
+void EmailBenchmarkWindow::stop()
+{
+    if (!m_requestPath.isEmpty()) {
+        QDBusConnection::sessionBus().disconnect(desktopPortalService(),
+                                                 m_requestPath,
+                                                 portalRequestInterface(),
+                                                 portalRequestResponse(),
+                                                 this,
+                                                 SLOT(composeResponse(uint,QVariantMap)));
+        m_requestPath.clear();
+    }
+    m_timeout.stop();
+    m_stub->stopWatching();
+    if (m_stubInstalledForRun) {
+        m_stub->uninstall();
+        m_stubInstalledForRun = false;
+        updateStubButton();
+    }
+    m_running = false;
+    m_currentStep = -1;
+    m_startButton->setText(i18n("Run"));
+}
+
+void EmailBenchmarkWindow::runNext()
+{
+    if (!m_running) {
+        return;
+    }
+    if (m_currentRepetition >= m_repetitions->value()) {
+        m_currentRepetition = 0;
+        ++m_currentStep;
+    }
+    if (m_currentStep >= m_steps.size()) {
+        finish();
+        return;
+    }
+
+    Step &step = m_steps[m_currentStep];
+    m_status->setText(i18n("%1 × %2, run %3 of %4",
+                           step.count,
+                           QLocale().formattedDataSize(step.attachmentBytes),
+                           m_currentRepetition + 1,
+                           m_repetitions->value()));
+
+    // Generated before the clock starts, only passing them on is measured
+    const QStringList files = attachments(step.attachmentBytes, step.count);
+    if (files.size() != step.count) {
+        step.error = i18n("Couldn't create the attachments");
+        m_currentRepetition = m_repetitions->value();
+        finishRun(true);
+        return;
+    }
+    QList<QDBusUnixFileDescriptor> fds;
+    fds.reserve(files.size());
+    for (const QString &path : files) {
+        const int fd = ::open(QFile::encodeName(path).constData(), O_PATH | O_CLOEXEC);
+        if (fd < 0) {
+            qWarning() << "Couldn't open" << path;
+            continue;
+        }
+        // QDBusUnixFileDescriptor keeps a duplicate
+        fds.append(QDBusUnixFileDescriptor(fd));
+        ::close(fd);
+    }
+
+    // The subject comes back in the mailto URL and tells which run launched the handler
+    m_expectedSubject = u"xdg-portal-test-kde run %1"_s.arg(++m_runCounter);
+    const QString token = nextRequestToken();
+    QVariantMap options{
+        {u"handle_token"_s, token},
+        {u"addresses"_s, QStringList{u"reports@example.org"_s}},
+        {u"subject"_s, m_expectedSubject},
+        {u"body"_s, i18n("Sent by the Email tab of xdg-portal-test-kde.")},
+    };
+    if (!fds.isEmpty()) {
+        options.insert(u"attachment_fds"_s, QVariant::fromValue(fds));
+    }
+
+    m_requestPath = portalRequestPath(token);
+    QDBusConnection::sessionBus().connect(desktopPortalService(),
+                                          m_requestPath,
+                                          portalRequestInterface(),
+                                          portalRequestResponse(),
+                                          this,
+                                          SLOT(composeResponse(uint,QVariantMap)));
+
+    QDBusMessage message =
+        QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), u"org.freedesktop.portal.Email"_s, u"ComposeEmail"_s);
+    message << m_parentWindowId() << options;
+
+    m_responded = false;
+    m_launchSeen = false;
+    m_sentRealtimeNsecs = StubHandler::realtimeNsecs();
+    m_requestClock.start();
+    const QString requestPath = m_requestPath;
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, requestPath](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (requestPath != m_requestPath) {
+            return;
+        }
+        if (watcher->isError()) {
+            qWarning() << "ComposeEmail failed:" << watcher->error().message();
+            m_steps[m_currentStep].error = watcher->error().message();
+            finishRun(true);
+            return;
+        }
+        m_steps[m_currentStep].call.add(m_requestClock.nsecsElapsed());
+    });
+    m_timeout.start(responseTimeout);
+}
+
+void EmailBenchmarkWindow::composeResponse(uint response, const QVariantMap &results)
+{
+    Q_UNUSED(results)
+    if (m_responded) {
+        return;
+    }
+    m_responded = true;
+    if (response != 0) {
+        finishRun(true);
+        return;
+    }
+    m_steps[m_currentStep].response.add(m_requestClock.nsecsElapsed());
+    if (m_launchSeen) {
+        finishRun(false);
+    } else {
+        m_timeout.start(launchTimeout);
+    }
+}
+
+void EmailBenchmarkWindow::handlerLaunched(const QString &argument, qint64 realtimeNsecs)
+{
+    if (!m_running || m_launchSeen) {
+        return;
+    }
+    const QUrl url(argument);
+    const QUrlQuery query(url);
+    if (url.scheme() != u"mailto" || query.queryItemValue(u"subject"_s, QUrl::FullyDecoded) != m_expectedSubject) {
+        return;
+    }
+    m_launchSeen = true;
+
+    Step &step = m_steps[m_currentStep];
+    step.launch.add(realtimeNsecs - m_sentRealtimeNsecs);
+    // Mail clients disagree on the key, backends pass local paths or file URLs
+    QStringList received = query.allQueryItemValues(u"attach"_s, QUrl::FullyDecoded);
+    received += query.allQueryItemValues(u"attachment"_s, QUrl::FullyDecoded);
+    qint64 bytes = 0;
+    for (const QString &attachment : std::as_const(received)) {
+        const QUrl attachmentUrl = QUrl::fromUserInput(attachment);
+        bytes += QFileInfo(attachmentUrl.isLocalFile() ? attachmentUrl.toLocalFile() : attachment).size();
+    }
+    step.receivedAttachments = received.size();
+    step.receivedBytes = bytes;
+
+    // The handler can come up before the backend responds
+    if (m_responded) {
+        finishRun(false);
+    }
+}
+
+void EmailBenchmarkWindow::finishRun(bool failed)
+{
+    QDBusConnection::sessionBus().disconnect(desktopPortalService(),
+                                             m_requestPath,
+                                             portalRequestInterface(),
+                                             portalRequestResponse(),
+                                             this,
+                                             SLOT(composeResponse(uint,QVariantMap)));
+    m_requestPath.clear();
+    m_timeout.stop();
+    if (!m_running) {
+        return;
+    }
+    if (failed) {
+        ++m_steps[m_currentStep].failures;
+    }
+    updateRow(m_currentStep);
+    ++m_currentRepetition;
+    // Outside of the D-Bus dispatch
+    QTimer::singleShot(0, this, &EmailBenchmarkWindow::runNext);
+}
+
+void EmailBenchmarkWindow::updateRow(int row)
+{
+    const Step &step = m_steps.at(row);
+    const auto set = [this, row](int column, const QString &text) {
+        m_table->setItem(row, column, new QTableWidgetItem(text));
+    };
+    const auto median = [](const LatencyStats &stats) {
+        return stats.count() > 0 ? LatencyStats::formatMsecs(stats.percentile(0.5)) : QString();
+    };
+
+    set(SizeColumn, QLocale().formattedDataSize(step.attachmentBytes));
+    set(CountColumn, QString::number(step.count));
+    set(TotalColumn, QLocale().formattedDataSize(step.attachmentBytes * step.count));
+    set(CallColumn, median(step.call));
+    set(ResponseColumn, median(step.response));
+    set(ResponseTailColumn, step.response.count() > 0 ? LatencyStats::formatMsecs(step.response.max()) : QString());
+    set(LaunchColumn, median(step.launch));
+    set(ReceivedColumn,
+        step.receivedAttachments < 0 ? QString()
+                                     : i18n("%1 files, %2", step.receivedAttachments, QLocale().formattedDataSize(step.receivedBytes)));
+    set(FailuresColumn,
+        step.error.isEmpty() ? u"%1 / %2"_s.arg(step.failures).arg(step.missingLaunches)
+                             : u"%1 / %2 (%3)"_s.arg(step.failures).arg(step.missingLaunches).arg(step.error));
+}
+
+void EmailBenchmarkWindow::finish()
+{
+    stop();
+
+    QList<double> counts;
+    QList<double> mebibytes;
+    QList<double> responses;
+    for (const Step &step : std::as_const(m_steps)) {
+        if (step.response.count() == 0) {
+            continue;
+        }
+        counts.append(step.count);
+        mebibytes.append(double(step.attachmentBytes * step.count) / double(kib * kib));
+        responses.append(double(step.response.percentile(0.5)) / 1e6);
+    }
+    if (responses.isEmpty()) {
+        m_status->setText(i18n("No email was composed"));
+        return;
+    }
+    m_status->setText(i18n("Response p50 grows by %1 ms per attachment and %2 ms per MiB attached",
+                           QString::number(slope(counts, responses), 'f', 2),
+                           QString::number(slope(mebibytes, responses), 'f', 2)));
+}
@@ -0,0 +1,102 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QTimer>
+#include <QWidget>
+
+#include <memory>
+
+#include "benchmark/latencystats.h"
+#include "portalcommon.h"
+
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+class QTemporaryDir;
+class StubHandler;
+
+/**
+ * Composes emails through org.freedesktop.portal.Email with generated attachments passed
+ * as attachment_fds, for every combination of attachment size and count.
+ *
+ * A stub mailto handler takes the place of the mail client and records what it was started
+ * with, so every run reports the call, Response and handler launch latency, and how many
+ * attachments and bytes arrived. The summary fits the Response latency against the
+ * attachment count and the total size.
+ */
+class EmailBenchmarkWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit EmailBenchmarkWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent = nullptr);
+    ~EmailBenchmarkWindow() override;
+
+public Q_SLOTS:
+    void start();
+    void stop();
+
+private Q_SLOTS:
+    void composeResponse(uint response, const QVariantMap &results);
+
+private:
+    struct Step {
+        qint64 attachmentBytes = 0;
+        int count = 0;
+        LatencyStats call;
+        LatencyStats response;
+        LatencyStats launch;
+        int receivedAttachments = -1;
+        qint64 receivedBytes = -1;
+        int failures = 0;
+        int missingLaunches = 0;
+        QString error;
+    };
+
+    QStringList attachments(qint64 bytes, int count);
+    void runNext();
+    void handlerLaunched(const QString &argument, qint64 realtimeNsecs);
+    void finishRun(bool failed);
+    void updateRow(int row);
+    void updateStubButton();
+    void finish();
+
+    ParentWindowIdFunction m_parentWindowId;
+    StubHandler *m_stub;
+    /// Whether start() installed the stub, which the end of the run then removes again
+    bool m_stubInstalledForRun = false;
+
+    QLineEdit *m_sizes;
+    QLineEdit *m_counts;
+    QSpinBox *m_repetitions;
+    QPushButton *m_stubButton;
+    QPushButton *m_startButton;
+    QLabel *m_status;
+    QTableWidget *m_table;
+
+    std::unique_ptr<QTemporaryDir> m_directory;
+    /// Attachment size -> files generated with it so far
+    QHash<qint64, QStringList> m_files;
+
+    QList<Step> m_steps;
+    int m_currentStep = -1;
+    int m_currentRepetition = 0;
+    int m_runCounter = 0;
+    bool m_running = false;
+
+    QString m_requestPath;
+    QString m_expectedSubject;
+    QElapsedTimer m_requestClock;
+    qint64 m_sentRealtimeNsecs = 0;
+    bool m_responded = false;
+    bool m_launchSeen = false;
+    QTimer m_timeout;
+};
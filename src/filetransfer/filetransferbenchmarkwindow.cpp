@@ -0,0 +1,294 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "filetransferbenchmarkwindow.h"
+
+#include <QCheckBox>
+#include <QFile>
+#include <QFont>
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include "filetransferclient.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+enum Column {
+    BatchColumn,
+    CallsColumn,
+    StartColumn,
+    AddColumn,
+    AddRateColumn,
+    RetrieveColumn,
+    RetrieveRateColumn,
+    TotalRateColumn,
+    RetrievedColumn,
+    ColumnCount,
+};
+
+const QString receiverConnection = u"xdg-portal-test-filetransfer-receiver"_s;
+
+double filesPerSecond(qsizetype files, qint64 nsecs)
+{
+    return nsecs > 0 ? double(files) * 1e9 / double(nsecs) : 0;
+}
+}
+
+FileTransferBenchmarkWindow::FileTransferBenchmarkWindow(QWidget *parent)
+    : QWidget(parent)
+    , m_receiver(QDBusConnection::connectToBus(QDBusConnection::SessionBus, receiverConnection))
+{
+    auto description = new QLabel(i18n("Registers files with the FileTransfer portal in AddFiles batches of the given sizes and retrieves them "
+                                       "from a second bus connection, the way a drop into another application does. Times are medians over "
+                                       "the repetitions."));
+    description->setWordWrap(true);
+
+    m_fileCount = new QSpinBox;
+    m_fileCount->setRange(1, 100000);
+    m_fileCount->setValue(2000);
+
+    m_batchSizes = new QLineEdit(u"1,4,16,64,256"_s);
+
+    m_repetitions = new QSpinBox;
+    m_repetitions->setRange(1, 100);
+    m_repetitions->setValue(3);
+
+    m_writable = new QCheckBox(i18n("Writable"));
+
+    m_startButton = new QPushButton(i18n("Run"));
+    connect(m_startButton, &QPushButton::clicked, this, [this] {
+        if (m_running) {
+            stop();
+        } else {
+            start();
+        }
+    });
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Files:"), m_fileCount);
+    form->addRow(i18n("Batch sizes:"), m_batchSizes);
+    form->addRow(i18n("Repetitions:"), m_repetitions);
+    form->addRow(QString(), m_writable);
+    form->addRow(QString(), m_startButton);
+
+    m_status = new QLabel;
+    m_status->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_status->setWordWrap(true);
+
+    m_table = new QTableWidget(0, ColumnCount);
+    m_table->setHorizontalHeaderLabels({i18n("Batch size"),
+                                        i18n("AddFiles calls"),
+                                        i18n("StartTransfer (ms)"),
+                                        i18n("AddFiles (ms)"),
+                                        i18n("Register (files/s)"),
+                                        i18n("RetrieveFiles (ms)"),
+                                        i18n("Retrieve (files/s)"),
+                                        i18n("Total (files/s)"),
+                                        i18n("Retrieved")});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_status);
+    layout->addWidget(m_table);
+
+    if (!m_receiver.isConnected()) {
+        m_status->setText(i18n("Couldn't open the second bus connection: %1", m_receiver.lastError().message()));
+        m_startButton->setEnabled(false);
+    }
+}
+
+FileTransferBenchmarkWindow::~FileTransferBenchmarkWindow()
+{
+    QDBusConnection::disconnectFromBus(receiverConnection);
+}
+
+QStringList FileTransferBenchmarkWindow::files(int count)
+{
+    if (m_files.size() == count) {
+        return m_files;
+    }
+
+    m_directory = std::make_unique<QTemporaryDir>();
+    m_files.clear();
+    m_files.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QString path = m_directory->filePath(u"file%1"_s.arg(i));
+        QFile file(path);
+        if (!file.open(QFile::WriteOnly)) {
+            qWarning() << "Couldn't create" << path << file.errorString();
+            break;
+        }
+        m_files.append(path);
+    }
+    return m_files;
+}
+
+void FileTransferBenchmarkWindow::start()
+{
+    m_steps.clear();
+    const QStringList sizes = m_batchSizes->text().split(u',', Qt::SkipEmptyParts);
+    for (const QString &size : sizes) {
+        bool ok = false;
+        const int batchSize = size.trimmed().toInt(&ok);
+        if (ok && batchSize > 0) {
+            Step step;
+            step.batchSize = batchSize;
+            m_steps.append(step);
+        }
+    }
+    if (m_steps.isEmpty()) {
+        return;
+    }
+
+    m_status->setText(i18n("Creating files…"));
+    if (files(m_fileCount->value()).size() != m_fileCount->value()) {
+        m_status->setText(i18n("Couldn't create the files"));
+        return;
+    }
+
+    m_table->setRowCount(m_steps.size());
+    for (int row = 0; row < m_steps.size(); ++row) {
+        updateRow(row);
+    }
+    m_currentStep = 0;
+    m_currentRepetition = 0;
+    m_running = true;
+    m_startButton->setText(i18n("Stop"));
+    // One transfer per event loop pass, so the table keeps updating
+    QTimer::singleShot(0, this, &FileTransferBenchmarkWindow::runNext);
+}
+
+void FileTransferBenchmarkWindow::stop()
+{
+    m_running = false;
+    m_currentStep = -1;
+    m_startButton->setText(i18n("Run"));
+}
+
+void FileTransferBenchmarkWindow::runNext()
+{
+    if (!m_running) {
+        return;
+    }
+    if (m_currentRepetition >= m_repetitions->value()) {
+        m_currentRepetition = 0;
+        ++m_currentStep;
+    }
+    if (m_currentStep >= m_steps.size()) {
+        finish();
+        return;
+    }
+
+    Step &step = m_steps[m_currentStep];
+    m_status->setText(i18n("Batch size %1, run %2 of %3", step.batchSize, m_currentRepetition + 1, m_repetitions->value()));
+
+    FileTransferClient sender;
+    sender.setBatchSize(step.batchSize);
+    FileTransferClient::Timing timing;
+    const QString key = sender.registerFiles(m_files, m_writable->isChecked(), &timing);
+    step.addCalls = timing.addCalls;
+    if (key.isEmpty()) {
+        step.error = sender.lastError();
+        qWarning() << "FileTransfer registration failed:" << step.error;
+        // Another repetition won't do better
+        m_currentRepetition = m_repetitions->value();
+    } else {
+        step.start.add(timing.startNsecs);
+        step.add.add(timing.addNsecs);
+
+        FileTransferClient receiver(m_receiver);
+        qint64 retrieveNsecs = 0;
+        const QStringList retrieved = receiver.retrieveFiles(key, &retrieveNsecs);
+        if (retrieved.isEmpty() && !receiver.lastError().isEmpty()) {
+            step.error = receiver.lastError();
+            qWarning() << "RetrieveFiles failed:" << step.error;
+            sender.stopTransfer(key);
+        } else {
+            step.retrieve.add(retrieveNsecs);
+            step.retrieved = retrieved.size();
+        }
+        ++m_currentRepetition;
+    }
+
+    updateRow(m_currentStep);
+    QTimer::singleShot(0, this, &FileTransferBenchmarkWindow::runNext);
+}
+
+void FileTransferBenchmarkWindow::updateRow(int row)
+{
+    const Step &step = m_steps.at(row);
+    const auto set = [this, row](int column, const QString &text) {
+        m_table->setItem(row, column, new QTableWidgetItem(text));
+    };
+    const auto median = [](const LatencyStats &stats) {
+        return stats.count() > 0 ? LatencyStats::formatMsecs(stats.percentile(0.5)) : QString();
+    };
+    const auto rate = [this](const LatencyStats &stats) {
+        return stats.count() > 0 ? QString::number(filesPerSecond(m_files.size(), stats.percentile(0.5)), 'f', 0) : QString();
+    };
+
+    set(BatchColumn, QString::number(step.batchSize));
+    set(CallsColumn, step.addCalls > 0 ? QString::number(step.addCalls) : QString());
+    set(StartColumn, median(step.start));
+    set(AddColumn, median(step.add));
+    set(AddRateColumn, rate(step.add));
+    set(RetrieveColumn, median(step.retrieve));
+    set(RetrieveRateColumn, rate(step.retrieve));
+    if (step.add.count() > 0 && step.retrieve.count() > 0) {
+        const qint64 total = step.start.percentile(0.5) + step.add.percentile(0.5) + step.retrieve.percentile(0.5);
+        set(TotalRateColumn, QString::number(filesPerSecond(m_files.size(), total), 'f', 0));
+    }
+    set(RetrievedColumn, step.error.isEmpty() ? (step.retrieved < 0 ? QString() : QString::number(step.retrieved)) : step.error);
+}
+
+void FileTransferBenchmarkWindow::finish()
+{
+    stop();
+
+    int best = -1;
+    qint64 bestNsecs = 0;
+    for (int row = 0; row < m_steps.size(); ++row) {
+        const Step &step = m_steps.at(row);
+        if (step.add.count() == 0 || step.retrieve.count() == 0) {
+            continue;
+        }
+        const qint64 total = step.start.percentile(0.5) + step.add.percentile(0.5) + step.retrieve.percentile(0.5);
+        if (best < 0 || total < bestNsecs) {
+            best = row;
+            bestNsecs = total;
+        }
+    }
+    if (best < 0) {
+        m_status->setText(i18n("No transfer succeeded"));
+        return;
+    }
+
+    for (int column = 0; column < ColumnCount; ++column) {
+        if (QTableWidgetItem *item = m_table->item(best, column)) {
+            QFont font = item->font();
+            font.setBold(true);
+            item->setFont(font);
+        }
+    }
+    m_status->setText(i18n("Fastest batch size for %1 files: %2, %3 files/s",
+                           m_files.size(),
+                           m_steps.at(best).batchSize,
+                           QString::number(filesPerSecond(m_files.size(), bestNsecs), 'f', 0)));
+}
@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusConnection>
+#include <QWidget>
+
+#include <memory>
+
+#include "benchmark/latencystats.h"
+
+class QCheckBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+class QTemporaryDir;
+
+/**
+ * Registers a set of generated files with the FileTransfer portal in AddFiles batches of
+ * various sizes and retrieves them again from a second bus connection, which the portal
+ * treats as another application.
+ *
+ * Each batch size is run a number of times and the medians are reported, as files per
+ * second for registering, retrieving and both together.
+ */
+class FileTransferBenchmarkWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit FileTransferBenchmarkWindow(QWidget *parent = nullptr);
+    ~FileTransferBenchmarkWindow() override;
+
+public Q_SLOTS:
+    void start();
+    void stop();
+
+private:
+    struct Step {
+        int batchSize = 0;
+        int addCalls = 0;
+        int retrieved = -1;
+        QString error;
+        LatencyStats start;
+        LatencyStats add;
+        LatencyStats retrieve;
+    };
+
+    QStringList files(int count);
+    void runNext();
+    void updateRow(int row);
+    void finish();
+
+    QSpinBox *m_fileCount;
+    QLineEdit *m_batchSizes;
+    QSpinBox *m_repetitions;
+    QCheckBox *m_writable;
+    QPushButton *m_startButton;
+    QLabel *m_status;
+    QTableWidget *m_table;
+
+    std::unique_ptr<QTemporaryDir> m_directory;
+    QStringList m_files;
+    QDBusConnection m_receiver;
+
+    QList<Step> m_steps;
+    int m_currentStep = -1;
+    int m_currentRepetition = 0;
+    bool m_running = false;
+};
@@ -0,0 +1,133 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "filetransferclient.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QDBusUnixFileDescriptor>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+QDBusMessage fileTransferCall(const QString &method)
+{
+    return QDBusMessage::createMethodCall(u"org.freedesktop.portal.Documents"_s,
+                                          u"/org/freedesktop/portal/documents"_s,
+                                          u"org.freedesktop.portal.FileTransfer"_s,
+                                          method);
+}
+}
+
+FileTransferClient::FileTransferClient(const QDBusConnection &connection)
+    : m_connection(connection)
+{
+}
+
+QString FileTransferClient::mimeType()
+{
+    return u"application/vnd.portal.filetransfer"_s;
+}
+
+int FileTransferClient::batchSize() const
+{
+    return m_batchSize;
+}
+
+void FileTransferClient::setBatchSize(int files)
+{
+    m_batchSize = qMax(1, files);
+}
+
+QString FileTransferClient::registerFiles(const QStringList &paths, bool writable, Timing *timing)
+{
+    qDBusRegisterMetaType<QList<QDBusUnixFileDescriptor>>();
+    Timing local;
+    Timing &t = timing ? *timing : local;
+    t = {};
+
+    QElapsedTimer timer;
+    timer.start();
+    QDBusMessage start = fileTransferCall(u"StartTransfer"_s);
+    start << QVariantMap{{u"writable"_s, writable}, {u"autostop"_s, true}};
+    const QDBusMessage reply = m_connection.call(start);
+    t.startNsecs = timer.nsecsElapsed();
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        m_lastError = reply.errorMessage();
+        return {};
+    }
+    const QString key = reply.arguments().constFirst().toString();
+
+    timer.restart();
+    for (qsizetype first = 0; first < paths.size(); first += m_batchSize) {
+        QList<QDBusUnixFileDescriptor> fds;
+        for (qsizetype i = first; i < qMin(paths.size(), first + m_batchSize); ++i) {
+            const int fd = ::open(QFile::encodeName(paths.at(i)).constData(), O_PATH | O_CLOEXEC);
+            if (fd < 0) {
+                qWarning() << "Couldn't open" << paths.at(i) << "for transfer";
+                continue;
+            }
+            // QDBusUnixFileDescriptor keeps a duplicate
+            fds.append(QDBusUnixFileDescriptor(fd));
+            ::close(fd);
+        }
+
+        QDBusMessage add = fileTransferCall(u"AddFiles"_s);
+        add << key << QVariant::fromValue(fds) << QVariantMap();
+        const QDBusMessage addReply = m_connection.call(add);
+        ++t.addCalls;
+        if (addReply.type() != QDBusMessage::ReplyMessage) {
+            m_lastError = addReply.errorMessage();
+            stopTransfer(key);
+            return {};
+        }
+    }
+    t.addNsecs = timer.nsecsElapsed();
+    return key;
+}
+
+QStringList FileTransferClient::retrieveFiles(const QString &key, qint64 *nsecs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QDBusMessage retrieve = fileTransferCall(u"RetrieveFiles"_s);
+    retrieve << key << QVariantMap();
+    const QDBusMessage reply = m_connection.call(retrieve);
+    if (nsecs) {
+        *nsecs = timer.nsecsElapsed();
+    }
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        m_lastError = reply.errorMessage();
+        return {};
+    }
+    return reply.arguments().constFirst().toStringList();
+}
+
+QDBusPendingReply<QStringList> FileTransferClient::retrieveFilesAsync(const QString &key)
+{
+    QDBusMessage retrieve = fileTransferCall(u"RetrieveFiles"_s);
+    retrieve << key << QVariantMap();
+    return m_connection.asyncCall(retrieve);
+}
+
+void FileTransferClient::stopTransfer(const QString &key)
+{
+    QDBusMessage stop = fileTransferCall(u"StopTransfer"_s);
+    stop << key;
+    m_connection.asyncCall(stop);
+}
+
+QString FileTransferClient::lastError() const
+{
+    return m_lastError;
+}
@@ -0,0 +1,54 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusConnection>
+#include <QDBusPendingReply>
+#include <QStringList>
+
+/**
+ * Minimal client for org.freedesktop.portal.FileTransfer, the document portal interface
+ * sandboxed applications use to hand files to each other through drag and drop or the
+ * clipboard. Calls are blocking and timed, as a drag needs its key before it can start;
+ * the receiving side can retrieve asynchronously instead, e.g. from the GUI thread.
+ *
+ * The portal tells transfers apart by the sender, so a client on a second connection can
+ * stand in for the receiving application.
+ */
+class FileTransferClient
+{
+public:
+    explicit FileTransferClient(const QDBusConnection &connection = QDBusConnection::sessionBus());
+
+    struct Timing {
+        qint64 startNsecs = -1;
+        qint64 addNsecs = -1;
+        int addCalls = 0;
+    };
+
+    /// The format that carries the transfer key in drag and clipboard data
+    static QString mimeType();
+
+    /// Files per AddFiles call, as GLib sends them
+    static constexpr int defaultBatchSize = 16;
+
+    int batchSize() const;
+    void setBatchSize(int files);
+
+    /// Starts a transfer of @p paths and returns its key, or an empty string on failure
+    QString registerFiles(const QStringList &paths, bool writable, Timing *timing = nullptr);
+    /// Paths the receiving side may access for @p key
+    QStringList retrieveFiles(const QString &key, qint64 *nsecs = nullptr);
+    QDBusPendingReply<QStringList> retrieveFilesAsync(const QString &key);
+    void stopTransfer(const QString &key);
+
+    QString lastError() const;
+
+private:
+    QDBusConnection m_connection;
+    int m_batchSize = defaultBatchSize;
+    QString m_lastError;
+};
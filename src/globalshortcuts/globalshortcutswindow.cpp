@@ -0,0 +1,416 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "globalshortcutswindow.h"
+
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QFontDatabase>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableView>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include <ctime>
+#include <memory>
+
+#include <globalshortcuts_portal_interface.h>
+#include <portalsrequest_interface.h>
+
+#include "mockshortcutsbackend.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+enum BulkColumn {
+    CountColumn,
+    BindCallColumn,
+    BindResponseColumn,
+    ListCallColumn,
+    ListResponseColumn,
+    ApplyColumn,
+    BulkColumnCount,
+};
+}
+
+GlobalShortcutsWindow::GlobalShortcutsWindow(OrgFreedesktopPortalGlobalShortcutsInterface *portal,
+                                             const ParentWindowIdFunction &parentWindowId,
+                                             QWidget *parent)
+    : QWidget(parent)
+    , m_portal(portal)
+    , m_parentWindowId(parentWindowId)
+    , m_model(new ShortcutsModel(this))
+    , m_mock(new MockShortcutsBackend(this))
+{
+    auto description = new QLabel(i18n("Delivery delay is the local CLOCK_MONOTONIC receive time minus the backend timestamp of Activated, "
+                                       "read as CLOCK_MONOTONIC milliseconds; hold time is the monotonic time between Activated and Deactivated of the same shortcut."));
+    description->setWordWrap(true);
+
+    m_mockRate = new QSpinBox;
+    m_mockRate->setRange(1, 5000);
+    m_mockRate->setValue(50);
+    m_mockRate->setSuffix(i18n(" /s"));
+
+    m_mockHold = new QSpinBox;
+    m_mockHold->setRange(0, 10000);
+    m_mockHold->setValue(20);
+    m_mockHold->setSuffix(i18n(" ms"));
+
+    m_mockLoad = new QSpinBox;
+    m_mockLoad->setRange(0, 100000);
+    m_mockLoad->setValue(0);
+    m_mockLoad->setSuffix(i18n(" signals/s"));
+
+    m_mockButton = new QPushButton(i18n("Start mock backend"));
+    connect(m_mockButton, &QPushButton::clicked, this, &GlobalShortcutsWindow::toggleMock);
+    auto resetButton = new QPushButton(i18n("Reset statistics"));
+    connect(resetButton, &QPushButton::clicked, this, &GlobalShortcutsWindow::resetStatistics);
+
+    auto buttons = new QHBoxLayout;
+    buttons->addWidget(m_mockButton);
+    buttons->addWidget(resetButton);
+    buttons->addStretch();
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Mock activations:"), m_mockRate);
+    form->addRow(i18n("Mock hold time:"), m_mockHold);
+    form->addRow(i18n("Bus load (4 KiB signals):"), m_mockLoad);
+    form->addRow(buttons);
+
+    const QFont fixedFont = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    m_summary = new QLabel;
+    m_summary->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_deliveryLabel = new QLabel;
+    m_deliveryLabel->setFont(fixedFont);
+    m_holdLabel = new QLabel;
+    m_holdLabel->setFont(fixedFont);
+
+    auto histograms = new QHBoxLayout;
+    auto deliveryLayout = new QVBoxLayout;
+    deliveryLayout->addWidget(new QLabel(i18n("Delivery delay:")));
+    deliveryLayout->addWidget(m_deliveryLabel);
+    deliveryLayout->addStretch();
+    auto holdLayout = new QVBoxLayout;
+    holdLayout->addWidget(new QLabel(i18n("Press to release:")));
+    holdLayout->addWidget(m_holdLabel);
+    holdLayout->addStretch();
+    histograms->addLayout(deliveryLayout);
+    histograms->addLayout(holdLayout);
+
+    m_bulkSizes = new QLineEdit(u"1,10,100,250,500,1000,2000,5000"_s);
+    m_bulkButton = new QPushButton(i18n("Bind in bulk"));
+    m_bulkButton->setEnabled(false);
+    connect(m_bulkButton, &QPushButton::clicked, this, &GlobalShortcutsWindow::startBulk);
+    auto bulkLayout = new QHBoxLayout;
+    bulkLayout->addWidget(new QLabel(i18n("Shortcut counts:")));
+    bulkLayout->addWidget(m_bulkSizes);
+    bulkLayout->addWidget(m_bulkButton);
+
+    m_bulkTable = new QTableWidget(0, BulkColumnCount);
+    m_bulkTable->setHorizontalHeaderLabels({i18n("Shortcuts"),
+                                            i18n("BindShortcuts call (ms)"),
+                                            i18n("Bind response (ms)"),
+                                            i18n("ListShortcuts call (ms)"),
+                                            i18n("List response (ms)"),
+                                            i18n("Apply (ms)")});
+    m_bulkTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_bulkTable->horizontalHeader()->setStretchLastSection(true);
+
+    m_modelLabel = new QLabel;
+    auto modelView = new QTableView;
+    modelView->setModel(m_model);
+    modelView->horizontalHeader()->setStretchLastSection(true);
+    // Thousands of rows, don't measure every one of them
+    modelView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_summary);
+    layout->addLayout(histograms);
+    layout->addLayout(bulkLayout);
+    layout->addWidget(m_bulkTable);
+    layout->addWidget(m_modelLabel);
+    layout->addWidget(modelView);
+
+    // Subscribed by hand rather than through the generated signal, which would demarshal into a QList<QPair<QString, QVariantMap>> first
+    QDBusConnection::sessionBus().connect(desktopPortalService(),
+                                          desktopPortalPath(),
+                                          u"org.freedesktop.portal.GlobalShortcuts"_s,
+                                          u"ShortcutsChanged"_s,
+                                          this,
+                                          SLOT(shortcutsChanged(QDBusMessage)));
+
+    QDBusConnection::sessionBus().connect(m_mock->service(),
+                                          MockShortcutsBackend::objectPath(),
+                                          u"org.freedesktop.portal.GlobalShortcuts"_s,
+                                          u"Activated"_s,
+                                          this,
+                                          SLOT(activated(QDBusObjectPath,QString,qulonglong,QVariantMap)));
+    QDBusConnection::sessionBus().connect(m_mock->service(),
+                                          MockShortcutsBackend::objectPath(),
+                                          u"org.freedesktop.portal.GlobalShortcuts"_s,
+                                          u"Deactivated"_s,
+                                          this,
+                                          SLOT(deactivated(QDBusObjectPath,QString,qulonglong,QVariantMap)));
+
+    // Repainting per signal would itself delay delivery at high rates
+    m_refreshTimer.setInterval(250);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &GlobalShortcutsWindow::refresh);
+    m_refreshTimer.start();
+
+    m_clock.start();
+    m_dirty = true;
+    refresh();
+}
+
+void GlobalShortcutsWindow::setSession(const QDBusObjectPath &session)
+{
+    m_session = session;
+    m_bulkButton->setEnabled(!session.path().isEmpty());
+}
+
+ShortcutsModel *GlobalShortcutsWindow::model() const
+{
+    return m_model;
+}
+
+Shortcuts GlobalShortcutsWindow::generateShortcuts(int count)
+{
+    Shortcuts shortcuts;
+    shortcuts.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        shortcuts.append({u"bulk%1"_s.arg(i), {{u"description"_s, u"Bulk shortcut %1"_s.arg(i)}}});
+    }
+    return shortcuts;
+}
+
+qint64 GlobalShortcutsWindow::timestampToNsecs(qulonglong timestamp)
+{
+    return qint64(timestamp) * 1000000;
+}
+
+qint64 GlobalShortcutsWindow::monotonicNsecs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return qint64(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+void GlobalShortcutsWindow::activated(const QDBusObjectPath &session_handle, const QString &shortcut_id, qulonglong timestamp, const QVariantMap &options)
+{
+    Q_UNUSED(session_handle)
+    Q_UNUSED(options)
+
+    recordDelivery(timestamp);
+    m_pressed.insert(shortcut_id, {m_clock.nsecsElapsed(), timestampToNsecs(timestamp)});
+    m_dirty = true;
+}
+
+void GlobalShortcutsWindow::deactivated(const QDBusObjectPath &session_handle, const QString &shortcut_id, qulonglong timestamp, const QVariantMap &options)
+{
+    Q_UNUSED(session_handle)
+    Q_UNUSED(options)
+
+    const auto it = m_pressed.constFind(shortcut_id);
+    if (it == m_pressed.cend()) {
+        ++m_unmatchedReleases;
+        return;
+    }
+
+    const qint64 hold = m_clock.nsecsElapsed() - it->received;
+    m_hold.add(hold);
+    m_holdHistogram.add(hold);
+    m_backendHold.add(timestampToNsecs(timestamp) - it->backendNsecs);
+    m_pressed.erase(it);
+    m_dirty = true;
+}
+
+void GlobalShortcutsWindow::recordDelivery(qulonglong timestamp)
+{
+    const qint64 delay = monotonicNsecs() - timestampToNsecs(timestamp);
+    m_delivery.add(delay);
+    m_deliveryHistogram.add(delay);
+
+    // Interarrival jitter of RFC 3550, J += (|D| - J) / 16, with D the change in delay
+    if (m_delivery.count() > 1) {
+        m_jitter16 += qAbs(delay - m_lastDelay) - ((m_jitter16 + 8) >> 4);
+    }
+    m_lastDelay = delay;
+}
+
+void GlobalShortcutsWindow::resetStatistics()
+{
+    m_pressed.clear();
+    m_deliveryHistogram.clear();
+    m_holdHistogram.clear();
+    m_delivery.clear();
+    m_hold.clear();
+    m_backendHold.clear();
+    m_jitter16 = 0;
+    m_unmatchedReleases = 0;
+    m_dirty = true;
+    refresh();
+}
+
+void GlobalShortcutsWindow::toggleMock()
+{
+    if (m_mock->isRunning()) {
+        m_mock->stop();
+        m_mockButton->setText(i18n("Start mock backend"));
+    } else {
+        m_mock->start(m_mockRate->value(), m_mockHold->value(), m_mockLoad->value());
+        m_mockButton->setText(i18n("Stop mock backend"));
+    }
+}
+
+void GlobalShortcutsWindow::refresh()
+{
+    if (!m_dirty) {
+        return;
+    }
+    m_dirty = false;
+
+    const qint64 jitter = m_jitter16 / 16;
+    QString summary = i18n("Delivery delay: %1", m_delivery.summary()) + u'\n';
+    summary += i18n("Delivery jitter: %1 ms", LatencyStats::formatMsecs(jitter)) + u'\n';
+    summary += i18n("Press to release (local): %1", m_hold.summary()) + u'\n';
+    summary += i18n("Press to release (backend timestamps): %1", m_backendHold.summary()) + u'\n';
+    summary += i18n("Currently pressed: %1, releases without press: %2", m_pressed.size(), m_unmatchedReleases);
+    m_summary->setText(summary);
+    m_deliveryLabel->setText(m_deliveryHistogram.render());
+    m_holdLabel->setText(m_holdHistogram.render());
+}
+
+void GlobalShortcutsWindow::shortcutsChanged(const QDBusMessage &message)
+{
+    const QList<QVariant> arguments = message.arguments();
+    if (arguments.size() != 2 || arguments.at(0).value<QDBusObjectPath>() != m_session) {
+        return;
+    }
+    if (!PortalDecoders::decodeShortcuts(arguments.at(1).value<QDBusArgument>(), m_decoded)) {
+        qWarning() << "Unexpected ShortcutsChanged signature" << message.signature();
+        return;
+    }
+    m_model->apply(m_decoded);
+    m_modelLabel->setText(i18n("Bound shortcuts: %1", m_model->rowCount()));
+}
+
+void GlobalShortcutsWindow::startBulk()
+{
+    m_bulkQueue.clear();
+    const QStringList sizes = m_bulkSizes->text().split(u',', Qt::SkipEmptyParts);
+    for (const QString &size : sizes) {
+        bool ok = false;
+        const int count = size.trimmed().toInt(&ok);
+        if (ok && count > 0) {
+            m_bulkQueue.append(count);
+        }
+    }
+    if (m_bulkQueue.isEmpty()) {
+        return;
+    }
+
+    m_bulkTable->setRowCount(0);
+    m_bulkButton->setEnabled(false);
+    bulkBind();
+}
+
+void GlobalShortcutsWindow::request(const QString &token,
+                                    const std::function<QDBusPendingCall()> &call,
+                                    const std::function<void(qint64, qint64, uint, const QVariantMap &)> &onDone)
+{
+    // Subscribe before calling, a non-interactive request can answer before its method return is processed
+    auto req = new OrgFreedesktopPortalRequestInterface(desktopPortalService(), portalRequestPath(token), QDBusConnection::sessionBus(), this);
+    const qint64 start = m_clock.nsecsElapsed();
+    auto callNsecs = std::make_shared<qint64>(-1);
+
+    connect(req, &OrgFreedesktopPortalRequestInterface::Response, this, [this, req, start, callNsecs, onDone](uint code, const QVariantMap &results) {
+        req->deleteLater();
+        onDone(*callNsecs, m_clock.nsecsElapsed() - start, code, results);
+    });
+
+    auto watcher = new QDBusPendingCallWatcher(call(), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, req, start, callNsecs, onDone](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        *callNsecs = m_clock.nsecsElapsed() - start;
+        if (watcher->isError()) {
+            qWarning() << "GlobalShortcuts call failed:" << watcher->error().message();
+            req->deleteLater();
+            onDone(*callNsecs, -1, 2, {});
+        }
+    });
+}
+
+void GlobalShortcutsWindow::bulkBind()
+{
+    if (m_bulkQueue.isEmpty()) {
+        m_bulkButton->setEnabled(true);
+        return;
+    }
+
+    m_bulkCount = m_bulkQueue.takeFirst();
+    m_bulkRow = m_bulkTable->rowCount();
+    m_bulkTable->insertRow(m_bulkRow);
+    m_bulkTable->setItem(m_bulkRow, CountColumn, new QTableWidgetItem(QString::number(m_bulkCount)));
+
+    const Shortcuts shortcuts = generateShortcuts(m_bulkCount);
+    const QString token = nextRequestToken();
+    request(token, [this, shortcuts, token] {
+        return m_portal->BindShortcuts(m_session, shortcuts, m_parentWindowId(), {{u"handle_token"_s, token}});
+    }, [this](qint64 callNsecs, qint64 responseNsecs, uint code, const QVariantMap &results) {
+        m_bulkTable->setItem(m_bulkRow, BindCallColumn, new QTableWidgetItem(LatencyStats::formatMsecs(callNsecs)));
+        m_bulkTable->setItem(m_bulkRow, BindResponseColumn, new QTableWidgetItem(responseNsecs < 0 ? i18n("failed") : LatencyStats::formatMsecs(responseNsecs)));
+        if (code != 0) {
+            qWarning() << "BindShortcuts of" << m_bulkCount << "shortcuts failed:" << code;
+            bulkBind();
+            return;
+        }
+        bulkResult(results);
+        bulkList();
+    });
+}
+
+void GlobalShortcutsWindow::bulkList()
+{
+    const QString token = nextRequestToken();
+    request(token, [this, token] {
+        return m_portal->ListShortcuts(m_session, {{u"handle_token"_s, token}});
+    }, [this](qint64 callNsecs, qint64 responseNsecs, uint code, const QVariantMap &results) {
+        m_bulkTable->setItem(m_bulkRow, ListCallColumn, new QTableWidgetItem(LatencyStats::formatMsecs(callNsecs)));
+        m_bulkTable->setItem(m_bulkRow, ListResponseColumn, new QTableWidgetItem(responseNsecs < 0 ? i18n("failed") : LatencyStats::formatMsecs(responseNsecs)));
+        if (code == 0) {
+            const qint64 start = m_clock.nsecsElapsed();
+            bulkResult(results);
+            m_bulkTable->setItem(m_bulkRow, ApplyColumn, new QTableWidgetItem(LatencyStats::formatMsecs(m_clock.nsecsElapsed() - start)));
+        }
+        bulkBind();
+    });
+}
+
+void GlobalShortcutsWindow::bulkResult(const QVariantMap &results)
+{
+    const auto it = results.constFind(u"shortcuts"_s);
+    if (it == results.cend()) {
+        return;
+    }
+    if (!PortalDecoders::decodeShortcuts(it->value<QDBusArgument>(), m_decoded)) {
+        return;
+    }
+    m_model->apply(m_decoded);
+    m_modelLabel->setText(i18n("Bound shortcuts: %1", m_model->rowCount()));
+}
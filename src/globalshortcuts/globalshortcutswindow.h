@@ -0,0 +1,115 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusObjectPath>
+#include <QDBusPendingCall>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QTimer>
+#include <QWidget>
+
+#include <functional>
+
+#include "benchmark/histogram.h"
+#include "benchmark/latencystats.h"
+#include "portalcommon.h"
+#include "shortcutsmodel.h"
+
+class MockShortcutsBackend;
+class OrgFreedesktopPortalGlobalShortcutsInterface;
+class QDBusMessage;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+
+/// Delivery latency and jitter of GlobalShortcuts activations, from the portal or a mock backend
+class GlobalShortcutsWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit GlobalShortcutsWindow(OrgFreedesktopPortalGlobalShortcutsInterface *portal,
+                                   const ParentWindowIdFunction &parentWindowId,
+                                   QWidget *parent = nullptr);
+
+    void setSession(const QDBusObjectPath &session);
+    ShortcutsModel *model() const;
+    /// Generated shortcuts bulk0 … bulk<count - 1>
+    static Shortcuts generateShortcuts(int count);
+
+    /// Converts an Activated/Deactivated timestamp, CLOCK_MONOTONIC milliseconds as compositors stamp input, to nanoseconds
+    static qint64 timestampToNsecs(qulonglong timestamp);
+    /// CLOCK_MONOTONIC in nanoseconds, the clock the timestamps are compared against
+    static qint64 monotonicNsecs();
+
+public Q_SLOTS:
+    void activated(const QDBusObjectPath &session_handle, const QString &shortcut_id, qulonglong timestamp, const QVariantMap &options);
+    void deactivated(const QDBusObjectPath &session_handle, const QString &shortcut_id, qulonglong timestamp, const QVariantMap &options);
+    void resetStatistics();
+    void startBulk();
+
+private Q_SLOTS:
+    void shortcutsChanged(const QDBusMessage &message);
+
+private:
+    struct Press {
+        qint64 received = 0;
+        qint64 backendNsecs = 0;
+    };
+
+    void bulkBind();
+    void bulkList();
+    void bulkResult(const QVariantMap &results);
+    /// Issues @p call and reports the method return and Response times of the request behind @p token
+    void request(const QString &token,
+                 const std::function<QDBusPendingCall()> &call,
+                 const std::function<void(qint64 callNsecs, qint64 responseNsecs, uint code, const QVariantMap &results)> &onDone);
+    void recordDelivery(qulonglong timestamp);
+    void toggleMock();
+    void refresh();
+
+    OrgFreedesktopPortalGlobalShortcutsInterface *const m_portal;
+    ParentWindowIdFunction m_parentWindowId;
+    QDBusObjectPath m_session;
+    ShortcutsModel *const m_model;
+
+    MockShortcutsBackend *m_mock;
+    QSpinBox *m_mockRate;
+    QSpinBox *m_mockHold;
+    QSpinBox *m_mockLoad;
+    QPushButton *m_mockButton;
+    QLabel *m_summary;
+    QLabel *m_deliveryLabel;
+    QLabel *m_holdLabel;
+    QLineEdit *m_bulkSizes;
+    QPushButton *m_bulkButton;
+    QTableWidget *m_bulkTable;
+    QLabel *m_modelLabel;
+
+    QElapsedTimer m_clock;
+    QTimer m_refreshTimer;
+    bool m_dirty = false;
+
+    QHash<QString, Press> m_pressed;
+    Histogram m_deliveryHistogram;
+    Histogram m_holdHistogram;
+    LatencyStats m_delivery;
+    LatencyStats m_hold;
+    LatencyStats m_backendHold;
+    qint64 m_lastDelay = 0;
+    /// Delivery jitter estimate scaled by 16 as in RFC 3550, to keep integer precision
+    qint64 m_jitter16 = 0;
+    qint64 m_unmatchedReleases = 0;
+
+    /// Reused by every decode so large lists don't reallocate per response
+    QList<PortalDecoders::Shortcut> m_decoded;
+    QList<int> m_bulkQueue;
+    int m_bulkCount = 0;
+    int m_bulkRow = -1;
+};
@@ -0,0 +1,93 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "mockshortcutsbackend.h"
+
+#include <QDBusMessage>
+#include <QDBusObjectPath>
+
+#include <ctime>
+
+using namespace Qt::StringLiterals;
+
+static const auto mockConnectionName = u"xdg-portal-test-kde-mock-shortcuts"_s;
+
+MockShortcutsBackend::MockShortcutsBackend(QObject *parent)
+    : QObject(parent)
+    , m_connection(QDBusConnection::connectToBus(QDBusConnection::SessionBus, mockConnectionName))
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(1);
+    connect(&m_timer, &QTimer::timeout, this, &MockShortcutsBackend::tick);
+}
+
+MockShortcutsBackend::~MockShortcutsBackend()
+{
+    QDBusConnection::disconnectFromBus(mockConnectionName);
+}
+
+QString MockShortcutsBackend::service() const
+{
+    return m_connection.baseService();
+}
+
+QString MockShortcutsBackend::objectPath()
+{
+    return u"/org/kde/XdgPortalTest/MockGlobalShortcuts"_s;
+}
+
+void MockShortcutsBackend::start(int activationsPerSecond, int holdMsecs, int loadSignalsPerSecond)
+{
+    m_rate = activationsPerSecond;
+    m_holdMsecs = holdMsecs;
+    m_loadRate = loadSignalsPerSecond;
+    m_activations = 0;
+    m_loadSignals = 0;
+    m_loadPayload = QByteArray(4096, 'x');
+    m_clock.start();
+    m_timer.start();
+}
+
+void MockShortcutsBackend::stop()
+{
+    m_timer.stop();
+}
+
+bool MockShortcutsBackend::isRunning() const
+{
+    return m_timer.isActive();
+}
+
+void MockShortcutsBackend::tick()
+{
+    // Emit whatever is owed by now, so rates above the timer resolution still hold
+    const double elapsed = m_clock.nsecsElapsed() / 1e9;
+
+    for (const qint64 owed = qint64(elapsed * m_rate); m_activations < owed; ++m_activations) {
+        const QString shortcutId = u"mock%1"_s.arg(m_activations % 16);
+        emitShortcutSignal(u"Activated"_s, shortcutId);
+        QTimer::singleShot(m_holdMsecs, Qt::PreciseTimer, this, [this, shortcutId] {
+            emitShortcutSignal(u"Deactivated"_s, shortcutId);
+        });
+    }
+
+    for (const qint64 owed = qint64(elapsed * m_loadRate); m_loadSignals < owed; ++m_loadSignals) {
+        QDBusMessage message = QDBusMessage::createSignal(objectPath(), u"org.kde.XdgPortalTest.Load"_s, u"Filler"_s);
+        message << m_loadPayload;
+        m_connection.send(message);
+    }
+}
+
+void MockShortcutsBackend::emitShortcutSignal(const QString &name, const QString &shortcutId)
+{
+    QDBusMessage message = QDBusMessage::createSignal(objectPath(), u"org.freedesktop.portal.GlobalShortcuts"_s, name);
+    // CLOCK_MONOTONIC milliseconds, like a compositor stamps a key press
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const qulonglong timestamp = qulonglong(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+    message << QVariant::fromValue(QDBusObjectPath(u"/org/freedesktop/portal/desktop/session/mock/shortcuts"_s)) << shortcutId << timestamp
+            << QVariantMap{};
+    m_connection.send(message);
+}
@@ -0,0 +1,47 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusConnection>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+/**
+ * Emits synthetic GlobalShortcuts Activated/Deactivated signals from a separate bus connection,
+ * so they travel through the bus daemon like those of a real backend. Optionally floods the bus
+ * with filler signals to create load.
+ */
+class MockShortcutsBackend : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MockShortcutsBackend(QObject *parent = nullptr);
+    ~MockShortcutsBackend() override;
+
+    /// Unique name of the connection the signals are sent from
+    QString service() const;
+    static QString objectPath();
+
+    void start(int activationsPerSecond, int holdMsecs, int loadSignalsPerSecond);
+    void stop();
+    bool isRunning() const;
+
+private:
+    void tick();
+    void emitShortcutSignal(const QString &name, const QString &shortcutId);
+
+    QDBusConnection m_connection;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    int m_rate = 0;
+    int m_holdMsecs = 0;
+    int m_loadRate = 0;
+    qint64 m_activations = 0;
+    qint64 m_loadSignals = 0;
+    QByteArray m_loadPayload;
+};
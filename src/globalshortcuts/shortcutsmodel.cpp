@@ -0,0 +1,120 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "shortcutsmodel.h"
+
+#include <QSet>
+
+#include <KLocalizedString>
+
+int ShortcutsModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_shortcuts.size();
+}
+
+int ShortcutsModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ShortcutsModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid) || role != Qt::DisplayRole) {
+        return {};
+    }
+
+    const PortalDecoders::Shortcut &shortcut = m_shortcuts.at(index.row());
+    switch (index.column()) {
+    case IdColumn:
+        return shortcut.id;
+    case DescriptionColumn:
+        return shortcut.description;
+    case TriggerColumn:
+        return shortcut.triggerDescription;
+    }
+    return {};
+}
+
+QVariant ShortcutsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return {};
+    }
+
+    switch (section) {
+    case IdColumn:
+        return i18n("Id");
+    case DescriptionColumn:
+        return i18n("Description");
+    case TriggerColumn:
+        return i18n("Trigger");
+    }
+    return {};
+}
+
+ShortcutsModel::Changes ShortcutsModel::apply(const QList<PortalDecoders::Shortcut> &shortcuts)
+{
+    Changes changes;
+    QSet<QString> seen;
+    seen.reserve(shortcuts.size());
+    QList<PortalDecoders::Shortcut> added;
+
+    for (const auto &shortcut : shortcuts) {
+        seen.insert(shortcut.id);
+
+        const auto it = m_rows.constFind(shortcut.id);
+        if (it == m_rows.cend()) {
+            added.append(shortcut);
+            continue;
+        }
+
+        PortalDecoders::Shortcut &existing = m_shortcuts[it.value()];
+        if (existing.description != shortcut.description || existing.triggerDescription != shortcut.triggerDescription) {
+            existing = shortcut;
+            Q_EMIT dataChanged(index(it.value(), DescriptionColumn), index(it.value(), TriggerColumn));
+            ++changes.changed;
+        }
+    }
+
+    // Remove back to front so that contiguous runs go out in a single step
+    int firstRemoved = m_shortcuts.size();
+    for (int row = m_shortcuts.size() - 1; row >= 0; --row) {
+        if (seen.contains(m_shortcuts.at(row).id)) {
+            continue;
+        }
+        int first = row;
+        while (first > 0 && !seen.contains(m_shortcuts.at(first - 1).id)) {
+            --first;
+        }
+        beginRemoveRows({}, first, row);
+        for (int i = first; i <= row; ++i) {
+            m_rows.remove(m_shortcuts.at(i).id);
+        }
+        m_shortcuts.remove(first, row - first + 1);
+        endRemoveRows();
+        changes.removed += row - first + 1;
+        firstRemoved = first;
+        row = first;
+    }
+    reindex(firstRemoved);
+
+    if (!added.isEmpty()) {
+        const int first = m_shortcuts.size();
+        beginInsertRows({}, first, first + added.size() - 1);
+        m_shortcuts.append(added);
+        reindex(first);
+        endInsertRows();
+        changes.added = added.size();
+    }
+
+    return changes;
+}
+
+void ShortcutsModel::reindex(int from)
+{
+    for (int row = from; row < m_shortcuts.size(); ++row) {
+        m_rows.insert(m_shortcuts.at(row).id, row);
+    }
+}
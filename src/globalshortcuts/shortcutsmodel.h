@@ -0,0 +1,51 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QPair>
+#include <QVariantMap>
+
+#include "portaldecoders.h"
+
+/// a(sa{sv})
+using Shortcuts = QList<QPair<QString, QVariantMap>>;
+
+/// Bound shortcuts indexed by id, updated with minimal row changes from full ListShortcuts/ShortcutsChanged lists
+class ShortcutsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        IdColumn,
+        DescriptionColumn,
+        TriggerColumn,
+        ColumnCount,
+    };
+
+    using QAbstractTableModel::QAbstractTableModel;
+
+    int rowCount(const QModelIndex &parent = {}) const override;
+    int columnCount(const QModelIndex &parent = {}) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    struct Changes {
+        int added = 0;
+        int changed = 0;
+        int removed = 0;
+    };
+    /// Makes the model match @p shortcuts, only touching rows that differ
+    Changes apply(const QList<PortalDecoders::Shortcut> &shortcuts);
+
+private:
+    void reindex(int from);
+
+    QList<PortalDecoders::Shortcut> m_shortcuts;
+    QHash<QString, int> m_rows;
+};
@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "iconcache.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QIcon>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+
+using namespace Qt::StringLiterals;
+
+IconCache &IconCache::instance()
+{
+    static IconCache cache;
+    return cache;
+}
+
+QByteArray IconCache::themedIcon(const QString &name, int size)
+{
+    const QString key = u"theme:%1:%2:%3"_s.arg(QIcon::themeName(), name).arg(size);
+    if (const auto it = m_keys.constFind(key); it != m_keys.cend()) {
+        ++m_stats.hits;
+        return m_encoded.value(it.value());
+    }
+
+    ++m_stats.misses;
+    QElapsedTimer timer;
+    timer.start();
+    QBuffer buffer;
+    QIcon::fromTheme(name).pixmap(size, size).save(&buffer, "PNG");
+    m_stats.encodeNsecs += timer.nsecsElapsed();
+    return insert(key, buffer.buffer());
+}
+
+QPixmap IconCache::pixmap(const QString &key, const std::function<QPixmap()> &render)
+{
+    if (const auto it = m_pixmaps.constFind(key); it != m_pixmaps.cend()) {
+        ++m_stats.hits;
+        return it.value();
+    }
+
+    ++m_stats.misses;
+    QElapsedTimer timer;
+    timer.start();
+    const QPixmap pixmap = render();
+    m_stats.encodeNsecs += timer.nsecsElapsed();
+    m_pixmaps.insert(key, pixmap);
+    return pixmap;
+}
+
+PortalIcon IconCache::portalIcon(const QByteArray &bytes, bool asMemfd)
+{
+    if (!asMemfd) {
+        m_stats.inlineBytesSent += bytes.size();
+        return PortalIcon::fromBytes(bytes);
+    }
+
+    const QByteArray hash = QCryptographicHash::hash(bytes, QCryptographicHash::Sha1);
+    auto it = m_memfds.find(hash);
+    if (it == m_memfds.end()) {
+        ++m_stats.memfdsCreated;
+        it = m_memfds.insert(hash, PortalIcon::sealedMemfd(bytes));
+    } else {
+        ++m_stats.memfdsReused;
+    }
+    if (!it.value().isValid()) {
+        return PortalIcon::fromBytes(bytes);
+    }
+
+    // A duplicate of our fd would share its file offset with every other send still being read.
+    // Reopening through /proc gives each send its own open file description of the same sealed memfd.
+    const int fd = open(QByteArray("/proc/self/fd/" + QByteArray::number(it.value().fileDescriptor())).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        qWarning() << "Couldn't reopen icon memfd:" << strerror(errno);
+        return PortalIcon::fromFileDescriptor(PortalIcon::sealedMemfd(bytes));
+    }
+    QDBusUnixFileDescriptor descriptor;
+    descriptor.giveFileDescriptor(fd);
+    return PortalIcon::fromFileDescriptor(descriptor);
+}
+
+IconCache::Stats IconCache::stats() const
+{
+    return m_stats;
+}
+
+qint64 IconCache::cost() const
+{
+    qint64 cost = 0;
+    for (const QByteArray &bytes : m_encoded) {
+        cost += bytes.size();
+    }
+    for (const QPixmap &pixmap : m_pixmaps) {
+        cost += qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    }
+    return cost;
+}
+
+QString IconCache::summary() const
+{
+    return u"icon cache: %1 hits, %2 misses, %3 ms encoding, %4 KiB held, %5 inline KiB sent, %6 memfds created, %7 reused"_s
+        .arg(m_stats.hits)
+        .arg(m_stats.misses)
+        .arg(m_stats.encodeNsecs / 1e6, 0, 'f', 2)
+        .arg(cost() / 1024)
+        .arg(m_stats.inlineBytesSent / 1024)
+        .arg(m_stats.memfdsCreated)
+        .arg(m_stats.memfdsReused);
+}
+
+void IconCache::clear()
+{
+    m_keys.clear();
+    m_encoded.clear();
+    m_memfds.clear();
+    m_pixmaps.clear();
+}
+
+QByteArray IconCache::insert(const QString &key, const QByteArray &bytes)
+{
+    const QByteArray hash = QCryptographicHash::hash(bytes, QCryptographicHash::Sha1);
+    m_keys.insert(key, hash);
+    // Identical renderings under different keys share a single copy
+    auto it = m_encoded.constFind(hash);
+    if (it == m_encoded.cend()) {
+        it = m_encoded.insert(hash, bytes);
+    }
+    return it.value();
+}
@@ -0,0 +1,64 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusUnixFileDescriptor>
+#include <QHash>
+#include <QPixmap>
+
+#include <functional>
+
+#include "portalicon.h"
+
+/**
+ * Process wide cache of encoded icons, so repeated launcher and notification requests
+ * neither re-render nor re-encode the same icon.
+ *
+ * Encoded bytes are stored once per content hash; themed icons are additionally keyed by
+ * theme name and size. Sealed memfds are created once per content; every call gets its own
+ * read-only open file description of it, so concurrent readers don't share an offset.
+ */
+class IconCache
+{
+public:
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        qint64 encodeNsecs = 0;
+        qint64 inlineBytesSent = 0;
+        quint64 memfdsCreated = 0;
+        quint64 memfdsReused = 0;
+    };
+
+    static IconCache &instance();
+
+    /// PNG encoding of the themed icon @p name at @p size x @p size
+    QByteArray themedIcon(const QString &name, int size);
+    /// Pixmap rendered by @p render, computed only once per @p key
+    QPixmap pixmap(const QString &key, const std::function<QPixmap()> &render);
+
+    /// Wraps @p bytes as "bytes" icon, or as "file-descriptor" icon backed by a shared sealed memfd (Notification v2 only)
+    PortalIcon portalIcon(const QByteArray &bytes, bool asMemfd);
+
+    Stats stats() const;
+    /// Bytes currently held by the cache
+    qint64 cost() const;
+    QString summary() const;
+    void clear();
+
+private:
+    IconCache() = default;
+    QByteArray insert(const QString &key, const QByteArray &bytes);
+
+    /// theme/size/pixel key -> content hash
+    QHash<QString, QByteArray> m_keys;
+    /// content hash -> encoded bytes
+    QHash<QByteArray, QByteArray> m_encoded;
+    /// content hash -> sealed memfd
+    QHash<QByteArray, QDBusUnixFileDescriptor> m_memfds;
+    QHash<QString, QPixmap> m_pixmaps;
+    Stats m_stats;
+};
@@ -0,0 +1,366 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "inhibitmatrixwindow.h"
+
+#include <QCheckBox>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QRegularExpression>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include "inhibitstandin.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+// flags: 1 (logout) & 2 (user switch) & 4 (suspend) & 8 (idle)
+constexpr uint allFlags = 15;
+
+enum Column {
+    FlagsColumn,
+    StateColumn,
+    InhibitColumn,
+    EffectColumn,
+    CloseColumn,
+    ReleaseColumn,
+    HandleColumn,
+    ColumnCount,
+};
+}
+
+InhibitMatrixWindow::InhibitMatrixWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent)
+    : QWidget(parent)
+    , m_parentWindowId(parentWindowId)
+    , m_standIn(new InhibitStandIn(this))
+{
+    auto description = new QLabel(i18n("Holds any number of concurrent inhibitions. The time to effect is measured against a local stand-in "
+                                       "for the screensaver/session services, or against HasInhibitChanged when the real ones are running."));
+    description->setWordWrap(true);
+
+    auto flagsLayout = new QHBoxLayout;
+    for (uint flag = 1; flag <= 8; flag <<= 1) {
+        auto box = new QCheckBox(flagsToString(flag));
+        box->setChecked(flag == 8);
+        m_flagBoxes.append(box);
+        flagsLayout->addWidget(box);
+    }
+    auto inhibitButton = new QPushButton(i18n("Inhibit"));
+    connect(inhibitButton, &QPushButton::clicked, this, [this] {
+        uint flags = 0;
+        for (int i = 0; i < m_flagBoxes.size(); ++i) {
+            if (m_flagBoxes.at(i)->isChecked()) {
+                flags |= 1U << i;
+            }
+        }
+        inhibit(flags);
+    });
+    flagsLayout->addWidget(inhibitButton);
+    flagsLayout->addStretch();
+
+    auto allButton = new QPushButton(i18n("Inhibit all combinations"));
+    auto releaseButton = new QPushButton(i18n("Release all"));
+    auto clearButton = new QPushButton(i18n("Clear closed"));
+    auto standInButton = new QPushButton(i18n("Start stand-in"));
+    connect(allButton, &QPushButton::clicked, this, &InhibitMatrixWindow::inhibitAllCombinations);
+    connect(releaseButton, &QPushButton::clicked, this, &InhibitMatrixWindow::releaseAll);
+    connect(clearButton, &QPushButton::clicked, this, &InhibitMatrixWindow::clear);
+    connect(standInButton, &QPushButton::clicked, this, [this] {
+        const QStringList services = m_standIn->start();
+        m_standInLabel->setText(services.isEmpty() ? i18n("Stand-in: all services are already owned") : i18n("Stand-in: %1", services.join(u", ")));
+    });
+
+    auto buttons = new QHBoxLayout;
+    buttons->addWidget(allButton);
+    buttons->addWidget(releaseButton);
+    buttons->addWidget(clearButton);
+    buttons->addWidget(standInButton);
+    buttons->addStretch();
+
+    m_standInLabel = new QLabel(i18n("Stand-in: not running"));
+    m_report = new QLabel;
+    m_report->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    m_table = new QTableWidget(0, ColumnCount);
+    m_table->setHorizontalHeaderLabels({i18n("Flags"),
+                                        i18n("State"),
+                                        i18n("Inhibit (ms)"),
+                                        i18n("Effect (ms)"),
+                                        i18n("Close (ms)"),
+                                        i18n("Release (ms)"),
+                                        i18n("Handle")});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    connect(m_table, &QTableWidget::cellDoubleClicked, this, [this](int row) {
+        release(row);
+    });
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(flagsLayout);
+    layout->addLayout(buttons);
+    layout->addWidget(m_standInLabel);
+    layout->addWidget(m_report);
+    layout->addWidget(m_table);
+
+    connect(m_standIn, &InhibitStandIn::inhibited, this, &InhibitMatrixWindow::standInInhibited);
+    connect(m_standIn, &InhibitStandIn::released, this, &InhibitMatrixWindow::standInReleased);
+
+    QDBusConnection::sessionBus().connect(u"org.freedesktop.PowerManagement"_s,
+                                          u"/org/freedesktop/PowerManagement/Inhibit"_s,
+                                          u"org.freedesktop.PowerManagement.Inhibit"_s,
+                                          u"HasInhibitChanged"_s,
+                                          this,
+                                          SLOT(hasInhibitChanged(bool)));
+
+    m_clock.start();
+    updateReport();
+}
+
+QString InhibitMatrixWindow::flagsToString(uint flags)
+{
+    static const QStringList names = {u"logout"_s, u"user-switch"_s, u"suspend"_s, u"idle"_s};
+    QStringList set;
+    for (int i = 0; i < names.size(); ++i) {
+        if (flags & (1U << i)) {
+            set.append(names.at(i));
+        }
+    }
+    return set.isEmpty() ? u"none"_s : set.join(u'|');
+}
+
+uint InhibitMatrixWindow::reasonId(const QString &reason)
+{
+    static const QRegularExpression idPattern(u"\\[matrix #(\\d+)\\]"_s);
+    return idPattern.match(reason).captured(1).toUInt();
+}
+
+void InhibitMatrixWindow::inhibit(uint flags)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(),
+                                                          desktopPortalPath(),
+                                                          u"org.freedesktop.portal.Inhibit"_s,
+                                                          u"Inhibit"_s);
+    // The untranslated id survives into what the backend forwards, so the stand-in can tell rows apart
+    const uint id = ++m_lastId;
+    const QString reason = u"[matrix #%1] "_s.arg(id) + i18n("Inhibit matrix: %1", flagsToString(flags));
+    message << m_parentWindowId() << flags << QVariantMap{{u"reason"_s, reason}, {u"handle_token"_s, nextRequestToken()}};
+
+    const int row = m_inhibitions.size();
+    m_rowById.insert(id, row);
+    Inhibition inhibition;
+    inhibition.flags = flags;
+    inhibition.requested = m_clock.nsecsElapsed();
+    m_inhibitions.append(inhibition);
+    m_table->insertRow(row);
+    updateRow(row);
+
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, row](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<QDBusObjectPath> reply = *watcher;
+        Inhibition &inhibition = m_inhibitions[row];
+        if (reply.isError()) {
+            qWarning() << "Couldn't inhibit:" << reply.error().message();
+            inhibition.state = Failed;
+        } else {
+            inhibition.inhibitLatency = m_clock.nsecsElapsed() - inhibition.requested;
+            m_inhibitLatency.add(inhibition.inhibitLatency);
+            inhibition.handle = reply.value();
+            if (inhibition.state == Requested) {
+                inhibition.state = Active;
+            }
+        }
+        updateRow(row);
+        updateReport();
+    });
+}
+
+void InhibitMatrixWindow::inhibitAllCombinations()
+{
+    for (uint flags = 1; flags <= allFlags; ++flags) {
+        inhibit(flags);
+    }
+}
+
+void InhibitMatrixWindow::release(int row)
+{
+    Inhibition &inhibition = m_inhibitions[row];
+    if (inhibition.state != Active) {
+        return;
+    }
+
+    QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(),
+                                                          inhibition.handle.path(),
+                                                          portalRequestInterface(),
+                                                          u"Close"_s);
+    inhibition.state = Closing;
+    inhibition.closeRequested = m_clock.nsecsElapsed();
+    updateRow(row);
+
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, row](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        Inhibition &inhibition = m_inhibitions[row];
+        if (watcher->isError()) {
+            qWarning() << "Couldn't close inhibition:" << watcher->error().message();
+        }
+        inhibition.closeLatency = m_clock.nsecsElapsed() - inhibition.closeRequested;
+        m_closeLatency.add(inhibition.closeLatency);
+        inhibition.state = Closed;
+        updateRow(row);
+        updateReport();
+    });
+}
+
+void InhibitMatrixWindow::releaseAll()
+{
+    for (int row = 0; row < m_inhibitions.size(); ++row) {
+        release(row);
+    }
+}
+
+void InhibitMatrixWindow::clear()
+{
+    // Rows are referenced by index from pending replies, so only clear once nothing is in flight
+    for (const Inhibition &inhibition : std::as_const(m_inhibitions)) {
+        if (inhibition.state == Requested || inhibition.state == Active || inhibition.state == Closing) {
+            return;
+        }
+    }
+    m_inhibitions.clear();
+    m_rowById.clear();
+    m_rowByCookie.clear();
+    m_table->setRowCount(0);
+    m_inhibitLatency.clear();
+    m_effectLatency.clear();
+    m_closeLatency.clear();
+    m_releaseLatency.clear();
+    updateReport();
+}
+
+void InhibitMatrixWindow::standInInhibited(const QString &service, uint cookie, uint flags, const QString &reason)
+{
+    Q_UNUSED(service)
+    Q_UNUSED(flags)
+    // Inhibitions of other applications on the same bus are none of our business
+    const int row = m_rowById.value(reasonId(reason), -1);
+    if (row < 0) {
+        return;
+    }
+    // A backend may forward one inhibition to several services, the first one to arrive counts
+    m_rowByCookie.insert(cookie, row);
+    effectObserved(row);
+}
+
+void InhibitMatrixWindow::standInReleased(const QString &service, uint cookie, const QString &reason)
+{
+    Q_UNUSED(service)
+    Q_UNUSED(reason)
+    const auto it = m_rowByCookie.constFind(cookie);
+    if (it == m_rowByCookie.cend()) {
+        return;
+    }
+    const int row = *it;
+    m_rowByCookie.erase(it);
+    releaseObserved(row);
+}
+
+void InhibitMatrixWindow::effectObserved(int row)
+{
+    Inhibition &inhibition = m_inhibitions[row];
+    if (inhibition.effectLatency >= 0 || inhibition.state == Failed) {
+        return;
+    }
+    inhibition.effectLatency = m_clock.nsecsElapsed() - inhibition.requested;
+    m_effectLatency.add(inhibition.effectLatency);
+    updateRow(row);
+    updateReport();
+}
+
+void InhibitMatrixWindow::releaseObserved(int row)
+{
+    Inhibition &inhibition = m_inhibitions[row];
+    if (inhibition.releaseLatency >= 0 || inhibition.effectLatency < 0 || (inhibition.state != Closing && inhibition.state != Closed)) {
+        return;
+    }
+    inhibition.releaseLatency = m_clock.nsecsElapsed() - inhibition.closeRequested;
+    m_releaseLatency.add(inhibition.releaseLatency);
+    updateRow(row);
+    updateReport();
+}
+
+void InhibitMatrixWindow::hasInhibitChanged(bool hasInhibit)
+{
+    // The stand-in sees every single inhibition, HasInhibitChanged only the first and the last one,
+    // which belong to the oldest inhibition waiting for its effect and the last one that was closed
+    if (!m_standIn->services().isEmpty()) {
+        return;
+    }
+    if (hasInhibit) {
+        for (int row = 0; row < m_inhibitions.size(); ++row) {
+            if (m_inhibitions.at(row).effectLatency < 0 && m_inhibitions.at(row).state != Failed) {
+                effectObserved(row);
+                return;
+            }
+        }
+        return;
+    }
+    int lastClosed = -1;
+    for (int row = 0; row < m_inhibitions.size(); ++row) {
+        const Inhibition &inhibition = m_inhibitions.at(row);
+        if ((inhibition.state == Closing || inhibition.state == Closed) && inhibition.releaseLatency < 0
+            && (lastClosed < 0 || inhibition.closeRequested > m_inhibitions.at(lastClosed).closeRequested)) {
+            lastClosed = row;
+        }
+    }
+    if (lastClosed >= 0) {
+        releaseObserved(lastClosed);
+    }
+}
+
+void InhibitMatrixWindow::updateRow(int row)
+{
+    static const QStringList states = {i18n("Requested"), i18n("Active"), i18n("Closing"), i18n("Closed"), i18n("Failed")};
+    const Inhibition &inhibition = m_inhibitions.at(row);
+    const auto latency = [](qint64 nsecs) {
+        return nsecs < 0 ? QString() : LatencyStats::formatMsecs(nsecs);
+    };
+    // Once closed, an inhibition without effect wasn't forwarded to any service we can observe
+    const bool ended = inhibition.state == Closing || inhibition.state == Closed || inhibition.state == Failed;
+    const QString effect = inhibition.effectLatency < 0 && ended ? i18n("not forwarded") : latency(inhibition.effectLatency);
+
+    const QStringList columns = {
+        flagsToString(inhibition.flags),
+        states.at(inhibition.state),
+        latency(inhibition.inhibitLatency),
+        effect,
+        latency(inhibition.closeLatency),
+        latency(inhibition.releaseLatency),
+        inhibition.handle.path(),
+    };
+    for (int column = 0; column < ColumnCount; ++column) {
+        m_table->setItem(row, column, new QTableWidgetItem(columns.at(column)));
+    }
+}
+
+void InhibitMatrixWindow::updateReport()
+{
+    QString report = i18n("Inhibit: %1", m_inhibitLatency.summary()) + u'\n';
+    report += i18n("Time to effect: %1", m_effectLatency.summary()) + u'\n';
+    report += i18n("Close: %1", m_closeLatency.summary()) + u'\n';
+    report += i18n("Time to release: %1", m_releaseLatency.summary());
+    m_report->setText(report);
+}
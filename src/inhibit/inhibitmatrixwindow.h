@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusObjectPath>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QWidget>
+
+#include "benchmark/latencystats.h"
+#include "portalcommon.h"
+
+class InhibitStandIn;
+class QCheckBox;
+class QLabel;
+class QTableWidget;
+
+/// Holds many concurrent Inhibit requests and times how quickly they take and lose effect
+class InhibitMatrixWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit InhibitMatrixWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent = nullptr);
+
+    /// Human readable form of the Inhibit flags, e.g. "logout|idle"
+    static QString flagsToString(uint flags);
+
+public Q_SLOTS:
+    void inhibit(uint flags);
+    void inhibitAllCombinations();
+    void releaseAll();
+    void clear();
+
+private Q_SLOTS:
+    void hasInhibitChanged(bool hasInhibit);
+
+private:
+    enum State {
+        Requested,
+        Active,
+        Closing,
+        Closed,
+        Failed,
+    };
+
+    struct Inhibition {
+        uint flags = 0;
+        QDBusObjectPath handle;
+        State state = Requested;
+        qint64 requested = 0;
+        qint64 closeRequested = 0;
+        qint64 inhibitLatency = -1;
+        qint64 effectLatency = -1;
+        qint64 closeLatency = -1;
+        qint64 releaseLatency = -1;
+    };
+
+    /// Id embedded in the reason of our inhibitions, or 0 for foreign ones
+    static uint reasonId(const QString &reason);
+
+    void release(int row);
+    void standInInhibited(const QString &service, uint cookie, uint flags, const QString &reason);
+    void standInReleased(const QString &service, uint cookie, const QString &reason);
+    void effectObserved(int row);
+    void releaseObserved(int row);
+    void updateRow(int row);
+    void updateReport();
+
+    ParentWindowIdFunction m_parentWindowId;
+    InhibitStandIn *m_standIn;
+
+    QList<QCheckBox *> m_flagBoxes;
+    QLabel *m_standInLabel;
+    QLabel *m_report;
+    QTableWidget *m_table;
+
+    QElapsedTimer m_clock;
+    QList<Inhibition> m_inhibitions;
+    uint m_lastId = 0;
+    /// Reason id -> row, and stand-in cookie -> row for the releases
+    QHash<uint, int> m_rowById;
+    QHash<uint, int> m_rowByCookie;
+    LatencyStats m_inhibitLatency;
+    LatencyStats m_effectLatency;
+    LatencyStats m_closeLatency;
+    LatencyStats m_releaseLatency;
+};
@@ -0,0 +1,150 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "inhibitstandin.h"
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDebug>
+
+using namespace Qt::StringLiterals;
+
+InhibitStandIn::InhibitStandIn(QObject *parent)
+    : QObject(parent)
+{
+}
+
+InhibitStandIn::~InhibitStandIn()
+{
+    stop();
+}
+
+QStringList InhibitStandIn::start()
+{
+    if (!m_objects.isEmpty()) {
+        return m_services;
+    }
+
+    struct Service {
+        QString name;
+        QStringList paths;
+        QObject *object;
+    };
+    const QList<Service> services = {
+        {u"org.freedesktop.ScreenSaver"_s, {u"/ScreenSaver"_s, u"/org/freedesktop/ScreenSaver"_s}, new ScreenSaverStandIn(this)},
+        {u"org.kde.Solid.PowerManagement.PolicyAgent"_s, {u"/org/kde/Solid/PowerManagement/PolicyAgent"_s}, new PolicyAgentStandIn(this)},
+        {u"org.gnome.SessionManager"_s, {u"/org/gnome/SessionManager"_s}, new GnomeSessionStandIn(this)},
+    };
+
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    for (const Service &service : services) {
+        m_objects.append(service.object);
+        if (bus.interface()->isServiceRegistered(service.name)) {
+            qDebug() << "Not standing in for" << service.name << "which is already running";
+            continue;
+        }
+        for (const QString &path : service.paths) {
+            bus.registerObject(path, service.object, QDBusConnection::ExportScriptableSlots);
+        }
+        if (bus.registerService(service.name)) {
+            m_services.append(service.name);
+        } else {
+            qWarning() << "Couldn't claim" << service.name << bus.lastError().message();
+        }
+    }
+    return m_services;
+}
+
+void InhibitStandIn::stop()
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    for (const QString &service : std::as_const(m_services)) {
+        bus.unregisterService(service);
+    }
+    for (const QString &path : {u"/ScreenSaver"_s, u"/org/freedesktop/ScreenSaver"_s, u"/org/kde/Solid/PowerManagement/PolicyAgent"_s, u"/org/gnome/SessionManager"_s}) {
+        bus.unregisterObject(path);
+    }
+    qDeleteAll(m_objects);
+    m_objects.clear();
+    m_services.clear();
+    m_active.clear();
+}
+
+QStringList InhibitStandIn::services() const
+{
+    return m_services;
+}
+
+uint InhibitStandIn::addInhibition(const QString &service, uint flags, const QString &reason)
+{
+    const uint cookie = ++m_lastCookie;
+    m_active.insert(cookie, {service, reason});
+    Q_EMIT inhibited(service, cookie, flags, reason);
+    return cookie;
+}
+
+void InhibitStandIn::releaseInhibition(uint cookie)
+{
+    const auto it = m_active.constFind(cookie);
+    if (it == m_active.cend()) {
+        qWarning() << "Release of unknown inhibition cookie" << cookie;
+        return;
+    }
+    const Inhibition inhibition = *it;
+    m_active.erase(it);
+    Q_EMIT released(inhibition.service, cookie, inhibition.reason);
+}
+
+ScreenSaverStandIn::ScreenSaverStandIn(InhibitStandIn *standIn)
+    : QObject(standIn)
+    , m_standIn(standIn)
+{
+}
+
+uint ScreenSaverStandIn::Inhibit(const QString &application, const QString &reason)
+{
+    Q_UNUSED(application)
+    return m_standIn->addInhibition(u"org.freedesktop.ScreenSaver"_s, 8, reason);
+}
+
+void ScreenSaverStandIn::UnInhibit(uint cookie)
+{
+    m_standIn->releaseInhibition(cookie);
+}
+
+PolicyAgentStandIn::PolicyAgentStandIn(InhibitStandIn *standIn)
+    : QObject(standIn)
+    , m_standIn(standIn)
+{
+}
+
+uint PolicyAgentStandIn::AddInhibition(uint types, const QString &application, const QString &reason)
+{
+    Q_UNUSED(application)
+    return m_standIn->addInhibition(u"org.kde.Solid.PowerManagement.PolicyAgent"_s, types, reason);
+}
+
+void PolicyAgentStandIn::ReleaseInhibition(uint cookie)
+{
+    m_standIn->releaseInhibition(cookie);
+}
+
+GnomeSessionStandIn::GnomeSessionStandIn(InhibitStandIn *standIn)
+    : QObject(standIn)
+    , m_standIn(standIn)
+{
+}
+
+uint GnomeSessionStandIn::Inhibit(const QString &appId, uint toplevelXid, const QString &reason, uint flags)
+{
+    Q_UNUSED(appId)
+    Q_UNUSED(toplevelXid)
+    return m_standIn->addInhibition(u"org.gnome.SessionManager"_s, flags, reason);
+}
+
+void GnomeSessionStandIn::Uninhibit(uint cookie)
+{
+    m_standIn->releaseInhibition(cookie);
+}
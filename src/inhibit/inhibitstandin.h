@@ -0,0 +1,101 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+
+/**
+ * Stands in for the session services inhibit backends forward to, so the moment an
+ * inhibition really takes (or loses) effect can be timestamped.
+ *
+ * Only names that are not owned yet are claimed, so this is meant to be used on a test
+ * session bus that runs the portal and backend but no power management or screensaver.
+ */
+class InhibitStandIn : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit InhibitStandIn(QObject *parent = nullptr);
+    ~InhibitStandIn() override;
+
+    /// Claims all unowned known services; returns the claimed names
+    QStringList start();
+    void stop();
+    QStringList services() const;
+
+    uint addInhibition(const QString &service, uint flags, const QString &reason);
+    void releaseInhibition(uint cookie);
+
+Q_SIGNALS:
+    /// @p reason is the one the backend forwarded, so callers can tell their inhibitions apart
+    void inhibited(const QString &service, uint cookie, uint flags, const QString &reason);
+    void released(const QString &service, uint cookie, const QString &reason);
+
+private:
+    struct Inhibition {
+        QString service;
+        QString reason;
+    };
+
+    QStringList m_services;
+    QList<QObject *> m_objects;
+    QHash<uint, Inhibition> m_active;
+    uint m_lastCookie = 0;
+};
+
+/// org.freedesktop.ScreenSaver, used for idle inhibition
+class ScreenSaverStandIn : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.ScreenSaver")
+
+public:
+    explicit ScreenSaverStandIn(InhibitStandIn *standIn);
+
+public Q_SLOTS:
+    Q_SCRIPTABLE uint Inhibit(const QString &application, const QString &reason);
+    Q_SCRIPTABLE void UnInhibit(uint cookie);
+
+private:
+    InhibitStandIn *const m_standIn;
+};
+
+/// org.kde.Solid.PowerManagement.PolicyAgent, used by the KDE backend
+class PolicyAgentStandIn : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.Solid.PowerManagement.PolicyAgent")
+
+public:
+    explicit PolicyAgentStandIn(InhibitStandIn *standIn);
+
+public Q_SLOTS:
+    Q_SCRIPTABLE uint AddInhibition(uint types, const QString &application, const QString &reason);
+    Q_SCRIPTABLE void ReleaseInhibition(uint cookie);
+
+private:
+    InhibitStandIn *const m_standIn;
+};
+
+/// org.gnome.SessionManager, used by the GNOME and GTK backends
+class GnomeSessionStandIn : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.gnome.SessionManager")
+
+public:
+    explicit GnomeSessionStandIn(InhibitStandIn *standIn);
+
+public Q_SLOTS:
+    Q_SCRIPTABLE uint Inhibit(const QString &appId, uint toplevelXid, const QString &reason, uint flags);
+    Q_SCRIPTABLE void Uninhibit(uint cookie);
+
+private:
+    InhibitStandIn *const m_standIn;
+};
@@ -0,0 +1,375 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "geocluestandin.h"
+
+#include <QDBusMetaType>
+#include <QDateTime>
+#include <QDebug>
+
+#include <KLocalizedString>
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+const QString s_connectionName = u"geoclue-standin"_s;
+const QString s_service = u"org.freedesktop.GeoClue2"_s;
+const QString s_managerPath = u"/org/freedesktop/GeoClue2/Manager"_s;
+// GCLUE_ACCURACY_LEVEL_EXACT
+constexpr uint s_exactAccuracyLevel = 8;
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const GeoclueTimestamp &timestamp)
+{
+    argument.beginStructure();
+    argument << timestamp.seconds << timestamp.microseconds;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, GeoclueTimestamp &timestamp)
+{
+    argument.beginStructure();
+    argument >> timestamp.seconds >> timestamp.microseconds;
+    argument.endStructure();
+    return argument;
+}
+
+GeoclueStandIn::GeoclueStandIn(QObject *parent)
+    : QObject(parent)
+    , m_bus(s_connectionName)
+{
+    qDBusRegisterMetaType<GeoclueTimestamp>();
+
+    m_replayTimer.setSingleShot(true);
+    m_replayTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_replayTimer, &QTimer::timeout, this, &GeoclueStandIn::replayNext);
+}
+
+GeoclueStandIn::~GeoclueStandIn()
+{
+    stop();
+}
+
+bool GeoclueStandIn::start(const QString &busAddress, QString *error)
+{
+    const auto fail = [this, error](const QString &message) {
+        if (error) {
+            *error = message;
+        }
+        stop();
+        return false;
+    };
+
+    stop();
+    m_bus = QDBusConnection::connectToBus(busAddress, s_connectionName);
+    if (!m_bus.isConnected()) {
+        return fail(i18n("Couldn't connect to %1: %2", busAddress, m_bus.lastError().message()));
+    }
+
+    m_manager = new GeoclueManagerStandIn(this);
+    m_bus.registerObject(s_managerPath, m_manager, QDBusConnection::ExportScriptableSlots | QDBusConnection::ExportAllProperties);
+    if (!m_bus.registerService(s_service)) {
+        return fail(i18n("Couldn't claim %1: %2", s_service, m_bus.lastError().message()));
+    }
+    return true;
+}
+
+void GeoclueStandIn::stop()
+{
+    m_replayTimer.stop();
+    m_nextPoint = -1;
+
+    while (!m_clients.isEmpty()) {
+        deleteClient(m_clients.constLast()->path());
+    }
+    if (m_manager) {
+        m_bus.unregisterObject(s_managerPath);
+        delete m_manager;
+        m_manager = nullptr;
+    }
+    if (m_bus.isConnected()) {
+        m_bus.unregisterService(s_service);
+    }
+    // Also after a failed connect, or connectToBus() would hand the broken connection out again
+    QDBusConnection::disconnectFromBus(s_connectionName);
+}
+
+bool GeoclueStandIn::isRunning() const
+{
+    return m_manager != nullptr;
+}
+
+void GeoclueStandIn::setTrace(const QList<LocationTrace::Point> &trace)
+{
+    m_trace = trace;
+    m_replayTimer.stop();
+    m_nextPoint = -1;
+}
+
+void GeoclueStandIn::setSpeed(double factor)
+{
+    m_speed = qMax(0.01, factor);
+}
+
+void GeoclueStandIn::setApplyThresholds(bool apply)
+{
+    m_applyThresholds = apply;
+}
+
+bool GeoclueStandIn::applyThresholds() const
+{
+    return m_applyThresholds;
+}
+
+QDBusConnection GeoclueStandIn::bus() const
+{
+    return m_bus;
+}
+
+bool GeoclueStandIn::inUse() const
+{
+    return std::any_of(m_clients.cbegin(), m_clients.cend(), [](GeoclueClientStandIn *client) {
+        return client->active();
+    });
+}
+
+QDBusObjectPath GeoclueStandIn::createClient()
+{
+    const QDBusObjectPath path(u"/org/freedesktop/GeoClue2/Client/%1"_s.arg(++m_lastClient));
+    auto client = new GeoclueClientStandIn(this, path);
+    m_bus.registerObject(path.path(),
+                         client,
+                         QDBusConnection::ExportScriptableSlots | QDBusConnection::ExportScriptableSignals | QDBusConnection::ExportAllProperties);
+    m_clients.append(client);
+    return path;
+}
+
+void GeoclueStandIn::deleteClient(const QDBusObjectPath &path)
+{
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        if ((*it)->path() == path) {
+            GeoclueClientStandIn *client = *it;
+            m_clients.erase(it);
+            m_bus.unregisterObject(path.path());
+            delete client;
+            return;
+        }
+    }
+    qWarning() << "DeleteClient for unknown client" << path.path();
+}
+
+void GeoclueStandIn::clientStarted()
+{
+    // A finished replay starts over for the next session
+    if ((m_nextPoint >= 0 && m_nextPoint < m_trace.size()) || m_trace.isEmpty()) {
+        return;
+    }
+    m_nextPoint = 0;
+    m_replayClock.start();
+    m_replayTimer.start(0);
+}
+
+QDBusObjectPath GeoclueStandIn::createLocation(const LocationTrace::Point &point, const GeoclueTimestamp &timestamp)
+{
+    const QDBusObjectPath path(u"/org/freedesktop/GeoClue2/Location/%1"_s.arg(++m_lastLocation));
+    auto location = new GeoclueLocationStandIn(point, timestamp, this);
+    m_bus.registerObject(path.path(), location, QDBusConnection::ExportAllProperties);
+    m_locations.insert(path.path(), location);
+    return path;
+}
+
+void GeoclueStandIn::deleteLocation(const QDBusObjectPath &path)
+{
+    if (GeoclueLocationStandIn *location = m_locations.take(path.path())) {
+        m_bus.unregisterObject(path.path());
+        delete location;
+    }
+}
+
+void GeoclueStandIn::replayNext()
+{
+    if (m_nextPoint < 0 || m_nextPoint >= m_trace.size()) {
+        return;
+    }
+
+    const LocationTrace::Point &point = m_trace.at(m_nextPoint);
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const GeoclueTimestamp timestamp{quint64(now / 1000), quint64(now % 1000) * 1000};
+    for (GeoclueClientStandIn *client : std::as_const(m_clients)) {
+        client->deliver(point, timestamp);
+    }
+    Q_EMIT pointReplayed(point, now);
+
+    if (++m_nextPoint >= m_trace.size()) {
+        Q_EMIT replayFinished();
+        return;
+    }
+    // Scheduled against the start of the replay so that timer slack doesn't accumulate
+    const qint64 due = qint64(m_trace.at(m_nextPoint).offsetMsecs / m_speed) - m_replayClock.elapsed();
+    m_replayTimer.start(int(qMax<qint64>(0, due)));
+}
+
+GeoclueManagerStandIn::GeoclueManagerStandIn(GeoclueStandIn *standIn)
+    : QObject(standIn)
+    , m_standIn(standIn)
+{
+}
+
+bool GeoclueManagerStandIn::inUse() const
+{
+    return m_standIn->inUse();
+}
+
+uint GeoclueManagerStandIn::availableAccuracyLevel() const
+{
+    return s_exactAccuracyLevel;
+}
+
+QDBusObjectPath GeoclueManagerStandIn::GetClient()
+{
+    // GeoClue hands out one client per peer here; a fresh one keeps concurrent portal sessions apart
+    return m_standIn->createClient();
+}
+
+QDBusObjectPath GeoclueManagerStandIn::CreateClient()
+{
+    return m_standIn->createClient();
+}
+
+void GeoclueManagerStandIn::DeleteClient(const QDBusObjectPath &client)
+{
+    m_standIn->deleteClient(client);
+}
+
+void GeoclueManagerStandIn::AddAgent(const QString &id)
+{
+    qDebug() << "GeoClue agent" << id << "registered with the stand-in";
+}
+
+GeoclueClientStandIn::GeoclueClientStandIn(GeoclueStandIn *standIn, const QDBusObjectPath &path)
+    : QObject(standIn)
+    , m_standIn(standIn)
+    , m_path(path)
+    , m_location(u"/"_s)
+{
+}
+
+GeoclueClientStandIn::~GeoclueClientStandIn()
+{
+    m_standIn->deleteLocation(m_previousLocation);
+    m_standIn->deleteLocation(m_location);
+}
+
+QDBusObjectPath GeoclueClientStandIn::path() const
+{
+    return m_path;
+}
+
+QDBusObjectPath GeoclueClientStandIn::location() const
+{
+    return m_location;
+}
+
+uint GeoclueClientStandIn::distanceThreshold() const
+{
+    return m_distanceThreshold;
+}
+
+void GeoclueClientStandIn::setDistanceThreshold(uint meters)
+{
+    m_distanceThreshold = meters;
+}
+
+uint GeoclueClientStandIn::timeThreshold() const
+{
+    return m_timeThreshold;
+}
+
+void GeoclueClientStandIn::setTimeThreshold(uint seconds)
+{
+    m_timeThreshold = seconds;
+}
+
+QString GeoclueClientStandIn::desktopId() const
+{
+    return m_desktopId;
+}
+
+void GeoclueClientStandIn::setDesktopId(const QString &desktopId)
+{
+    m_desktopId = desktopId;
+}
+
+uint GeoclueClientStandIn::requestedAccuracyLevel() const
+{
+    return m_accuracyLevel;
+}
+
+void GeoclueClientStandIn::setRequestedAccuracyLevel(uint level)
+{
+    m_accuracyLevel = level;
+}
+
+bool GeoclueClientStandIn::active() const
+{
+    return m_active;
+}
+
+void GeoclueClientStandIn::deliver(const LocationTrace::Point &point, const GeoclueTimestamp &timestamp)
+{
+    if (!m_active) {
+        return;
+    }
+
+    // The same checks GeoClue's client does before it signals a new location
+    if (m_delivered && m_standIn->applyThresholds()) {
+        if (m_distanceThreshold > 0
+            && LocationTrace::distanceMeters(m_lastPoint.latitude, m_lastPoint.longitude, point.latitude, point.longitude) < m_distanceThreshold) {
+            return;
+        }
+        if (m_timeThreshold > 0 && timestamp.seconds - m_lastTimestamp.seconds < m_timeThreshold) {
+            return;
+        }
+    }
+
+    // Like GeoClue, the previous Location stays around so that handlers can still read it
+    m_standIn->deleteLocation(m_previousLocation);
+    m_previousLocation = m_location;
+    m_location = m_standIn->createLocation(point, timestamp);
+    m_lastPoint = point;
+    m_lastTimestamp = timestamp;
+    m_delivered = true;
+    Q_EMIT LocationUpdated(m_previousLocation, m_location);
+}
+
+void GeoclueClientStandIn::Start()
+{
+    qDebug() << "GeoClue client" << m_path.path() << "started by" << m_desktopId << "with distance threshold" << m_distanceThreshold
+             << "time threshold" << m_timeThreshold << "accuracy level" << m_accuracyLevel;
+    m_active = true;
+    m_standIn->clientStarted();
+}
+
+void GeoclueClientStandIn::Stop()
+{
+    m_active = false;
+}
+
+GeoclueLocationStandIn::GeoclueLocationStandIn(const LocationTrace::Point &point, const GeoclueTimestamp &timestamp, QObject *parent)
+    : QObject(parent)
+    , m_latitude(point.latitude)
+    , m_longitude(point.longitude)
+    , m_accuracy(point.accuracy)
+    , m_altitude(point.altitude)
+    , m_speed(point.speed)
+    , m_heading(point.heading)
+    , m_description(u"Replayed by xdg-portal-test-kde"_s)
+    , m_timestamp(timestamp)
+{
+}
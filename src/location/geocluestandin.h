@@ -0,0 +1,196 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusObjectPath>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+#include "locationtrace.h"
+
+class GeoclueClientStandIn;
+class GeoclueLocationStandIn;
+class GeoclueManagerStandIn;
+
+/// GeoClue's (tt) timestamp: seconds and microseconds since the epoch
+struct GeoclueTimestamp {
+    quint64 seconds = 0;
+    quint64 microseconds = 0;
+};
+Q_DECLARE_METATYPE(GeoclueTimestamp)
+
+QDBusArgument &operator<<(QDBusArgument &argument, const GeoclueTimestamp &timestamp);
+const QDBusArgument &operator>>(const QDBusArgument &argument, GeoclueTimestamp &timestamp);
+
+/**
+ * Replays a recorded trace as org.freedesktop.GeoClue2, for the Location portal to forward.
+ *
+ * xdg-desktop-portal reaches GeoClue on the system bus, which an application can't claim
+ * names on, so the stand-in connects to a private bus that the portal is started with as
+ * its DBUS_SYSTEM_BUS_ADDRESS. Every GetClient/CreateClient call gets a client of its own.
+ * Replay starts with the first client that is started and runs once through the trace.
+ */
+class GeoclueStandIn : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GeoclueStandIn(QObject *parent = nullptr);
+    ~GeoclueStandIn() override;
+
+    bool start(const QString &busAddress, QString *error = nullptr);
+    void stop();
+    bool isRunning() const;
+
+    void setTrace(const QList<LocationTrace::Point> &trace);
+    /// Replay speed, 2 plays the trace twice as fast as recorded
+    void setSpeed(double factor);
+    /// Whether clients drop updates below their thresholds like GeoClue does, or get every point
+    void setApplyThresholds(bool apply);
+    bool applyThresholds() const;
+
+    QDBusConnection bus() const;
+    /// Whether any client is started
+    bool inUse() const;
+    QDBusObjectPath createClient();
+    void deleteClient(const QDBusObjectPath &path);
+    /// Starts the replay if it isn't running already
+    void clientStarted();
+
+    /// Registers a new Location object for @p point and returns its path
+    QDBusObjectPath createLocation(const LocationTrace::Point &point, const GeoclueTimestamp &timestamp);
+    void deleteLocation(const QDBusObjectPath &path);
+
+Q_SIGNALS:
+    /// A trace point went out to the clients, stamped with @p timestampMsecs since the epoch
+    void pointReplayed(const LocationTrace::Point &point, qint64 timestampMsecs);
+    void replayFinished();
+
+private:
+    void replayNext();
+
+    QDBusConnection m_bus;
+    GeoclueManagerStandIn *m_manager = nullptr;
+    QList<GeoclueClientStandIn *> m_clients;
+    QHash<QString, GeoclueLocationStandIn *> m_locations;
+    quint64 m_lastClient = 0;
+    quint64 m_lastLocation = 0;
+
+    QList<LocationTrace::Point> m_trace;
+    double m_speed = 1;
+    bool m_applyThresholds = true;
+    QTimer m_replayTimer;
+    QElapsedTimer m_replayClock;
+    qsizetype m_nextPoint = -1;
+};
+
+/// org.freedesktop.GeoClue2.Manager
+class GeoclueManagerStandIn : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.GeoClue2.Manager")
+    Q_PROPERTY(bool InUse READ inUse)
+    Q_PROPERTY(uint AvailableAccuracyLevel READ availableAccuracyLevel)
+
+public:
+    explicit GeoclueManagerStandIn(GeoclueStandIn *standIn);
+
+    bool inUse() const;
+    uint availableAccuracyLevel() const;
+
+public Q_SLOTS:
+    Q_SCRIPTABLE QDBusObjectPath GetClient();
+    Q_SCRIPTABLE QDBusObjectPath CreateClient();
+    Q_SCRIPTABLE void DeleteClient(const QDBusObjectPath &client);
+    Q_SCRIPTABLE void AddAgent(const QString &id);
+
+private:
+    GeoclueStandIn *const m_standIn;
+};
+
+/// org.freedesktop.GeoClue2.Client
+class GeoclueClientStandIn : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.GeoClue2.Client")
+    Q_PROPERTY(QDBusObjectPath Location READ location)
+    Q_PROPERTY(uint DistanceThreshold READ distanceThreshold WRITE setDistanceThreshold)
+    Q_PROPERTY(uint TimeThreshold READ timeThreshold WRITE setTimeThreshold)
+    Q_PROPERTY(QString DesktopId READ desktopId WRITE setDesktopId)
+    Q_PROPERTY(uint RequestedAccuracyLevel READ requestedAccuracyLevel WRITE setRequestedAccuracyLevel)
+    Q_PROPERTY(bool Active READ active)
+
+public:
+    GeoclueClientStandIn(GeoclueStandIn *standIn, const QDBusObjectPath &path);
+    ~GeoclueClientStandIn() override;
+
+    QDBusObjectPath path() const;
+    QDBusObjectPath location() const;
+    uint distanceThreshold() const;
+    void setDistanceThreshold(uint meters);
+    uint timeThreshold() const;
+    void setTimeThreshold(uint seconds);
+    QString desktopId() const;
+    void setDesktopId(const QString &desktopId);
+    uint requestedAccuracyLevel() const;
+    void setRequestedAccuracyLevel(uint level);
+    bool active() const;
+
+    /// Sends @p point unless it is below the thresholds and the stand-in applies them
+    void deliver(const LocationTrace::Point &point, const GeoclueTimestamp &timestamp);
+
+public Q_SLOTS:
+    Q_SCRIPTABLE void Start();
+    Q_SCRIPTABLE void Stop();
+
+Q_SIGNALS:
+    Q_SCRIPTABLE void LocationUpdated(const QDBusObjectPath &old, const QDBusObjectPath &newLocation);
+
+private:
+    GeoclueStandIn *const m_standIn;
+    const QDBusObjectPath m_path;
+    QDBusObjectPath m_location;
+    QDBusObjectPath m_previousLocation;
+    LocationTrace::Point m_lastPoint;
+    GeoclueTimestamp m_lastTimestamp;
+    bool m_delivered = false;
+    bool m_active = false;
+    uint m_distanceThreshold = 0;
+    uint m_timeThreshold = 0;
+    uint m_accuracyLevel = 0;
+    QString m_desktopId;
+};
+
+/// org.freedesktop.GeoClue2.Location, one object per update as GeoClue does
+class GeoclueLocationStandIn : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.GeoClue2.Location")
+    Q_PROPERTY(double Latitude MEMBER m_latitude)
+    Q_PROPERTY(double Longitude MEMBER m_longitude)
+    Q_PROPERTY(double Accuracy MEMBER m_accuracy)
+    Q_PROPERTY(double Altitude MEMBER m_altitude)
+    Q_PROPERTY(double Speed MEMBER m_speed)
+    Q_PROPERTY(double Heading MEMBER m_heading)
+    Q_PROPERTY(QString Description MEMBER m_description)
+    Q_PROPERTY(GeoclueTimestamp Timestamp MEMBER m_timestamp)
+
+public:
+    GeoclueLocationStandIn(const LocationTrace::Point &point, const GeoclueTimestamp &timestamp, QObject *parent);
+
+private:
+    double m_latitude;
+    double m_longitude;
+    double m_accuracy;
+    double m_altitude;
+    double m_speed;
+    double m_heading;
+    QString m_description;
+    GeoclueTimestamp m_timestamp;
+};
@@ -0,0 +1,256 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "locationanalyzerwindow.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDoubleSpinBox>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QStandardPaths>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include "benchmark/processinfo.h"
+#include "geocluestandin.h"
+#include "locationmonitor.h"
+#include "locationtrace.h"
+#include "powerprofile/powerprofilewatcher.h"
+
+using namespace Qt::StringLiterals;
+
+LocationAnalyzerWindow::LocationAnalyzerWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent)
+    : QWidget(parent)
+    , m_parentWindowId(parentWindowId)
+    , m_standIn(new GeoclueStandIn(this))
+    , m_monitor(new LocationMonitor(this))
+{
+    auto description = new QLabel(i18n("Replays a trace through a GeoClue stand-in on a private bus, which xdg-desktop-portal has to be started "
+                                       "with as its system bus (see README). Delivered updates are checked against the thresholds of the session; "
+                                       "let the stand-in send every point to see whether the portal filters by itself."));
+    description->setWordWrap(true);
+
+    m_busAddress = new QLineEdit(u"unix:path=%1/fake-system-bus"_s.arg(QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation)));
+    m_traceFile = new QLineEdit(u":/data/location-trace.csv"_s);
+    auto browseButton = new QPushButton(i18n("Browse…"));
+    connect(browseButton, &QPushButton::clicked, this, [this] {
+        const QString fileName = QFileDialog::getOpenFileName(this, i18n("Open Location Trace"), QString(), i18n("CSV files (*.csv)"));
+        if (!fileName.isEmpty()) {
+            m_traceFile->setText(fileName);
+        }
+    });
+    auto traceLayout = new QHBoxLayout;
+    traceLayout->addWidget(m_traceFile);
+    traceLayout->addWidget(browseButton);
+
+    m_speed = new QDoubleSpinBox;
+    m_speed->setRange(0.1, 100);
+    m_speed->setValue(1);
+    m_speed->setSuffix(i18n("×"));
+    connect(m_speed, &QDoubleSpinBox::valueChanged, m_standIn, &GeoclueStandIn::setSpeed);
+
+    m_applyThresholds = new QCheckBox(i18n("Drop points below the client's thresholds like GeoClue"));
+    m_applyThresholds->setChecked(true);
+    connect(m_applyThresholds, &QCheckBox::toggled, m_standIn, &GeoclueStandIn::setApplyThresholds);
+
+    m_standInButton = new QPushButton(i18n("Start stand-in"));
+    connect(m_standInButton, &QPushButton::clicked, this, &LocationAnalyzerWindow::toggleStandIn);
+    m_standInLabel = new QLabel(i18n("Stand-in: not running"));
+
+    m_distanceThreshold = new QSpinBox;
+    m_distanceThreshold->setRange(0, 100000);
+    m_distanceThreshold->setValue(10);
+    m_distanceThreshold->setSuffix(i18n(" m"));
+
+    m_timeThreshold = new QSpinBox;
+    m_timeThreshold->setRange(0, 3600);
+    m_timeThreshold->setValue(5);
+    m_timeThreshold->setSuffix(i18n(" s"));
+
+    m_accuracy = new QComboBox;
+    m_accuracy->addItems({i18n("None"), i18n("Country"), i18n("City"), i18n("Neighborhood"), i18n("Street"), i18n("Exact")});
+    m_accuracy->setCurrentIndex(5);
+
+    auto sessionButton = new QPushButton(i18n("Start session"));
+    auto closeButton = new QPushButton(i18n("Close session"));
+    connect(sessionButton, &QPushButton::clicked, this, &LocationAnalyzerWindow::startSession);
+    connect(closeButton, &QPushButton::clicked, this, &LocationAnalyzerWindow::closeSession);
+    auto sessionButtons = new QHBoxLayout;
+    sessionButtons->addWidget(sessionButton);
+    sessionButtons->addWidget(closeButton);
+    sessionButtons->addStretch();
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Private system bus:"), m_busAddress);
+    form->addRow(i18n("Trace:"), traceLayout);
+    form->addRow(i18n("Replay speed:"), m_speed);
+    form->addRow(QString(), m_applyThresholds);
+    form->addRow(QString(), m_standInButton);
+    form->addRow(i18n("Distance threshold:"), m_distanceThreshold);
+    form->addRow(i18n("Time threshold:"), m_timeThreshold);
+    form->addRow(i18n("Accuracy:"), m_accuracy);
+    form->addRow(QString(), sessionButtons);
+
+    m_report = new QLabel;
+    m_report->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_report->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_standInLabel);
+    layout->addWidget(m_report, 1);
+
+    connect(m_standIn, &GeoclueStandIn::pointReplayed, this, [this](const LocationTrace::Point &point, qint64 timestampMsecs) {
+        if (m_session.path().isEmpty()) {
+            return;
+        }
+        m_analyzer.addSourcePoint(point.latitude, point.longitude, timestampMsecs);
+        scheduleReport();
+    });
+    connect(m_standIn, &GeoclueStandIn::replayFinished, this, [this] {
+        m_standInLabel->setText(i18n("Stand-in: replay finished"));
+    });
+    connect(m_monitor, &LocationMonitor::updated, this, [this] {
+        if (!m_monitor->samples().isEmpty() && m_monitor->statistics().received > m_analyzer.report().delivered) {
+            m_analyzer.addDelivered(m_monitor->samples().last().location);
+        }
+        scheduleReport();
+    });
+
+    // The report is only redrawn a few times per second, so that it doesn't add wakeups of its own per update
+    m_reportTimer.setSingleShot(true);
+    m_reportTimer.setInterval(250);
+    connect(&m_reportTimer, &QTimer::timeout, this, &LocationAnalyzerWindow::updateReport);
+
+    updateReport();
+}
+
+LocationAnalyzerWindow::~LocationAnalyzerWindow()
+{
+    closeSession();
+}
+
+void LocationAnalyzerWindow::toggleStandIn()
+{
+    if (m_standIn->isRunning()) {
+        m_standIn->stop();
+        m_standInButton->setText(i18n("Start stand-in"));
+        m_standInLabel->setText(i18n("Stand-in: not running"));
+        return;
+    }
+
+    QString error;
+    const QList<LocationTrace::Point> trace = LocationTrace::load(m_traceFile->text(), &error);
+    if (trace.isEmpty()) {
+        m_standInLabel->setText(i18n("Stand-in: couldn't load the trace: %1", error));
+        return;
+    }
+    m_standIn->setTrace(trace);
+    m_standIn->setSpeed(m_speed->value());
+    m_standIn->setApplyThresholds(m_applyThresholds->isChecked());
+    if (!m_standIn->start(m_busAddress->text(), &error)) {
+        m_standInLabel->setText(i18n("Stand-in: %1", error));
+        return;
+    }
+    m_standInButton->setText(i18n("Stop stand-in"));
+    m_standInLabel->setText(i18np("Stand-in: %1 point, waiting for the portal to start a client",
+                                  "Stand-in: %1 points, waiting for the portal to start a client",
+                                  trace.size()));
+}
+
+void LocationAnalyzerWindow::startSession()
+{
+    closeSession();
+    m_analyzer.reset(m_distanceThreshold->value(), m_timeThreshold->value());
+
+    QDBusMessage message =
+        QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), u"org.freedesktop.portal.Location"_s, u"CreateSession"_s);
+    message << QVariantMap{
+        {u"session_handle_token"_s, nextRequestToken()},
+        {u"distance-threshold"_s, uint(m_distanceThreshold->value())},
+        {u"time-threshold"_s, uint(m_timeThreshold->value())},
+        {u"accuracy"_s, uint(m_accuracy->currentIndex())},
+    };
+
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<QDBusObjectPath> reply = *watcher;
+        if (reply.isError()) {
+            qWarning() << "Couldn't create Location session:" << reply.error().message();
+            m_report->setText(reply.error().message());
+            return;
+        }
+
+        m_session = reply.value();
+        m_monitor->setSession(m_session);
+        m_portalPid = ProcessInfo::servicePid(desktopPortalService());
+        m_ownSwitches = ProcessInfo::contextSwitches(QCoreApplication::applicationPid());
+        m_portalSwitches = ProcessInfo::contextSwitches(m_portalPid);
+
+        QDBusMessage start = QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), u"org.freedesktop.portal.Location"_s, u"Start"_s);
+        start << QVariant::fromValue(m_session) << m_parentWindowId() << QVariantMap{{u"handle_token"_s, nextRequestToken()}};
+        QDBusConnection::sessionBus().asyncCall(start);
+        updateReport();
+    });
+}
+
+void LocationAnalyzerWindow::closeSession()
+{
+    if (m_session.path().isEmpty()) {
+        return;
+    }
+    closePortalSession(m_session.path());
+    m_session = {};
+    m_monitor->setSession({});
+}
+
+void LocationAnalyzerWindow::scheduleReport()
+{
+    if (!m_reportTimer.isActive()) {
+        m_reportTimer.start();
+    }
+}
+
+void LocationAnalyzerWindow::updateReport()
+{
+    if (m_session.path().isEmpty()) {
+        m_report->setText(i18n("No session"));
+        return;
+    }
+
+    QString report = i18n("Session: %1", m_session.path()) + u'\n';
+    report += m_analyzer.summary() + u'\n';
+    report += m_monitor->summary() + u'\n';
+
+    // Context switches are the closest to wakeups procfs offers; ours include the stand-in's replay timer
+    const quint64 delivered = m_analyzer.report().delivered;
+    const auto wakeups = [delivered](const QString &process, qint64 before, qint64 now) {
+        if (before < 0 || now < 0) {
+            return i18n("%1: unknown", process);
+        }
+        const qint64 switches = now - before;
+        return delivered > 0 ? i18n("%1: %2 (%3 per update)", process, switches, QString::number(double(switches) / double(delivered), 'f', 1))
+                             : i18n("%1: %2", process, switches);
+    };
+    report += i18n("Context switches since the session started, %1; %2",
+                   wakeups(i18n("this process"), m_ownSwitches, ProcessInfo::contextSwitches(QCoreApplication::applicationPid())),
+                   wakeups(i18n("xdg-desktop-portal"), m_portalSwitches, ProcessInfo::contextSwitches(m_portalPid)));
+    report += u'\n' + i18n("Power mode: %1", PowerProfileWatcher::instance().modeName());
+    m_report->setText(report);
+}
@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusObjectPath>
+#include <QTimer>
+#include <QWidget>
+
+#include "portalcommon.h"
+#include "thresholdanalyzer.h"
+
+class GeoclueStandIn;
+class LocationMonitor;
+class QCheckBox;
+class QComboBox;
+class QDoubleSpinBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+
+/**
+ * Replays a trace through the GeoClue stand-in and a Location session of its own, and reports
+ * how many updates arrive compared to what the requested thresholds allow and how many wakeups
+ * they cost.
+ */
+class LocationAnalyzerWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LocationAnalyzerWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent = nullptr);
+    ~LocationAnalyzerWindow() override;
+
+private:
+    void toggleStandIn();
+    void startSession();
+    void closeSession();
+    void scheduleReport();
+    void updateReport();
+
+    ParentWindowIdFunction m_parentWindowId;
+    GeoclueStandIn *m_standIn;
+    LocationMonitor *m_monitor;
+    ThresholdAnalyzer m_analyzer;
+
+    QLineEdit *m_busAddress;
+    QLineEdit *m_traceFile;
+    QDoubleSpinBox *m_speed;
+    QCheckBox *m_applyThresholds;
+    QPushButton *m_standInButton;
+    QLabel *m_standInLabel;
+    QSpinBox *m_distanceThreshold;
+    QSpinBox *m_timeThreshold;
+    QComboBox *m_accuracy;
+    QLabel *m_report;
+    QTimer m_reportTimer;
+
+    QDBusObjectPath m_session;
+    qint64 m_portalPid = 0;
+    /// Context switch counts when the session started, -1 if they can't be read
+    qint64 m_ownSwitches = -1;
+    qint64 m_portalSwitches = -1;
+};
@@ -0,0 +1,152 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "locationmonitor.h"
+
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+
+#include <KLocalizedString>
+
+#include "benchmark/latencystats.h"
+#include "portalcommon.h"
+
+using namespace Qt::StringLiterals;
+
+LocationMonitor::LocationMonitor(QObject *parent)
+    : QObject(parent)
+    , m_samples(capacity)
+{
+    m_clock.start();
+
+    // Connected once; the session filter takes care of updates that aren't ours
+    QDBusConnection::sessionBus().connect(desktopPortalService(),
+                                          desktopPortalPath(),
+                                          u"org.freedesktop.portal.Location"_s,
+                                          u"LocationUpdated"_s,
+                                          this,
+                                          SLOT(locationUpdated(QDBusMessage)));
+}
+
+void LocationMonitor::setSession(const QDBusObjectPath &session)
+{
+    m_session = session;
+    m_samples.clear();
+    m_statistics = {};
+    m_intervalTotal = 0;
+    m_jitter16 = 0;
+    m_lastTransit = 0;
+    Q_EMIT updated();
+}
+
+QDBusObjectPath LocationMonitor::session() const
+{
+    return m_session;
+}
+
+const RingBuffer<LocationMonitor::Sample> &LocationMonitor::samples() const
+{
+    return m_samples;
+}
+
+LocationMonitor::Statistics LocationMonitor::statistics() const
+{
+    Statistics statistics = m_statistics;
+    if (statistics.received > 1) {
+        statistics.meanInterval = m_intervalTotal / qint64(statistics.received - 1);
+    }
+    statistics.jitter = m_jitter16 / 16;
+
+    const qint64 now = m_clock.nsecsElapsed();
+    for (qsizetype i = m_samples.size() - 1; i >= 0 && now - m_samples.at(i).receivedNsecs <= 1000000000; --i) {
+        ++statistics.rate;
+    }
+    return statistics;
+}
+
+QString LocationMonitor::summary() const
+{
+    const Statistics statistics = this->statistics();
+    QString summary = i18n("Updates: %1, from other sessions: %2, buffered: %3/%4",
+                           statistics.received,
+                           statistics.ignored,
+                           m_samples.size(),
+                           m_samples.capacity())
+        + u'\n';
+    summary += i18n("Rate: %1 Hz, interval mean: %2 ms, max: %3 ms, jitter: %4 ms",
+                    statistics.rate,
+                    LatencyStats::formatMsecs(statistics.meanInterval),
+                    LatencyStats::formatMsecs(statistics.maxInterval),
+                    LatencyStats::formatMsecs(statistics.jitter));
+    return summary;
+}
+
+void LocationMonitor::locationUpdated(const QDBusMessage &message)
+{
+    const QList<QVariant> arguments = message.arguments();
+    if (arguments.size() != 2) {
+        qWarning() << "Unexpected LocationUpdated arguments" << message.signature();
+        return;
+    }
+    if (arguments.at(0).value<QDBusObjectPath>() != m_session) {
+        ++m_statistics.ignored;
+        return;
+    }
+
+    // Decoded straight into the ring buffer slot, reusing what the evicted sample had allocated
+    Sample &sample = m_samples.next();
+    if (!PortalDecoders::decodeLocation(arguments.at(1).value<QDBusArgument>(), sample.location)) {
+        m_samples.removeLast();
+        qWarning() << "Unexpected LocationUpdated arguments" << message.signature();
+        return;
+    }
+    sample.receivedNsecs = m_clock.nsecsElapsed();
+    sample.receivedMsecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+
+    if (m_statistics.received > 0 && m_samples.size() > 1) {
+        const qint64 interval = sample.receivedNsecs - m_samples.at(m_samples.size() - 2).receivedNsecs;
+        m_intervalTotal += interval;
+        m_statistics.maxInterval = qMax(m_statistics.maxInterval, interval);
+    }
+
+    // Transit time against the backend's clock; its offset cancels out in the difference between two samples
+    if (sample.location.timestampSeconds > 0) {
+        const qint64 sent = qint64(sample.location.timestampSeconds) * 1000000000 + qint64(sample.location.timestampMicroseconds) * 1000;
+        const qint64 transit = sample.receivedMsecsSinceEpoch * 1000000 - sent;
+        if (m_statistics.received > 0 && m_lastTransit != 0) {
+            m_jitter16 += qAbs(transit - m_lastTransit) - ((m_jitter16 + 8) >> 4);
+        }
+        m_lastTransit = transit;
+    }
+
+    ++m_statistics.received;
+    Q_EMIT updated();
+}
+
+bool LocationMonitor::exportCsv(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qWarning() << "Couldn't write" << fileName << file.errorString();
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "received_ms,latitude,longitude,altitude,accuracy,speed,heading,timestamp_s,timestamp_us,description\n";
+    for (qsizetype i = 0; i < m_samples.size(); ++i) {
+        const Sample &sample = m_samples.at(i);
+        const PortalDecoders::Location &location = sample.location;
+        QString description = location.description;
+        description.replace(u'"', u"\"\""_s);
+        out << sample.receivedMsecsSinceEpoch << ',' << QString::number(location.latitude, 'f', 7) << ',' << QString::number(location.longitude, 'f', 7)
+            << ',' << location.altitude << ',' << location.accuracy << ',' << location.speed << ',' << location.heading << ','
+            << location.timestampSeconds << ',' << location.timestampMicroseconds << ",\"" << description << "\"\n";
+    }
+    return out.status() == QTextStream::Ok;
+}
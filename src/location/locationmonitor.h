@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusObjectPath>
+#include <QElapsedTimer>
+#include <QObject>
+
+#include "benchmark/ringbuffer.h"
+#include "portaldecoders.h"
+
+class QDBusMessage;
+
+/**
+ * Receives LocationUpdated for one session and keeps the latest samples with running statistics.
+ *
+ * Meant to keep up with 10-50 Hz GNSS sources: samples are decoded into preallocated ring buffer
+ * slots and nothing is rendered here, the UI is expected to poll at its own pace after updated().
+ */
+class LocationMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Sample {
+        /// Monotonic receive time, in nanoseconds since the monitor was created
+        qint64 receivedNsecs = 0;
+        qint64 receivedMsecsSinceEpoch = 0;
+        PortalDecoders::Location location;
+    };
+
+    struct Statistics {
+        quint64 received = 0;
+        /// Updates for other sessions, e.g. of other windows or earlier requests
+        quint64 ignored = 0;
+        /// Updates during the last second
+        int rate = 0;
+        qint64 meanInterval = 0;
+        qint64 maxInterval = 0;
+        /// RFC 3550 interarrival jitter against the backend's Timestamp, in nanoseconds
+        qint64 jitter = 0;
+    };
+
+    static constexpr qsizetype capacity = 4096;
+
+    explicit LocationMonitor(QObject *parent = nullptr);
+
+    /// Only updates for @p session are recorded from now on; resets samples and statistics
+    void setSession(const QDBusObjectPath &session);
+    QDBusObjectPath session() const;
+
+    const RingBuffer<Sample> &samples() const;
+    Statistics statistics() const;
+    QString summary() const;
+
+    /// Writes the buffered samples to @p fileName, oldest first
+    bool exportCsv(const QString &fileName) const;
+
+Q_SIGNALS:
+    void updated();
+
+private Q_SLOTS:
+    void locationUpdated(const QDBusMessage &message);
+
+private:
+    QDBusObjectPath m_session;
+    QElapsedTimer m_clock;
+    RingBuffer<Sample> m_samples;
+    Statistics m_statistics;
+    qint64 m_intervalTotal = 0;
+    /// Jitter estimate scaled by 16 as in RFC 3550, to keep integer precision
+    qint64 m_jitter16 = 0;
+    qint64 m_lastTransit = 0;
+};
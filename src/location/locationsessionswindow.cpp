@@ -0,0 +1,430 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "locationsessionswindow.h"
+
+#include <QCoreApplication>
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDateTime>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include <iterator>
+
+#include "benchmark/processinfo.h"
+#include "powerprofile/powerprofilewatcher.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+enum SessionColumn {
+    HandleColumn,
+    AccuracyColumn,
+    DistanceColumn,
+    TimeColumn,
+    UpdatesColumn,
+    LatencyColumn,
+    SessionColumnCount,
+};
+
+enum ScalingColumn {
+    SessionsColumn,
+    RateColumn,
+    MedianColumn,
+    TailColumn,
+    PortalCpuColumn,
+    BackendCpuColumn,
+    GeoclueCpuColumn,
+    OwnCpuColumn,
+    PowerModeColumn,
+    ScalingColumnCount,
+};
+
+QString accuracyName(uint accuracy)
+{
+    static const QStringList names = {i18n("None"), i18n("Country"), i18n("City"), i18n("Neighborhood"), i18n("Street"), i18n("Exact")};
+    return names.value(accuracy);
+}
+
+QString cpuPercent(qint64 before, qint64 after, qint64 elapsedNsecs)
+{
+    if (before < 0 || after < 0 || elapsedNsecs <= 0) {
+        return i18n("unknown");
+    }
+    return QString::number(100.0 * double(after - before) / double(elapsedNsecs), 'f', 1);
+}
+}
+
+LocationSessionsWindow::LocationSessionsWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent)
+    : QWidget(parent)
+    , m_parentWindowId(parentWindowId)
+{
+    auto description = new QLabel(i18n("Sessions cycle through the accuracies and through distance thresholds of 0, 5, 25 and 100 m and time thresholds "
+                                       "of 0, 1 and 5 s. Latency is the receive time minus the Timestamp of the update; CPU is the share of one core "
+                                       "over each step of the scaling test."));
+    description->setWordWrap(true);
+
+    m_addCount = new QSpinBox;
+    m_addCount->setRange(1, 1000);
+    m_addCount->setValue(4);
+    auto openButton = new QPushButton(i18n("Open sessions"));
+    connect(openButton, &QPushButton::clicked, this, [this] {
+        openSessions(m_addCount->value());
+    });
+    auto closeButton = new QPushButton(i18n("Close all"));
+    connect(closeButton, &QPushButton::clicked, this, &LocationSessionsWindow::closeAll);
+    auto sessionButtons = new QHBoxLayout;
+    sessionButtons->addWidget(m_addCount);
+    sessionButtons->addWidget(openButton);
+    sessionButtons->addWidget(closeButton);
+    sessionButtons->addStretch();
+
+    m_scalingCounts = new QLineEdit(u"1,2,4,8,16,32,64"_s);
+    m_stepSeconds = new QSpinBox;
+    m_stepSeconds->setRange(1, 3600);
+    m_stepSeconds->setValue(20);
+    m_stepSeconds->setSuffix(i18n(" s"));
+    m_scalingButton = new QPushButton(i18n("Run scaling test"));
+    connect(m_scalingButton, &QPushButton::clicked, this, [this] {
+        if (m_scaling) {
+            stopScaling();
+        } else {
+            startScaling();
+        }
+    });
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Sessions:"), sessionButtons);
+    form->addRow(i18n("Scaling session counts:"), m_scalingCounts);
+    form->addRow(i18n("Time per step:"), m_stepSeconds);
+    form->addRow(QString(), m_scalingButton);
+
+    m_status = new QLabel;
+    m_status->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    m_scalingTable = new QTableWidget(0, ScalingColumnCount);
+    m_scalingTable->setHorizontalHeaderLabels({i18n("Sessions"),
+                                               i18n("Updates/s"),
+                                               i18n("Latency p50 (ms)"),
+                                               i18n("Latency p99 (ms)"),
+                                               i18n("xdg-desktop-portal CPU %"),
+                                               i18n("Backend CPU %"),
+                                               i18n("GeoClue CPU %"),
+                                               i18n("This process CPU %"),
+                                               i18n("Power mode")});
+    m_scalingTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_scalingTable->horizontalHeader()->setStretchLastSection(true);
+
+    m_sessionTable = new QTableWidget(0, SessionColumnCount);
+    m_sessionTable->setHorizontalHeaderLabels(
+        {i18n("Handle"), i18n("Accuracy"), i18n("Distance (m)"), i18n("Time (s)"), i18n("Updates"), i18n("Latency (ms)")});
+    m_sessionTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_sessionTable->horizontalHeader()->setStretchLastSection(true);
+    m_sessionTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_status);
+    layout->addWidget(m_scalingTable);
+    layout->addWidget(m_sessionTable);
+
+    // One subscription for all sessions, dispatched by handle
+    QDBusConnection::sessionBus().connect(desktopPortalService(),
+                                          desktopPortalPath(),
+                                          u"org.freedesktop.portal.Location"_s,
+                                          u"LocationUpdated"_s,
+                                          this,
+                                          SLOT(locationUpdated(QDBusMessage)));
+
+    m_stepTimer.setSingleShot(true);
+    connect(&m_stepTimer, &QTimer::timeout, this, &LocationSessionsWindow::finishStep);
+    connect(&PowerProfileWatcher::instance(), &PowerProfileWatcher::powerSaverChanged, this, [this] {
+        m_stepModeChanged = m_stepRunning;
+    });
+
+    m_refreshTimer.setInterval(500);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &LocationSessionsWindow::refresh);
+    m_refreshTimer.start();
+
+    m_dirty = true;
+    refresh();
+}
+
+LocationSessionsWindow::~LocationSessionsWindow()
+{
+    closeAll();
+}
+
+void LocationSessionsWindow::openSessions(int count)
+{
+    static constexpr uint distanceThresholds[] = {0, 5, 25, 100};
+    static constexpr uint timeThresholds[] = {0, 1, 5};
+
+    for (int i = 0; i < count; ++i) {
+        const qsizetype index = m_sessions.size();
+        Session session;
+        session.accuracy = 1 + index % 5;
+        session.distanceThreshold = distanceThresholds[index % std::size(distanceThresholds)];
+        session.timeThreshold = timeThresholds[index % std::size(timeThresholds)];
+        m_sessions.append(session);
+        createSession(index);
+    }
+    m_dirty = true;
+}
+
+void LocationSessionsWindow::createSession(int index)
+{
+    const Session &session = m_sessions.at(index);
+    QDBusMessage message =
+        QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), u"org.freedesktop.portal.Location"_s, u"CreateSession"_s);
+    message << QVariantMap{
+        {u"session_handle_token"_s, nextRequestToken()},
+        {u"distance-threshold"_s, session.distanceThreshold},
+        {u"time-threshold"_s, session.timeThreshold},
+        {u"accuracy"_s, session.accuracy},
+    };
+
+    ++m_pendingCreates;
+    const uint generation = m_generation;
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, index, generation](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<QDBusObjectPath> reply = *watcher;
+        if (generation != m_generation) {
+            // Closed while the call was pending
+            if (!reply.isError()) {
+                closePortalSession(reply.value().path());
+            }
+            return;
+        }
+
+        --m_pendingCreates;
+        Session &session = m_sessions[index];
+        if (reply.isError()) {
+            qWarning() << "Couldn't create Location session:" << reply.error().message();
+            session.failed = true;
+        } else {
+            session.handle = reply.value().path();
+            m_sessionIndex.insert(session.handle, index);
+            startSession(index);
+        }
+        m_dirty = true;
+
+        if (m_scaling && m_pendingCreates == 0) {
+            beginStep();
+        }
+    });
+}
+
+void LocationSessionsWindow::startSession(int index)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), u"org.freedesktop.portal.Location"_s, u"Start"_s);
+    message << QVariant::fromValue(QDBusObjectPath(m_sessions.at(index).handle)) << m_parentWindowId()
+            << QVariantMap{{u"handle_token"_s, nextRequestToken()}};
+
+    const uint generation = m_generation;
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, index, generation](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (generation != m_generation) {
+            return;
+        }
+        if (watcher->isError()) {
+            qWarning() << "Couldn't start Location session:" << watcher->error().message();
+            m_sessions[index].failed = true;
+        } else {
+            m_sessions[index].started = true;
+        }
+        m_dirty = true;
+    });
+}
+
+void LocationSessionsWindow::closeAll()
+{
+    for (const Session &session : std::as_const(m_sessions)) {
+        if (!session.handle.isEmpty()) {
+            closePortalSession(session.handle);
+        }
+    }
+    m_sessions.clear();
+    m_sessionIndex.clear();
+    m_pendingCreates = 0;
+    ++m_generation;
+    m_dirty = true;
+}
+
+void LocationSessionsWindow::locationUpdated(const QDBusMessage &message)
+{
+    const QList<QVariant> arguments = message.arguments();
+    if (arguments.size() != 2) {
+        qWarning() << "Unexpected LocationUpdated arguments" << message.signature();
+        return;
+    }
+    const auto it = m_sessionIndex.constFind(arguments.at(0).value<QDBusObjectPath>().path());
+    if (it == m_sessionIndex.constEnd()) {
+        return;
+    }
+    if (!PortalDecoders::decodeLocation(arguments.at(1).value<QDBusArgument>(), m_decoded)) {
+        qWarning() << "Unexpected LocationUpdated arguments" << message.signature();
+        return;
+    }
+
+    Session &session = m_sessions[*it];
+    ++session.updates;
+    if (m_decoded.timestampSeconds > 0) {
+        const qint64 sent = qint64(m_decoded.timestampSeconds) * 1000000 + qint64(m_decoded.timestampMicroseconds);
+        const qint64 latency = (QDateTime::currentMSecsSinceEpoch() * 1000 - sent) * 1000;
+        session.latency.add(latency);
+        if (m_stepRunning) {
+            m_stepLatency.add(latency);
+        }
+    }
+    if (m_stepRunning) {
+        ++m_stepUpdates;
+    }
+    m_dirty = true;
+}
+
+void LocationSessionsWindow::startScaling()
+{
+    m_scalingQueue.clear();
+    const QStringList counts = m_scalingCounts->text().split(u',', Qt::SkipEmptyParts);
+    for (const QString &count : counts) {
+        bool ok = false;
+        const int sessions = count.trimmed().toInt(&ok);
+        if (ok && sessions > 0) {
+            m_scalingQueue.append(sessions);
+        }
+    }
+    if (m_scalingQueue.isEmpty()) {
+        return;
+    }
+
+    m_scaling = true;
+    m_scalingButton->setText(i18n("Stop scaling test"));
+    m_scalingTable->setRowCount(0);
+    nextStep();
+}
+
+void LocationSessionsWindow::stopScaling()
+{
+    m_scaling = false;
+    m_stepRunning = false;
+    m_stepTimer.stop();
+    m_scalingQueue.clear();
+    closeAll();
+    m_scalingButton->setText(i18n("Run scaling test"));
+}
+
+LocationSessionsWindow::CpuSnapshot LocationSessionsWindow::cpuSnapshot() const
+{
+    CpuSnapshot snapshot;
+    snapshot.portal = ProcessInfo::cpuNsecs(ProcessInfo::servicePid(desktopPortalService()));
+    snapshot.backend = ProcessInfo::cpuNsecs(ProcessInfo::servicePid(ProcessInfo::portalBackendService()));
+    snapshot.geoclue = ProcessInfo::cpuNsecs(ProcessInfo::servicePid(u"org.freedesktop.GeoClue2"_s, QDBusConnection::systemBus()));
+    snapshot.own = ProcessInfo::cpuNsecs(QCoreApplication::applicationPid());
+    return snapshot;
+}
+
+void LocationSessionsWindow::nextStep()
+{
+    closeAll();
+    if (m_scalingQueue.isEmpty()) {
+        stopScaling();
+        m_status->setText(i18n("Scaling test finished"));
+        return;
+    }
+
+    // Fewer concurrent sessions while power saving, so the test doesn't work against it
+    const int count = PowerProfileWatcher::instance().scaled(m_scalingQueue.takeFirst());
+    m_status->setText(i18np("Opening %1 session", "Opening %1 sessions", count));
+    openSessions(count);
+}
+
+void LocationSessionsWindow::beginStep()
+{
+    m_status->setText(i18np("Measuring %1 session", "Measuring %1 sessions", m_sessionIndex.size()));
+    m_stepCpu = cpuSnapshot();
+    m_stepUpdates = 0;
+    m_stepLatency.clear();
+    m_stepModeChanged = false;
+    m_stepRunning = true;
+    m_stepClock.start();
+    m_stepTimer.start(m_stepSeconds->value() * 1000);
+}
+
+void LocationSessionsWindow::finishStep()
+{
+    m_stepRunning = false;
+    const qint64 elapsed = m_stepClock.nsecsElapsed();
+    const CpuSnapshot cpu = cpuSnapshot();
+
+    const int row = m_scalingTable->rowCount();
+    m_scalingTable->insertRow(row);
+    const auto set = [this, row](int column, const QString &text) {
+        m_scalingTable->setItem(row, column, new QTableWidgetItem(text));
+    };
+    set(SessionsColumn, QString::number(m_sessionIndex.size()));
+    set(RateColumn, QString::number(double(m_stepUpdates) * 1e9 / double(elapsed), 'f', 1));
+    set(MedianColumn, m_stepLatency.count() > 0 ? LatencyStats::formatMsecs(m_stepLatency.percentile(0.5)) : QString());
+    set(TailColumn, m_stepLatency.count() > 0 ? LatencyStats::formatMsecs(m_stepLatency.percentile(0.99)) : QString());
+    set(PortalCpuColumn, cpuPercent(m_stepCpu.portal, cpu.portal, elapsed));
+    set(BackendCpuColumn, cpuPercent(m_stepCpu.backend, cpu.backend, elapsed));
+    set(GeoclueCpuColumn, cpuPercent(m_stepCpu.geoclue, cpu.geoclue, elapsed));
+    set(OwnCpuColumn, cpuPercent(m_stepCpu.own, cpu.own, elapsed));
+    set(PowerModeColumn, m_stepModeChanged ? i18n("changed during the step") : PowerProfileWatcher::instance().modeName());
+
+    nextStep();
+}
+
+void LocationSessionsWindow::refresh()
+{
+    if (!m_dirty) {
+        return;
+    }
+    m_dirty = false;
+
+    int failed = 0;
+    int started = 0;
+    m_sessionTable->setRowCount(m_sessions.size());
+    for (qsizetype row = 0; row < m_sessions.size(); ++row) {
+        const Session &session = m_sessions.at(row);
+        failed += session.failed;
+        started += session.started;
+        const auto set = [this, row](int column, const QString &text) {
+            QTableWidgetItem *item = m_sessionTable->item(row, column);
+            if (!item) {
+                m_sessionTable->setItem(row, column, new QTableWidgetItem(text));
+            } else if (item->text() != text) {
+                item->setText(text);
+            }
+        };
+        set(HandleColumn, session.failed ? i18n("failed") : session.handle);
+        set(AccuracyColumn, accuracyName(session.accuracy));
+        set(DistanceColumn, QString::number(session.distanceThreshold));
+        set(TimeColumn, QString::number(session.timeThreshold));
+        set(UpdatesColumn, QString::number(session.updates));
+        set(LatencyColumn, session.latency.count() > 0 ? session.latency.summary() : QString());
+    }
+
+    if (!m_scaling) {
+        m_status->setText(i18n("Sessions: %1, started: %2, pending: %3, failed: %4", m_sessions.size(), started, m_pendingCreates, failed));
+    }
+}
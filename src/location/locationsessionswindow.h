@@ -0,0 +1,107 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QTimer>
+#include <QWidget>
+
+#include "benchmark/latencystats.h"
+#include "portalcommon.h"
+#include "portaldecoders.h"
+
+class QDBusMessage;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+
+/**
+ * Runs any number of concurrent Location sessions with a mix of accuracies and thresholds.
+ *
+ * The scaling test opens 1, 2, 4, ... sessions in turn and records the delivery latency of
+ * their updates together with the CPU time xdg-desktop-portal, its backend and GeoClue use.
+ * While power saving is on, each step opens a quarter of the sessions.
+ */
+class LocationSessionsWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LocationSessionsWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent = nullptr);
+    ~LocationSessionsWindow() override;
+
+public Q_SLOTS:
+    void openSessions(int count);
+    void closeAll();
+    void startScaling();
+    void stopScaling();
+
+private Q_SLOTS:
+    void locationUpdated(const QDBusMessage &message);
+
+private:
+    struct Session {
+        /// Empty until CreateSession returned
+        QString handle;
+        uint accuracy = 0;
+        uint distanceThreshold = 0;
+        uint timeThreshold = 0;
+        bool started = false;
+        bool failed = false;
+        quint64 updates = 0;
+        LatencyStats latency;
+    };
+
+    /// CPU time counters of the processes involved, at the start of a scaling step
+    struct CpuSnapshot {
+        qint64 portal = -1;
+        qint64 backend = -1;
+        qint64 geoclue = -1;
+        qint64 own = -1;
+    };
+
+    void createSession(int index);
+    void startSession(int index);
+    CpuSnapshot cpuSnapshot() const;
+    void nextStep();
+    void beginStep();
+    void finishStep();
+    void refresh();
+
+    ParentWindowIdFunction m_parentWindowId;
+
+    QSpinBox *m_addCount;
+    QLineEdit *m_scalingCounts;
+    QSpinBox *m_stepSeconds;
+    QPushButton *m_scalingButton;
+    QLabel *m_status;
+    QTableWidget *m_sessionTable;
+    QTableWidget *m_scalingTable;
+    QTimer m_refreshTimer;
+    bool m_dirty = false;
+
+    QList<Session> m_sessions;
+    QHash<QString, qsizetype> m_sessionIndex;
+    int m_pendingCreates = 0;
+    /// Bumped by closeAll(), so that replies for sessions of an earlier batch are recognized
+    uint m_generation = 0;
+    /// Reused for every update
+    PortalDecoders::Location m_decoded;
+
+    QList<int> m_scalingQueue;
+    bool m_scaling = false;
+    QTimer m_stepTimer;
+    QElapsedTimer m_stepClock;
+    bool m_stepRunning = false;
+    /// Power saving was switched while the step ran, so it mixes both modes
+    bool m_stepModeChanged = false;
+    CpuSnapshot m_stepCpu;
+    quint64 m_stepUpdates = 0;
+    LatencyStats m_stepLatency;
+};
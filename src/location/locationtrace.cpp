@@ -0,0 +1,93 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "locationtrace.h"
+
+#include <QFile>
+
+#include <KLocalizedString>
+
+#include <cmath>
+
+using namespace Qt::StringLiterals;
+
+namespace LocationTrace
+{
+QList<Point> load(const QString &fileName, QString *error)
+{
+    const auto fail = [error](const QString &message) {
+        if (error) {
+            *error = message;
+        }
+        return QList<Point>();
+    };
+
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        return fail(file.errorString());
+    }
+
+    const QList<QByteArray> header = file.readLine().trimmed().split(',');
+    const qsizetype latitudeColumn = header.indexOf("latitude");
+    const qsizetype longitudeColumn = header.indexOf("longitude");
+    qsizetype timeColumn = header.indexOf("offset_ms");
+    if (timeColumn < 0) {
+        timeColumn = header.indexOf("received_ms");
+    }
+    if (latitudeColumn < 0 || longitudeColumn < 0 || timeColumn < 0) {
+        return fail(i18n("The trace needs latitude, longitude and offset_ms or received_ms columns"));
+    }
+    const qsizetype altitudeColumn = header.indexOf("altitude");
+    const qsizetype accuracyColumn = header.indexOf("accuracy");
+    const qsizetype speedColumn = header.indexOf("speed");
+    const qsizetype headingColumn = header.indexOf("heading");
+
+    QList<Point> points;
+    qint64 firstTime = 0;
+    for (QByteArray line = file.readLine(); !line.isEmpty(); line = file.readLine()) {
+        const QList<QByteArray> fields = line.trimmed().split(',');
+        if (fields.size() < header.size() - 1) {
+            continue;
+        }
+        const auto number = [&fields](qsizetype column, double fallback) {
+            bool ok = false;
+            const double value = column >= 0 ? fields.value(column).toDouble(&ok) : 0;
+            return ok ? value : fallback;
+        };
+
+        Point point;
+        const qint64 time = fields.at(timeColumn).toLongLong();
+        if (points.isEmpty()) {
+            firstTime = time;
+        }
+        point.offsetMsecs = time - firstTime;
+        point.latitude = number(latitudeColumn, 0);
+        point.longitude = number(longitudeColumn, 0);
+        point.altitude = number(altitudeColumn, 0);
+        point.accuracy = number(accuracyColumn, 10);
+        point.speed = number(speedColumn, -1);
+        point.heading = number(headingColumn, -1);
+        points.append(point);
+    }
+
+    if (points.isEmpty()) {
+        return fail(i18n("The trace has no points"));
+    }
+    return points;
+}
+
+double distanceMeters(double latitude1, double longitude1, double latitude2, double longitude2)
+{
+    constexpr double earthRadius = 6371000;
+    const auto radians = [](double degrees) {
+        return degrees * M_PI / 180;
+    };
+    const double deltaLatitude = radians(latitude2 - latitude1);
+    const double deltaLongitude = radians(longitude2 - longitude1);
+    const double a = std::sin(deltaLatitude / 2) * std::sin(deltaLatitude / 2)
+        + std::cos(radians(latitude1)) * std::cos(radians(latitude2)) * std::sin(deltaLongitude / 2) * std::sin(deltaLongitude / 2);
+    return 2 * earthRadius * std::atan2(std::sqrt(a), std::sqrt(1 - a));
+}
+}
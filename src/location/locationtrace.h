@@ -0,0 +1,34 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QList>
+#include <QString>
+
+/// A recorded position track, replayed by the GeoClue stand-in
+namespace LocationTrace
+{
+struct Point {
+    /// Time since the first point of the trace
+    qint64 offsetMsecs = 0;
+    double latitude = 0;
+    double longitude = 0;
+    double altitude = 0;
+    double accuracy = 0;
+    double speed = -1;
+    double heading = -1;
+};
+
+/**
+ * Reads a CSV trace with a header row. Needs latitude and longitude columns plus
+ * either offset_ms or received_ms, so samples exported from the Location section
+ * can be replayed as they arrived.
+ */
+QList<Point> load(const QString &fileName, QString *error = nullptr);
+
+/// Great-circle distance in meters
+double distanceMeters(double latitude1, double longitude1, double latitude2, double longitude2);
+}
@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "thresholdanalyzer.h"
+
+#include <KLocalizedString>
+
+#include "locationtrace.h"
+
+double ThresholdAnalyzer::Report::overDelivery() const
+{
+    return expected > 0 ? double(delivered) / double(expected) : 0;
+}
+
+void ThresholdAnalyzer::reset(uint distanceThreshold, uint timeThreshold)
+{
+    m_distanceThreshold = distanceThreshold;
+    m_timeThreshold = timeThreshold;
+    m_report = {};
+    m_lastExpected = {};
+    m_lastDelivered = {};
+}
+
+bool ThresholdAnalyzer::belowThresholds(const Fix &previous, const Fix &current, bool *distance, bool *time) const
+{
+    *distance = m_distanceThreshold > 0
+        && LocationTrace::distanceMeters(previous.latitude, previous.longitude, current.latitude, current.longitude) < m_distanceThreshold;
+    // Whole seconds, as GeoClue compares them; updates without a timestamp can't be checked
+    *time = m_timeThreshold > 0 && current.seconds > 0 && current.seconds - previous.seconds < m_timeThreshold;
+    return *distance || *time;
+}
+
+void ThresholdAnalyzer::addSourcePoint(double latitude, double longitude, qint64 timestampMsecs)
+{
+    const Fix fix{latitude, longitude, quint64(timestampMsecs / 1000)};
+    bool distance = false;
+    bool time = false;
+    ++m_report.sourcePoints;
+    if (m_report.expected > 0 && belowThresholds(m_lastExpected, fix, &distance, &time)) {
+        return;
+    }
+    ++m_report.expected;
+    m_lastExpected = fix;
+}
+
+void ThresholdAnalyzer::addDelivered(const PortalDecoders::Location &location)
+{
+    const Fix fix{location.latitude, location.longitude, location.timestampSeconds};
+    bool distance = false;
+    bool time = false;
+    if (m_report.delivered > 0 && belowThresholds(m_lastDelivered, fix, &distance, &time)) {
+        m_report.distanceViolations += distance;
+        m_report.timeViolations += time;
+    }
+    ++m_report.delivered;
+    m_lastDelivered = fix;
+}
+
+ThresholdAnalyzer::Report ThresholdAnalyzer::report() const
+{
+    return m_report;
+}
+
+QString ThresholdAnalyzer::summary() const
+{
+    QString summary = i18n("Source points: %1, expected updates: %2, delivered: %3, over-delivery: %4×",
+                           m_report.sourcePoints,
+                           m_report.expected,
+                           m_report.delivered,
+                           QString::number(m_report.overDelivery(), 'f', 2))
+        + u'\n';
+    summary += i18n("Below distance threshold (%1 m): %2, below time threshold (%3 s): %4",
+                    m_distanceThreshold,
+                    m_report.distanceViolations,
+                    m_timeThreshold,
+                    m_report.timeViolations);
+    return summary;
+}
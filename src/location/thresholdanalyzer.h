@@ -0,0 +1,57 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QString>
+
+#include "portaldecoders.h"
+
+/**
+ * Checks the updates a Location session delivers against the thresholds it asked for.
+ *
+ * The points the source produced are run through the same filter GeoClue applies, which gives
+ * the number of updates a compliant backend sends. Every delivered update closer to the previous
+ * one than the distance threshold, or sooner than the time threshold, counts as a violation.
+ */
+class ThresholdAnalyzer
+{
+public:
+    struct Report {
+        quint64 sourcePoints = 0;
+        /// Updates a backend honouring the thresholds would have delivered
+        quint64 expected = 0;
+        quint64 delivered = 0;
+        quint64 distanceViolations = 0;
+        quint64 timeViolations = 0;
+
+        /// Delivered per expected update, 1 for a compliant backend
+        double overDelivery() const;
+    };
+
+    /// Starts over for a session with @p distanceThreshold meters and @p timeThreshold seconds
+    void reset(uint distanceThreshold, uint timeThreshold);
+
+    void addSourcePoint(double latitude, double longitude, qint64 timestampMsecs);
+    void addDelivered(const PortalDecoders::Location &location);
+
+    Report report() const;
+    QString summary() const;
+
+private:
+    struct Fix {
+        double latitude = 0;
+        double longitude = 0;
+        quint64 seconds = 0;
+    };
+
+    bool belowThresholds(const Fix &previous, const Fix &current, bool *distance, bool *time) const;
+
+    uint m_distanceThreshold = 0;
+    uint m_timeThreshold = 0;
+    Report m_report;
+    Fix m_lastExpected;
+    Fix m_lastDelivered;
+};
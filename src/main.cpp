@@ -5,9 +5,12 @@
  */
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
 
 #include <KAboutData>
 
+#include "remotedesktop/remotedesktopwindow.h"
 #include "xdgportaltest.h"
 
 int main(int argc, char *argv[])
@@ -18,8 +21,37 @@ int main(int argc, char *argv[])
     KAboutData about(QStringLiteral("xdg-portal-test-kde"), QStringLiteral("Portal Test KDE"), QString());
     KAboutData::setApplicationData(about);
 
+    QCommandLineParser parser;
+    QCommandLineOption parentingStressOption(QStringLiteral("parenting-stress"),
+                                             i18n("Open this many windows with a parented portal dialog each, print the results and exit."),
+                                             QStringLiteral("windows"));
+    QCommandLineOption remoteDesktopOption(QStringLiteral("remote-desktop"),
+                                           i18n("Inject input through a RemoteDesktop session at this many events per second, print the latencies and exit."),
+                                           QStringLiteral("rate"));
+    QCommandLineOption remoteDesktopEventsOption(QStringLiteral("remote-desktop-events"),
+                                                 i18n("Events --remote-desktop injects: %1.", RemoteDesktopWindow::modeNames().join(QStringLiteral(", "))),
+                                                 QStringLiteral("events"),
+                                                 QStringLiteral("both"));
+    parser.addOption(parentingStressOption);
+    parser.addOption(remoteDesktopOption);
+    parser.addOption(remoteDesktopEventsOption);
+    about.setupCommandLine(&parser);
+    parser.process(a);
+    about.processCommandLine(&parser);
+
+    const QString remoteDesktopEvents = parser.value(remoteDesktopEventsOption);
+    if (!RemoteDesktopWindow::modeNames().contains(remoteDesktopEvents)) {
+        qWarning() << "Unknown --remote-desktop-events" << remoteDesktopEvents;
+        return 1;
+    }
+
     XdgPortalTest xdgPortalTest;
     xdgPortalTest.show();
+    if (parser.isSet(parentingStressOption)) {
+        xdgPortalTest.runParentingStress(qMax(1, parser.value(parentingStressOption).toInt()));
+    } else if (parser.isSet(remoteDesktopOption)) {
+        xdgPortalTest.runRemoteDesktop(qBound(1, parser.value(remoteDesktopOption).toInt(), 1000), remoteDesktopEvents);
+    }
 
     return a.exec();
 }
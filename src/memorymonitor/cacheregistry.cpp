@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "cacheregistry.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "benchmark/processinfo.h"
+
+CacheRegistry &CacheRegistry::instance()
+{
+    static CacheRegistry registry;
+    return registry;
+}
+
+void CacheRegistry::add(const QString &name, Level level, QObject *owner, const std::function<qint64()> &cost, const std::function<void()> &shed)
+{
+    m_caches.append({name, level, owner, owner != nullptr, cost, shed});
+}
+
+void CacheRegistry::prune() const
+{
+    m_caches.removeIf([](const Cache &cache) {
+        return cache.owned && !cache.owner;
+    });
+}
+
+QList<CacheRegistry::CacheInfo> CacheRegistry::caches() const
+{
+    prune();
+    QList<CacheInfo> caches;
+    caches.reserve(m_caches.size());
+    for (const Cache &cache : std::as_const(m_caches)) {
+        caches.append({cache.name, cache.level, cache.cost ? cache.cost() : -1});
+    }
+    return caches;
+}
+
+CacheRegistry::Report CacheRegistry::shed(int level)
+{
+    prune();
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    Report report;
+    report.level = level;
+    report.residentBeforeKiB = ProcessInfo::residentKiB(pid);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const Cache &cache : std::as_const(m_caches)) {
+        if (cache.level > level) {
+            continue;
+        }
+        const qint64 before = cache.cost ? cache.cost() : -1;
+        cache.shed();
+        if (before >= 0) {
+            report.reclaimedBytes += before - cache.cost();
+        }
+        report.shed.append(cache.name);
+    }
+#ifdef __GLIBC__
+    // Freed blocks otherwise stay with the allocator and never show up as lower RSS
+    malloc_trim(0);
+#endif
+    report.nsecs = timer.nsecsElapsed();
+
+    report.residentAfterKiB = ProcessInfo::residentKiB(pid);
+    return report;
+}
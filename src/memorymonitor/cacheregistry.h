@@ -0,0 +1,69 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QList>
+#include <QPointer>
+#include <QStringList>
+
+#include <functional>
+
+/**
+ * Process wide list of the caches that can be dropped under memory pressure.
+ *
+ * Every cache names the LowMemoryWarning level from which it is shed, how to measure what
+ * it holds and how to free it. A cache registered with an owner goes away with the owner.
+ */
+class CacheRegistry
+{
+public:
+    /// Levels as sent with LowMemoryWarning, see org.freedesktop.portal.MemoryMonitor
+    enum Level {
+        Low = 50,
+        Medium = 100,
+        Critical = 255,
+    };
+
+    struct CacheInfo {
+        QString name;
+        int level = Low;
+        /// Bytes held, or -1 if the cache can't tell
+        qint64 cost = -1;
+    };
+
+    struct Report {
+        int level = 0;
+        QStringList shed;
+        /// Sum over the caches that know their cost
+        qint64 reclaimedBytes = 0;
+        qint64 nsecs = 0;
+        qint64 residentBeforeKiB = -1;
+        qint64 residentAfterKiB = -1;
+    };
+
+    static CacheRegistry &instance();
+
+    void add(const QString &name, Level level, QObject *owner, const std::function<qint64()> &cost, const std::function<void()> &shed);
+    QList<CacheInfo> caches() const;
+
+    /// Frees every cache registered for @p level or below
+    Report shed(int level);
+
+private:
+    CacheRegistry() = default;
+    void prune() const;
+
+    struct Cache {
+        QString name;
+        Level level;
+        QPointer<QObject> owner;
+        bool owned;
+        std::function<qint64()> cost;
+        std::function<void()> shed;
+    };
+
+    mutable QList<Cache> m_caches;
+};
@@ -0,0 +1,74 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "lowmemorymonitorstandin.h"
+
+#include <KLocalizedString>
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+const QString s_connectionName = u"low-memory-monitor-standin"_s;
+const QString s_service = u"org.freedesktop.LowMemoryMonitor"_s;
+const QString s_path = u"/org/freedesktop/LowMemoryMonitor"_s;
+}
+
+LowMemoryMonitorStandIn::LowMemoryMonitorStandIn(QObject *parent)
+    : QObject(parent)
+    , m_bus(s_connectionName)
+{
+}
+
+LowMemoryMonitorStandIn::~LowMemoryMonitorStandIn()
+{
+    stop();
+}
+
+bool LowMemoryMonitorStandIn::start(const QString &busAddress, QString *error)
+{
+    const auto fail = [this, error](const QString &message) {
+        if (error) {
+            *error = message;
+        }
+        stop();
+        return false;
+    };
+
+    stop();
+    m_bus = QDBusConnection::connectToBus(busAddress, s_connectionName);
+    if (!m_bus.isConnected()) {
+        return fail(i18n("Couldn't connect to %1: %2", busAddress, m_bus.lastError().message()));
+    }
+    m_bus.registerObject(s_path, this, QDBusConnection::ExportScriptableSignals);
+    if (!m_bus.registerService(s_service)) {
+        return fail(i18n("Couldn't claim %1: %2", s_service, m_bus.lastError().message()));
+    }
+    m_running = true;
+    return true;
+}
+
+void LowMemoryMonitorStandIn::stop()
+{
+    if (m_bus.isConnected()) {
+        m_bus.unregisterObject(s_path);
+        m_bus.unregisterService(s_service);
+    }
+    // Also after a failed connect, or connectToBus() would hand the broken connection out again
+    QDBusConnection::disconnectFromBus(s_connectionName);
+    m_running = false;
+}
+
+bool LowMemoryMonitorStandIn::isRunning() const
+{
+    return m_running;
+}
+
+void LowMemoryMonitorStandIn::sendWarning(uchar level)
+{
+    if (m_running) {
+        Q_EMIT LowMemoryWarning(level);
+    }
+}
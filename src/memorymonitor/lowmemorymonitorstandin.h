@@ -0,0 +1,37 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusConnection>
+#include <QObject>
+
+/**
+ * Claims org.freedesktop.LowMemoryMonitor on a private system bus and sends synthetic
+ * warnings, which xdg-desktop-portal's GMemoryMonitor picks up and forwards as
+ * org.freedesktop.portal.MemoryMonitor.LowMemoryWarning.
+ */
+class LowMemoryMonitorStandIn : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.LowMemoryMonitor")
+
+public:
+    explicit LowMemoryMonitorStandIn(QObject *parent = nullptr);
+    ~LowMemoryMonitorStandIn() override;
+
+    bool start(const QString &busAddress, QString *error = nullptr);
+    void stop();
+    bool isRunning() const;
+
+    void sendWarning(uchar level);
+
+Q_SIGNALS:
+    Q_SCRIPTABLE void LowMemoryWarning(uchar level);
+
+private:
+    QDBusConnection m_bus;
+    bool m_running = false;
+};
@@ -0,0 +1,224 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "memorymonitorwindow.h"
+
+#include <QComboBox>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QLocale>
+#include <QPushButton>
+#include <QStandardPaths>
+#include <QTableWidget>
+#include <QTime>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include "benchmark/latencystats.h"
+#include "lowmemorymonitorstandin.h"
+#include "portalcommon.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+enum CacheColumn {
+    CacheNameColumn,
+    CacheLevelColumn,
+    CacheCostColumn,
+    CacheColumnCount,
+};
+
+enum EventColumn {
+    TimeColumn,
+    SourceColumn,
+    LevelColumn,
+    DeliveryColumn,
+    ReactionColumn,
+    ReclaimedColumn,
+    ResidentColumn,
+    ShedColumn,
+    EventColumnCount,
+};
+
+QString levelName(int level)
+{
+    if (level >= CacheRegistry::Critical) {
+        return i18n("Critical (%1)", level);
+    }
+    if (level >= CacheRegistry::Medium) {
+        return i18n("Medium (%1)", level);
+    }
+    return i18n("Low (%1)", level);
+}
+
+QString formatKiB(qint64 kib)
+{
+    return kib < 0 ? i18n("unknown") : QLocale().formattedDataSize(kib * 1024);
+}
+}
+
+MemoryMonitorWindow::MemoryMonitorWindow(QWidget *parent)
+    : QWidget(parent)
+    , m_standIn(new LowMemoryMonitorStandIn(this))
+{
+    auto description = new QLabel(i18n("Every LowMemoryWarning sheds the caches registered for its level or below. To send warnings through "
+                                       "the portal, run xdg-desktop-portal with the private system bus (see README) and start the stand-in."));
+    description->setWordWrap(true);
+
+    m_busAddress = new QLineEdit(u"unix:path=%1/fake-system-bus"_s.arg(QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation)));
+    m_standInButton = new QPushButton(i18n("Start stand-in"));
+    connect(m_standInButton, &QPushButton::clicked, this, &MemoryMonitorWindow::toggleStandIn);
+
+    m_level = new QComboBox;
+    m_level->addItem(levelName(CacheRegistry::Low), int(CacheRegistry::Low));
+    m_level->addItem(levelName(CacheRegistry::Medium), int(CacheRegistry::Medium));
+    m_level->addItem(levelName(CacheRegistry::Critical), int(CacheRegistry::Critical));
+
+    m_sendButton = new QPushButton(i18n("Send through the portal"));
+    m_sendButton->setEnabled(false);
+    connect(m_sendButton, &QPushButton::clicked, this, [this] {
+        m_sent.enqueue(m_clock.nsecsElapsed());
+        m_standIn->sendWarning(uchar(selectedLevel()));
+    });
+    auto localButton = new QPushButton(i18n("Shed locally"));
+    connect(localButton, &QPushButton::clicked, this, [this] {
+        shed(selectedLevel(), i18n("local"), m_clock.nsecsElapsed(), -1);
+    });
+    auto buttons = new QHBoxLayout;
+    buttons->addWidget(m_level);
+    buttons->addWidget(m_sendButton);
+    buttons->addWidget(localButton);
+    buttons->addStretch();
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Private system bus:"), m_busAddress);
+    form->addRow(QString(), m_standInButton);
+    form->addRow(i18n("Warning:"), buttons);
+
+    m_status = new QLabel;
+    m_status->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    m_cachesTable = new QTableWidget(0, CacheColumnCount);
+    m_cachesTable->setHorizontalHeaderLabels({i18n("Cache"), i18n("Shed from"), i18n("Holds")});
+    m_cachesTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_cachesTable->horizontalHeader()->setStretchLastSection(true);
+
+    m_eventsTable = new QTableWidget(0, EventColumnCount);
+    m_eventsTable->setHorizontalHeaderLabels({i18n("Time"),
+                                              i18n("Source"),
+                                              i18n("Level"),
+                                              i18n("Delivery (ms)"),
+                                              i18n("Reaction (ms)"),
+                                              i18n("Reclaimed"),
+                                              i18n("RSS before → after"),
+                                              i18n("Caches shed")});
+    m_eventsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_eventsTable->horizontalHeader()->setStretchLastSection(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_status);
+    layout->addWidget(m_cachesTable);
+    layout->addWidget(m_eventsTable, 1);
+
+    const bool subscribed = QDBusConnection::sessionBus().connect(desktopPortalService(),
+                                                                  desktopPortalPath(),
+                                                                  u"org.freedesktop.portal.MemoryMonitor"_s,
+                                                                  u"LowMemoryWarning"_s,
+                                                                  this,
+                                                                  SLOT(lowMemoryWarning(QDBusMessage)));
+    if (!subscribed) {
+        m_status->setText(i18n("Couldn't subscribe to LowMemoryWarning"));
+    }
+
+    m_refreshTimer.setInterval(1000);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &MemoryMonitorWindow::refreshCaches);
+    m_refreshTimer.start();
+    m_clock.start();
+    refreshCaches();
+}
+
+void MemoryMonitorWindow::toggleStandIn()
+{
+    if (m_standIn->isRunning()) {
+        m_standIn->stop();
+        m_sent.clear();
+        m_standInButton->setText(i18n("Start stand-in"));
+        m_sendButton->setEnabled(false);
+        m_status->setText(i18n("Stand-in stopped"));
+        return;
+    }
+
+    QString error;
+    if (!m_standIn->start(m_busAddress->text(), &error)) {
+        m_status->setText(error);
+        return;
+    }
+    m_standInButton->setText(i18n("Stop stand-in"));
+    m_sendButton->setEnabled(true);
+    m_status->setText(i18n("Stand-in owns org.freedesktop.LowMemoryMonitor"));
+}
+
+int MemoryMonitorWindow::selectedLevel() const
+{
+    return m_level->currentData().toInt();
+}
+
+void MemoryMonitorWindow::lowMemoryWarning(const QDBusMessage &message)
+{
+    const qint64 received = m_clock.nsecsElapsed();
+    const QList<QVariant> arguments = message.arguments();
+    if (arguments.size() != 1) {
+        qWarning() << "Unexpected LowMemoryWarning arguments" << message.signature();
+        return;
+    }
+    // Warnings of the real monitor can arrive in between, those just take the oldest send time
+    const qint64 delivery = m_sent.isEmpty() ? -1 : received - m_sent.dequeue();
+    shed(int(arguments.constFirst().toUInt()), i18n("portal"), received, delivery);
+}
+
+void MemoryMonitorWindow::shed(int level, const QString &source, qint64 receivedNsecs, qint64 deliveryNsecs)
+{
+    const CacheRegistry::Report report = CacheRegistry::instance().shed(level);
+    // From receiving the warning, which includes reading RSS before and after
+    const qint64 reaction = m_clock.nsecsElapsed() - receivedNsecs;
+
+    const int row = m_eventsTable->rowCount();
+    m_eventsTable->insertRow(row);
+    const auto set = [this, row](int column, const QString &text) {
+        m_eventsTable->setItem(row, column, new QTableWidgetItem(text));
+    };
+    set(TimeColumn, QTime::currentTime().toString(u"HH:mm:ss.zzz"_s));
+    set(SourceColumn, source);
+    set(LevelColumn, levelName(level));
+    set(DeliveryColumn, deliveryNsecs < 0 ? QString() : LatencyStats::formatMsecs(deliveryNsecs));
+    set(ReactionColumn, i18n("%1 (shedding %2)", LatencyStats::formatMsecs(reaction), LatencyStats::formatMsecs(report.nsecs)));
+    set(ReclaimedColumn, QLocale().formattedDataSize(report.reclaimedBytes));
+    set(ResidentColumn, i18n("%1 → %2", formatKiB(report.residentBeforeKiB), formatKiB(report.residentAfterKiB)));
+    set(ShedColumn, report.shed.join(u", "_s));
+    m_eventsTable->scrollToBottom();
+
+    refreshCaches();
+}
+
+void MemoryMonitorWindow::refreshCaches()
+{
+    const QList<CacheRegistry::CacheInfo> caches = CacheRegistry::instance().caches();
+    m_cachesTable->setRowCount(caches.size());
+    for (int row = 0; row < caches.size(); ++row) {
+        const CacheRegistry::CacheInfo &cache = caches.at(row);
+        m_cachesTable->setItem(row, CacheNameColumn, new QTableWidgetItem(cache.name));
+        m_cachesTable->setItem(row, CacheLevelColumn, new QTableWidgetItem(levelName(cache.level)));
+        m_cachesTable->setItem(row, CacheCostColumn, new QTableWidgetItem(cache.cost < 0 ? i18n("unknown") : QLocale().formattedDataSize(cache.cost)));
+    }
+}
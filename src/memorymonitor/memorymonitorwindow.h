@@ -0,0 +1,59 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QQueue>
+#include <QTimer>
+#include <QWidget>
+
+#include "cacheregistry.h"
+
+class LowMemoryMonitorStandIn;
+class QComboBox;
+class QDBusMessage;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QTableWidget;
+
+/**
+ * Sheds the registered caches on org.freedesktop.portal.MemoryMonitor.LowMemoryWarning and
+ * logs every warning with the memory reclaimed and the time the shedding took.
+ *
+ * Warnings can be sent through the whole stack with a low-memory-monitor stand-in on the
+ * private system bus the portal runs with, or dispatched locally.
+ */
+class MemoryMonitorWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MemoryMonitorWindow(QWidget *parent = nullptr);
+
+private Q_SLOTS:
+    void lowMemoryWarning(const QDBusMessage &message);
+
+private:
+    void toggleStandIn();
+    int selectedLevel() const;
+    void shed(int level, const QString &source, qint64 receivedNsecs, qint64 deliveryNsecs);
+    void refreshCaches();
+
+    LowMemoryMonitorStandIn *m_standIn;
+    QLineEdit *m_busAddress;
+    QPushButton *m_standInButton;
+    QPushButton *m_sendButton;
+    QComboBox *m_level;
+    QLabel *m_status;
+    QTableWidget *m_cachesTable;
+    QTableWidget *m_eventsTable;
+    QTimer m_refreshTimer;
+
+    QElapsedTimer m_clock;
+    /// Send times of the stand-in warnings not received back yet
+    QQueue<qint64> m_sent;
+};
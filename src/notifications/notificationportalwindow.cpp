@@ -0,0 +1,321 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "notificationportalwindow.h"
+
+#include <QBuffer>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusVariant>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QIcon>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include "benchmark/processinfo.h"
+#include "iconcache.h"
+#include "portalcommon.h"
+#include "portalicon.h"
+
+using namespace Qt::StringLiterals;
+
+static QString notificationInterface()
+{
+    return u"org.freedesktop.portal.Notification"_s;
+}
+
+NotificationPortalWindow::NotificationPortalWindow(QWidget *parent)
+    : QWidget(parent)
+{
+    qDBusRegisterMetaType<QList<QVariantMap>>();
+    PortalIcon::registerDBusType();
+
+    auto description = new QLabel(i18n("Sends notifications through org.freedesktop.portal.Notification directly, "
+                                       "so that portal and backend cost can be told apart from KNotification overhead."));
+    description->setWordWrap(true);
+
+    m_iconMode = new QComboBox;
+    m_iconMode->addItems({i18n("No icon"), i18n("Themed"), i18n("Bytes (PNG)"), i18n("File descriptor (sealed memfd)")});
+    m_iconMode->setCurrentIndex(BytesIcon);
+
+    m_cacheIcons = new QCheckBox(i18n("Reuse encoded icons and memfds"));
+    m_cacheIcons->setChecked(true);
+
+    m_floodCount = new QSpinBox;
+    m_floodCount->setRange(1, 100000);
+    m_floodCount->setValue(500);
+
+    m_floodRate = new QSpinBox;
+    m_floodRate->setRange(1, 10000);
+    m_floodRate->setValue(50);
+    m_floodRate->setSuffix(i18n(" /s"));
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Icon:"), m_iconMode);
+    form->addRow(QString(), m_cacheIcons);
+    form->addRow(i18n("Flood count:"), m_floodCount);
+    form->addRow(i18n("Flood rate:"), m_floodRate);
+
+    auto sendButton = new QPushButton(i18n("Send one"));
+    m_floodButton = new QPushButton(i18n("Start flood"));
+    auto removeButton = new QPushButton(i18n("Remove all"));
+    connect(sendButton, &QPushButton::clicked, this, &NotificationPortalWindow::sendOne);
+    connect(m_floodButton, &QPushButton::clicked, this, [this] {
+        if (m_floodTimer.isActive()) {
+            stopFlood();
+        } else {
+            startFlood();
+        }
+    });
+    connect(removeButton, &QPushButton::clicked, this, &NotificationPortalWindow::removeAll);
+
+    auto buttons = new QHBoxLayout;
+    buttons->addWidget(sendButton);
+    buttons->addWidget(m_floodButton);
+    buttons->addWidget(removeButton);
+    buttons->addStretch();
+
+    m_report = new QLabel;
+    m_report->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    m_memoryTable = new QTableWidget(0, 4);
+    m_memoryTable->setHorizontalHeaderLabels({i18n("Live"), i18n("Elapsed (s)"), i18n("Portal RSS (KiB)"), i18n("Backend RSS (KiB)")});
+    m_memoryTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_memoryTable->horizontalHeader()->setStretchLastSection(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addLayout(buttons);
+    layout->addWidget(m_report);
+    layout->addWidget(m_memoryTable);
+
+    m_floodTimer.setInterval(10);
+    m_floodTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_floodTimer, &QTimer::timeout, this, &NotificationPortalWindow::floodTick);
+
+    m_memoryTimer.setInterval(1000);
+    connect(&m_memoryTimer, &QTimer::timeout, this, &NotificationPortalWindow::sampleMemory);
+
+    m_clock.start();
+
+    QDBusConnection::sessionBus().connect(desktopPortalService(),
+                                          desktopPortalPath(),
+                                          notificationInterface(),
+                                          "ActionInvoked"_L1,
+                                          this,
+                                          SLOT(actionInvoked(QString,QString,QVariantList)));
+
+    QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(),
+                                                          desktopPortalPath(),
+                                                          "org.freedesktop.DBus.Properties"_L1,
+                                                          "Get"_L1);
+    message << notificationInterface() << u"version"_s;
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<QDBusVariant> reply = *watcher;
+        if (reply.isError()) {
+            qWarning() << "Couldn't read notification portal version:" << reply.error().message();
+        } else {
+            m_version = reply.value().variant().toUInt();
+        }
+        updateReport();
+    });
+
+    updateReport();
+}
+
+QVariantMap NotificationPortalWindow::notification(const QString &id)
+{
+    const QList<QVariantMap> buttons = {
+        {{u"label"_s, i18n("Action 1")}, {u"action"_s, u"action1"_s}, {u"target"_s, id}},
+        {{u"label"_s, i18n("Action 2")}, {u"action"_s, u"action2"_s}, {u"target"_s, id}},
+    };
+
+    QVariantMap data = {
+        {u"title"_s, i18n("Portal notification %1", id)},
+        {u"body"_s, i18n("Sent through org.freedesktop.portal.Notification")},
+        {u"priority"_s, u"normal"_s},
+        {u"default-action"_s, u"default"_s},
+        {u"default-action-target"_s, id},
+        {u"buttons"_s, QVariant::fromValue(buttons)},
+    };
+
+    static constexpr auto iconSize = 64;
+    const auto iconName = u"applications-development"_s;
+    switch (m_iconMode->currentIndex()) {
+    case NoIcon:
+        break;
+    case ThemedIcon:
+        data.insert(u"icon"_s, QVariant::fromValue(PortalIcon::fromThemedNames({iconName})));
+        break;
+    case BytesIcon:
+    case FileDescriptorIcon: {
+        const bool asMemfd = m_iconMode->currentIndex() == FileDescriptorIcon;
+        const qint64 start = m_clock.nsecsElapsed();
+        PortalIcon icon;
+        if (m_cacheIcons->isChecked()) {
+            auto &iconCache = IconCache::instance();
+            icon = iconCache.portalIcon(iconCache.themedIcon(iconName, iconSize), asMemfd);
+        } else {
+            QBuffer buffer;
+            QIcon::fromTheme(iconName).pixmap(iconSize, iconSize).save(&buffer, "PNG");
+            icon = asMemfd ? PortalIcon::fromFileDescriptor(PortalIcon::sealedMemfd(buffer.buffer())) : PortalIcon::fromBytes(buffer.buffer());
+        }
+        m_iconCost.add(m_clock.nsecsElapsed() - start);
+        data.insert(u"icon"_s, QVariant::fromValue(icon));
+        break;
+    }
+    }
+
+    return data;
+}
+
+void NotificationPortalWindow::addNotification()
+{
+    const QString id = u"xdg-portal-test-%1"_s.arg(++m_idCounter);
+
+    QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(),
+                                                          desktopPortalPath(),
+                                                          notificationInterface(),
+                                                          "AddNotification"_L1);
+    message << id << notification(id);
+
+    const qint64 sent = m_clock.nsecsElapsed();
+    m_live.insert(id, sent);
+
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, id, sent](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<> reply = *watcher;
+        if (reply.isError()) {
+            qWarning() << "Couldn't add notification" << id << reply.error().message();
+            m_live.remove(id);
+            ++m_errors;
+        } else {
+            m_addLatency.add(m_clock.nsecsElapsed() - sent);
+        }
+        if (!m_floodTimer.isActive()) {
+            updateReport();
+        }
+    });
+}
+
+void NotificationPortalWindow::sendOne()
+{
+    addNotification();
+}
+
+void NotificationPortalWindow::startFlood()
+{
+    m_addLatency.clear();
+    m_iconCost.clear();
+    m_errors = 0;
+    m_memoryTable->setRowCount(0);
+
+    m_floodTotal = m_floodCount->value();
+    m_floodSent = 0;
+    m_floodStart = m_clock.nsecsElapsed();
+    m_floodButton->setText(i18n("Stop flood"));
+    m_floodTimer.start();
+    m_memoryTimer.start();
+    sampleMemory();
+}
+
+void NotificationPortalWindow::stopFlood()
+{
+    m_floodTimer.stop();
+    m_memoryTimer.stop();
+    m_floodButton->setText(i18n("Start flood"));
+    sampleMemory();
+    updateReport();
+}
+
+void NotificationPortalWindow::floodTick()
+{
+    // Send however many notifications are owed by now, so the rate holds even when ticks arrive late
+    const double elapsed = (m_clock.nsecsElapsed() - m_floodStart) / 1e9;
+    const int owed = qMin<int>(elapsed * m_floodRate->value(), m_floodTotal) - m_floodSent;
+    for (int i = 0; i < owed; ++i) {
+        addNotification();
+    }
+    m_floodSent += qMax(owed, 0);
+
+    if (m_floodSent >= m_floodTotal) {
+        stopFlood();
+    } else {
+        updateReport();
+    }
+}
+
+void NotificationPortalWindow::removeAll()
+{
+    for (auto it = m_live.cbegin(); it != m_live.cend(); ++it) {
+        QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(),
+                                                              desktopPortalPath(),
+                                                              notificationInterface(),
+                                                              "RemoveNotification"_L1);
+        message << it.key();
+        QDBusConnection::sessionBus().asyncCall(message);
+    }
+    m_live.clear();
+    updateReport();
+}
+
+void NotificationPortalWindow::actionInvoked(const QString &id, const QString &action, const QVariantList &parameter)
+{
+    Q_UNUSED(action)
+    Q_UNUSED(parameter)
+
+    const auto it = m_live.constFind(id);
+    if (it == m_live.cend()) {
+        // Not one of ours, e.g. sent through KNotification on the main tab
+        return;
+    }
+    m_timeToAction.add(m_clock.nsecsElapsed() - it.value());
+    m_live.erase(it);
+    updateReport();
+}
+
+void NotificationPortalWindow::sampleMemory()
+{
+    const qint64 portalRss = ProcessInfo::residentKiB(ProcessInfo::servicePid(desktopPortalService()));
+    const qint64 backendRss = ProcessInfo::residentKiB(ProcessInfo::servicePid(ProcessInfo::portalBackendService()));
+    const auto rss = [](qint64 kib) {
+        return kib < 0 ? i18n("n/a") : QString::number(kib);
+    };
+
+    const int row = m_memoryTable->rowCount();
+    m_memoryTable->insertRow(row);
+    m_memoryTable->setItem(row, 0, new QTableWidgetItem(QString::number(m_live.size())));
+    m_memoryTable->setItem(row, 1, new QTableWidgetItem(QString::number((m_clock.nsecsElapsed() - m_floodStart) / 1e9, 'f', 1)));
+    m_memoryTable->setItem(row, 2, new QTableWidgetItem(rss(portalRss)));
+    m_memoryTable->setItem(row, 3, new QTableWidgetItem(rss(backendRss)));
+    m_memoryTable->scrollToBottom();
+}
+
+void NotificationPortalWindow::updateReport()
+{
+    QString report = i18n("Portal version: %1", m_version) + u'\n';
+    report += i18n("Live notifications: %1, sent in flood: %2/%3, errors: %4", m_live.size(), m_floodSent, m_floodTotal, m_errors) + u'\n';
+    report += i18n("AddNotification latency: %1", m_addLatency.summary()) + u'\n';
+    report += i18n("Time to action, including the click: %1", m_timeToAction.summary()) + u'\n';
+    report += i18n("Icon preparation: %1", m_iconCost.summary()) + u'\n';
+    report += IconCache::instance().summary();
+    m_report->setText(report);
+}
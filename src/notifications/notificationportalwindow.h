@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QTimer>
+#include <QWidget>
+
+#include "benchmark/latencystats.h"
+
+class QCheckBox;
+class QComboBox;
+class QLabel;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+
+/// Talks to org.freedesktop.portal.Notification directly, bypassing KNotification
+class NotificationPortalWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit NotificationPortalWindow(QWidget *parent = nullptr);
+
+public Q_SLOTS:
+    void sendOne();
+    void startFlood();
+    void stopFlood();
+    void removeAll();
+
+private Q_SLOTS:
+    void actionInvoked(const QString &id, const QString &action, const QVariantList &parameter);
+
+private:
+    enum IconMode {
+        NoIcon,
+        ThemedIcon,
+        BytesIcon,
+        FileDescriptorIcon,
+    };
+
+    void addNotification();
+    QVariantMap notification(const QString &id);
+    void floodTick();
+    void sampleMemory();
+    void updateReport();
+
+    QSpinBox *m_floodCount;
+    QSpinBox *m_floodRate;
+    QComboBox *m_iconMode;
+    QCheckBox *m_cacheIcons;
+    QPushButton *m_floodButton;
+    QLabel *m_report;
+    QTableWidget *m_memoryTable;
+
+    QTimer m_floodTimer;
+    QTimer m_memoryTimer;
+    QElapsedTimer m_clock;
+    qint64 m_floodStart = 0;
+    int m_floodSent = 0;
+    int m_floodTotal = 0;
+
+    quint64 m_idCounter = 0;
+    uint m_version = 0;
+    /// live notification id -> time it was sent, in nanoseconds on m_clock
+    QHash<QString, qint64> m_live;
+    LatencyStats m_addLatency;
+    /// From sending to ActionInvoked, so mostly the time somebody took to click
+    LatencyStats m_timeToAction;
+    LatencyStats m_iconCost;
+    int m_errors = 0;
+};
@@ -0,0 +1,455 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "openuribenchmarkwindow.h"
+
+#include <QCheckBox>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusUnixFileDescriptor>
+#include <QFile>
+#include <QFileInfo>
+#include <QFormLayout>
+#include <QGuiApplication>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QTemporaryDir>
+#include <QVBoxLayout>
+#include <QWindow>
+
+#include <KLocalizedString>
+#include <KWaylandExtras>
+#include <KWindowSystem>
+
+#include "stubhandler.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+enum Column {
+    MethodColumn,
+    OptionsColumn,
+    TokenColumn,
+    ResponseColumn,
+    ResponseTailColumn,
+    LaunchColumn,
+    LaunchTailColumn,
+    FailuresColumn,
+    ColumnCount,
+};
+
+constexpr int responseTimeout = 30000;
+// The chooser waits for somebody to pick the stub handler
+constexpr int askResponseTimeout = 120000;
+constexpr int launchTimeout = 10000;
+}
+
+OpenUriBenchmarkWindow::OpenUriBenchmarkWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent)
+    : QWidget(parent)
+    , m_parentWindowId(parentWindowId)
+    , m_stub(new StubHandler(u"stub-handler"_s, u"application/x-xdg-portal-test-stub"_s, u"xdgportalteststub"_s, this))
+{
+    auto description = new QLabel(i18n("Opens stub documents through OpenFile, and their directories through OpenDirectory, passing O_PATH file "
+                                       "descriptors. For the duration of a run, a stub handler for *.%1 gets installed into your data directory to "
+                                       "record when it is launched; with ask, pick it in the chooser.",
+                                       m_stub->suffix()));
+    description->setWordWrap(true);
+
+    m_ask = new QCheckBox(i18n("ask"));
+    m_ask->setChecked(true);
+    m_writable = new QCheckBox(i18n("writable"));
+    m_writable->setChecked(true);
+    m_activationToken = new QCheckBox(i18n("activation_token"));
+    m_activationToken->setChecked(KWindowSystem::isPlatformWayland());
+    auto variants = new QHBoxLayout;
+    variants->addWidget(m_ask);
+    variants->addWidget(m_writable);
+    variants->addWidget(m_activationToken);
+    variants->addStretch();
+
+    m_openDirectory = new QCheckBox(i18n("Also run OpenDirectory"));
+
+    m_repetitions = new QSpinBox;
+    m_repetitions->setRange(1, 100);
+    m_repetitions->setValue(5);
+
+    m_stubButton = new QPushButton;
+    connect(m_stubButton, &QPushButton::clicked, this, [this] {
+        m_stubInstalledForRun = false;
+        if (m_stub->isInstalled()) {
+            m_stub->uninstall();
+        } else if (QString error; !m_stub->install(&error)) {
+            m_status->setText(error);
+        }
+        updateStubButton();
+    });
+
+    m_startButton = new QPushButton(i18n("Run"));
+    connect(m_startButton, &QPushButton::clicked, this, [this] {
+        if (m_running) {
+            stop();
+        } else {
+            start();
+        }
+    });
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Variants besides plain:"), variants);
+    form->addRow(QString(), m_openDirectory);
+    form->addRow(i18n("Repetitions:"), m_repetitions);
+    form->addRow(QString(), m_stubButton);
+    form->addRow(QString(), m_startButton);
+
+    m_status = new QLabel;
+    m_status->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_status->setWordWrap(true);
+
+    m_table = new QTableWidget(0, ColumnCount);
+    m_table->setHorizontalHeaderLabels({i18n("Method"),
+                                        i18n("Options"),
+                                        i18n("Token p50 (ms)"),
+                                        i18n("Response p50 (ms)"),
+                                        i18n("Response max (ms)"),
+                                        i18n("Launch p50 (ms)"),
+                                        i18n("Launch max (ms)"),
+                                        i18n("Failed / not launched")});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_status);
+    layout->addWidget(m_table, 1);
+
+    connect(m_stub, &StubHandler::launched, this, &OpenUriBenchmarkWindow::handlerLaunched);
+
+    connect(KWaylandExtras::self(), &KWaylandExtras::xdgActivationTokenArrived, this, [this](int serial, const QString &token) {
+        if (!m_waitingForToken || uint(serial) != m_tokenSerial) {
+            return;
+        }
+        m_waitingForToken = false;
+        m_variants[m_currentVariant].token.add(m_tokenClock.nsecsElapsed());
+        send(token);
+    });
+
+    m_timeout.setSingleShot(true);
+    connect(&m_timeout, &QTimer::timeout, this, [this] {
+        if (m_waitingForToken) {
+            m_waitingForToken = false;
+            m_variants[m_currentVariant].error = i18n("No activation token");
+            finishRun(true);
+        } else if (!m_responded) {
+            QDBusConnection::sessionBus().asyncCall(
+                QDBusMessage::createMethodCall(desktopPortalService(), m_requestPath, portalRequestInterface(), u"Close"_s));
+            finishRun(true);
+        } else {
+            ++m_variants[m_currentVariant].missingLaunches;
+            finishRun(false);
+        }
+    });
+
+    updateStubButton();
+}
+
+OpenUriBenchmarkWindow::~OpenUriBenchmarkWindow()
+{
+    stop();
+    // Never leave the stub behind as the handler once the application is gone
+    if (m_stub->isInstalled()) {
+        m_stub->uninstall();
+    }
+}
+
+void OpenUriBenchmarkWindow::updateStubButton()
+{
+    m_stubButton->setText(m_stub->isInstalled() ? i18n("Uninstall stub handler") : i18n("Install stub handler"));
+}
+
+void OpenUriBenchmarkWindow::start()
+{
+    if (!m_stub->isInstalled()) {
+        QString error;
+        if (!m_stub->install(&error)) {
+            m_status->setText(error);
+            return;
+        }
+        m_stubInstalledForRun = true;
+        updateStubButton();
+    }
+
+    m_variants.clear();
+    for (const bool directory : {false, true}) {
+        if (directory && !m_openDirectory->isChecked()) {
+            continue;
+        }
+        Variant plain;
+        plain.directory = directory;
+        m_variants.append(plain);
+        // OpenDirectory only knows activation_token
+        if (!directory && m_ask->isChecked()) {
+            Variant ask = plain;
+            ask.ask = true;
+            m_variants.append(ask);
+        }
+        if (!directory && m_writable->isChecked()) {
+            Variant writable = plain;
+            writable.writable = true;
+            m_variants.append(writable);
+        }
+        if (m_activationToken->isChecked()) {
+            Variant activationToken = plain;
+            activationToken.activationToken = true;
+            m_variants.append(activationToken);
+        }
+    }
+
+    m_directory = std::make_unique<QTemporaryDir>();
+    m_table->setRowCount(m_variants.size());
+    for (int row = 0; row < m_variants.size(); ++row) {
+        updateRow(row);
+    }
+    m_currentVariant = 0;
+    m_currentRepetition = 0;
+    m_running = true;
+    m_startButton->setText(i18n("Stop"));
+    m_stub->watch();
+    runNext();
+}
+
+void OpenUriBenchmarkWindow::stop()
+{
+    if (!m_requestPath.isEmpty()) {
+        QDBusConnection::sessionBus().disconnect(desktopPortalService(),
+                                                 m_requestPath,
+                                                 portalRequestInterface(),
+                                                 portalRequestResponse(),
+                                                 this,
+                                                 SLOT(openResponse(uint,QVariantMap)));
+        m_requestPath.clear();
+    }
+    m_timeout.stop();
+    m_stub->stopWatching();
+    if (m_stubInstalledForRun) {
+        m_stub->uninstall();
+        m_stubInstalledForRun = false;
+        updateStubButton();
+    }
+    m_waitingForToken = false;
+    m_running = false;
+    m_currentVariant = -1;
+    m_startButton->setText(i18n("Run"));
+}
+
+void OpenUriBenchmarkWindow::runNext()
+{
+    if (!m_running) {
+        return;
+    }
+    if (m_currentRepetition >= m_repetitions->value()) {
+        m_currentRepetition = 0;
+        ++m_currentVariant;
+    }
+    if (m_currentVariant >= m_variants.size()) {
+        stop();
+        m_status->setText(i18n("Finished"));
+        return;
+    }
+
+    const Variant &variant = m_variants.at(m_currentVariant);
+    m_status->setText(i18n("%1 %2, run %3 of %4",
+                           variant.directory ? u"OpenDirectory"_s : u"OpenFile"_s,
+                           m_table->item(m_currentVariant, OptionsColumn)->text(),
+                           m_currentRepetition + 1,
+                           m_repetitions->value()));
+
+    if (!variant.activationToken) {
+        send(QString());
+        return;
+    }
+    QWindow *window = this->window()->windowHandle();
+    if (!KWindowSystem::isPlatformWayland() || !window) {
+        m_variants[m_currentVariant].error = i18n("Tokens need Wayland");
+        updateRow(m_currentVariant);
+        m_currentRepetition = m_repetitions->value();
+        runNext();
+        return;
+    }
+    m_tokenSerial = KWaylandExtras::lastInputSerial(window);
+    m_waitingForToken = true;
+    m_tokenClock.start();
+    KWaylandExtras::requestXdgActivationToken(window, m_tokenSerial, QGuiApplication::desktopFileName());
+    m_timeout.start(responseTimeout);
+}
+
+void OpenUriBenchmarkWindow::send(const QString &activationToken)
+{
+    const Variant &variant = m_variants.at(m_currentVariant);
+
+    // A fresh name per run, so the launch can't be mistaken for an earlier one
+    m_expectedFile = u"run-%1.%2"_s.arg(++m_fileCounter).arg(m_stub->suffix());
+    const QString path = m_directory->filePath(m_expectedFile);
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly) || file.write("stub\n") < 0) {
+        qWarning() << "Couldn't create" << path << file.errorString();
+        finishRun(true);
+        return;
+    }
+    file.close();
+
+    const int fd = ::open(QFile::encodeName(path).constData(), O_PATH | O_CLOEXEC);
+    if (fd < 0) {
+        qWarning() << "Couldn't open" << path;
+        finishRun(true);
+        return;
+    }
+    // QDBusUnixFileDescriptor keeps a duplicate
+    const QDBusUnixFileDescriptor descriptor(fd);
+    ::close(fd);
+
+    const QString token = nextRequestToken();
+    QVariantMap options{{u"handle_token"_s, token}};
+    if (variant.ask) {
+        options.insert(u"ask"_s, true);
+    }
+    if (variant.writable) {
+        options.insert(u"writable"_s, true);
+    }
+    if (!activationToken.isEmpty()) {
+        options.insert(u"activation_token"_s, activationToken);
+    }
+
+    m_requestPath = portalRequestPath(token);
+    QDBusConnection::sessionBus().connect(desktopPortalService(),
+                                          m_requestPath,
+                                          portalRequestInterface(),
+                                          portalRequestResponse(),
+                                          this,
+                                          SLOT(openResponse(uint,QVariantMap)));
+
+    QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(),
+                                                          desktopPortalPath(),
+                                                          u"org.freedesktop.portal.OpenURI"_s,
+                                                          variant.directory ? u"OpenDirectory"_s : u"OpenFile"_s);
+    message << m_parentWindowId() << QVariant::fromValue(descriptor) << options;
+
+    m_responded = false;
+    // OpenDirectory starts the file manager, which doesn't report in
+    m_launchSeen = variant.directory;
+    m_sentRealtimeNsecs = StubHandler::realtimeNsecs();
+    m_requestClock.start();
+    const QString requestPath = m_requestPath;
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, requestPath](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (requestPath != m_requestPath || !watcher->isError()) {
+            return;
+        }
+        qWarning() << "OpenURI call failed:" << watcher->error().message();
+        m_variants[m_currentVariant].error = watcher->error().message();
+        finishRun(true);
+    });
+    m_timeout.start(variant.ask ? askResponseTimeout : responseTimeout);
+}
+
+void OpenUriBenchmarkWindow::openResponse(uint response, const QVariantMap &results)
+{
+    Q_UNUSED(results)
+    if (m_responded) {
+        return;
+    }
+    m_responded = true;
+    if (response != 0) {
+        finishRun(true);
+        return;
+    }
+    m_variants[m_currentVariant].response.add(m_requestClock.nsecsElapsed());
+    if (m_launchSeen) {
+        finishRun(false);
+    } else {
+        m_timeout.start(launchTimeout);
+    }
+}
+
+void OpenUriBenchmarkWindow::handlerLaunched(const QString &argument, qint64 realtimeNsecs)
+{
+    // Matched by name, a sandboxed caller gets a document portal path
+    if (!m_running || m_launchSeen || QFileInfo(argument).fileName() != m_expectedFile) {
+        return;
+    }
+    m_launchSeen = true;
+    m_variants[m_currentVariant].launch.add(realtimeNsecs - m_sentRealtimeNsecs);
+    // The handler can come up before the backend responds
+    if (m_responded) {
+        finishRun(false);
+    }
+}
+
+void OpenUriBenchmarkWindow::finishRun(bool failed)
+{
+    QDBusConnection::sessionBus().disconnect(desktopPortalService(),
+                                             m_requestPath,
+                                             portalRequestInterface(),
+                                             portalRequestResponse(),
+                                             this,
+                                             SLOT(openResponse(uint,QVariantMap)));
+    m_requestPath.clear();
+    m_timeout.stop();
+    if (!m_running) {
+        return;
+    }
+    if (failed) {
+        ++m_variants[m_currentVariant].failures;
+    }
+    updateRow(m_currentVariant);
+    ++m_currentRepetition;
+    // Outside of the D-Bus dispatch
+    QTimer::singleShot(0, this, &OpenUriBenchmarkWindow::runNext);
+}
+
+void OpenUriBenchmarkWindow::updateRow(int row)
+{
+    const Variant &variant = m_variants.at(row);
+    const auto set = [this, row](int column, const QString &text) {
+        m_table->setItem(row, column, new QTableWidgetItem(text));
+    };
+    const auto median = [](const LatencyStats &stats) {
+        return stats.count() > 0 ? LatencyStats::formatMsecs(stats.percentile(0.5)) : QString();
+    };
+    const auto max = [](const LatencyStats &stats) {
+        return stats.count() > 0 ? LatencyStats::formatMsecs(stats.max()) : QString();
+    };
+
+    QStringList options;
+    if (variant.ask) {
+        options.append(u"ask"_s);
+    }
+    if (variant.writable) {
+        options.append(u"writable"_s);
+    }
+    if (variant.activationToken) {
+        options.append(u"activation_token"_s);
+    }
+
+    set(MethodColumn, variant.directory ? u"OpenDirectory"_s : u"OpenFile"_s);
+    set(OptionsColumn, options.isEmpty() ? i18n("plain") : options.join(u", "_s));
+    set(TokenColumn, median(variant.token));
+    set(ResponseColumn, median(variant.response));
+    set(ResponseTailColumn, max(variant.response));
+    set(LaunchColumn, variant.directory ? i18n("n/a") : median(variant.launch));
+    set(LaunchTailColumn, variant.directory ? i18n("n/a") : max(variant.launch));
+    set(FailuresColumn,
+        variant.error.isEmpty() ? u"%1 / %2"_s.arg(variant.failures).arg(variant.missingLaunches)
+                                : u"%1 / %2 (%3)"_s.arg(variant.failures).arg(variant.missingLaunches).arg(variant.error));
+}
@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QWidget>
+
+#include <memory>
+
+#include "benchmark/latencystats.h"
+#include "portalcommon.h"
+
+class QCheckBox;
+class QLabel;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+class QTemporaryDir;
+class StubHandler;
+
+/**
+ * Opens files through OpenURI.OpenFile and their directories through OpenDirectory, passing
+ * O_PATH fds instead of URIs, in ask, writable and activation_token variants.
+ *
+ * Response is the time until the backend's Response. Launch is the time until the stub
+ * handler recorded its start, both taken from sending the call; the activation token is
+ * requested before that and reported on its own.
+ */
+class OpenUriBenchmarkWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit OpenUriBenchmarkWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent = nullptr);
+    ~OpenUriBenchmarkWindow() override;
+
+public Q_SLOTS:
+    void start();
+    void stop();
+
+private Q_SLOTS:
+    void openResponse(uint response, const QVariantMap &results);
+
+private:
+    struct Variant {
+        bool directory = false;
+        bool ask = false;
+        bool writable = false;
+        bool activationToken = false;
+        QString error;
+        LatencyStats token;
+        LatencyStats response;
+        LatencyStats launch;
+        int failures = 0;
+        int missingLaunches = 0;
+    };
+
+    void runNext();
+    void send(const QString &activationToken);
+    void handlerLaunched(const QString &argument, qint64 realtimeNsecs);
+    void finishRun(bool failed);
+    void updateRow(int row);
+    void updateStubButton();
+
+    ParentWindowIdFunction m_parentWindowId;
+    StubHandler *m_stub;
+    /// Whether start() installed the stub, which the end of the run then removes again
+    bool m_stubInstalledForRun = false;
+
+    QCheckBox *m_ask;
+    QCheckBox *m_writable;
+    QCheckBox *m_activationToken;
+    QCheckBox *m_openDirectory;
+    QSpinBox *m_repetitions;
+    QPushButton *m_stubButton;
+    QPushButton *m_startButton;
+    QLabel *m_status;
+    QTableWidget *m_table;
+
+    std::unique_ptr<QTemporaryDir> m_directory;
+    int m_fileCounter = 0;
+
+    QList<Variant> m_variants;
+    int m_currentVariant = -1;
+    int m_currentRepetition = 0;
+    bool m_running = false;
+
+    QString m_requestPath;
+    QString m_expectedFile;
+    QElapsedTimer m_requestClock;
+    qint64 m_sentRealtimeNsecs = 0;
+    bool m_responded = false;
+    bool m_launchSeen = false;
+    QTimer m_timeout;
+
+    QElapsedTimer m_tokenClock;
+    uint m_tokenSerial = 0;
+    bool m_waitingForToken = false;
+};
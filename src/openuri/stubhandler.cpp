@@ -0,0 +1,256 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "stubhandler.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QStandardPaths>
+
+#include <KConfigGroup>
+#include <KLocalizedString>
+#include <KSharedConfig>
+
+#include <time.h>
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+bool writeFile(const QString &path, const QByteArray &contents, QString *error)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate) || file.write(contents) != contents.size()) {
+        *error = i18n("Couldn't write %1: %2", path, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+QString shellQuoted(QString text)
+{
+    return u'\'' + text.replace(u'\'', u"'\\''"_s) + u'\'';
+}
+
+QString genericDataPath(const QString &relative)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + u'/' + relative;
+}
+
+KConfigGroup defaultApplications()
+{
+    return KConfigGroup(KSharedConfig::openConfig(u"mimeapps.list"_s, KConfig::NoGlobals, QStandardPaths::GenericConfigLocation),
+                        u"Default Applications"_s);
+}
+}
+
+StubHandler::StubHandler(const QString &name, const QString &mimeType, const QString &suffix, QObject *parent)
+    : QObject(parent)
+    , m_name(name)
+    , m_mimeType(mimeType)
+    , m_suffix(suffix)
+{
+    m_pollTimer.setInterval(20);
+    connect(&m_pollTimer, &QTimer::timeout, this, &StubHandler::readLog);
+}
+
+QString StubHandler::mimeType() const
+{
+    return m_mimeType;
+}
+
+QString StubHandler::suffix() const
+{
+    return m_suffix;
+}
+
+bool StubHandler::isSchemeHandler() const
+{
+    return m_mimeType.startsWith(u"x-scheme-handler/");
+}
+
+QString StubHandler::dataPath(const QString &fileName) const
+{
+    return genericDataPath(u"xdg-portal-test-kde/%1"_s.arg(fileName));
+}
+
+QString StubHandler::scriptPath() const
+{
+    return dataPath(m_name);
+}
+
+QString StubHandler::logPath() const
+{
+    return dataPath(m_name + u".log"_s);
+}
+
+QString StubHandler::desktopFileName() const
+{
+    return u"org.kde.xdg-portal-test-%1.desktop"_s.arg(m_name);
+}
+
+QString StubHandler::mimePackagePath() const
+{
+    return genericDataPath(u"mime/packages/xdg-portal-test-%1.xml"_s.arg(m_name));
+}
+
+QString StubHandler::previousDefaultPath() const
+{
+    return dataPath(m_name + u".previous-default"_s);
+}
+
+bool StubHandler::isInstalled() const
+{
+    return QFile::exists(genericDataPath(u"applications/"_s + desktopFileName())) && QFile::exists(scriptPath());
+}
+
+bool StubHandler::install(QString *error)
+{
+    // Nothing but date and printf, so the recorded time is close to the exec
+    const QByteArray script = "#!/bin/sh\n"
+                              "# Installed by xdg-portal-test-kde, records when and with what it was started\n"
+                              "printf '%s %s\\n' \"$(date +%s%N)\" \"$1\" >> "
+        + QFile::encodeName(shellQuoted(logPath())) + "\n";
+    if (!writeFile(scriptPath(), script, error)) {
+        return false;
+    }
+    QFile::setPermissions(scriptPath(), QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+
+    const QString desktopFile = u"[Desktop Entry]\n"
+                                u"Type=Application\n"
+                                u"Name=xdg-portal-test %1\n"
+                                u"Exec=\"%2\" %3\n"
+                                u"MimeType=%4;\n"
+                                u"NoDisplay=true\n"_s.arg(m_name, scriptPath(), isSchemeHandler() ? u"%u"_s : u"%f"_s, m_mimeType);
+    if (!writeFile(genericDataPath(u"applications/"_s + desktopFileName()), desktopFile.toUtf8(), error)) {
+        return false;
+    }
+
+    if (isSchemeHandler()) {
+        makeDefault();
+    } else {
+        const QString mimePackage = u"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                                    u"<mime-info xmlns=\"http://www.freedesktop.org/standards/shared-mime-info\">\n"
+                                    u"  <mime-type type=\"%1\">\n"
+                                    u"    <comment>xdg-portal-test stub document</comment>\n"
+                                    u"    <glob pattern=\"*.%2\"/>\n"
+                                    u"  </mime-type>\n"
+                                    u"</mime-info>\n"_s.arg(m_mimeType, m_suffix);
+        if (!writeFile(mimePackagePath(), mimePackage.toUtf8(), error)) {
+            return false;
+        }
+    }
+
+    refreshDatabases();
+    return true;
+}
+
+void StubHandler::uninstall()
+{
+    stopWatching();
+    if (isSchemeHandler()) {
+        restoreDefault();
+    }
+    QFile::remove(genericDataPath(u"applications/"_s + desktopFileName()));
+    QFile::remove(mimePackagePath());
+    QFile::remove(scriptPath());
+    QFile::remove(logPath());
+    refreshDatabases();
+}
+
+void StubHandler::makeDefault()
+{
+    KConfigGroup group = defaultApplications();
+    // Kept on disk, so a crash in between doesn't lose the user's choice
+    if (!QFile::exists(previousDefaultPath())) {
+        QString error;
+        if (!writeFile(previousDefaultPath(), group.readEntry(m_mimeType, QString()).toUtf8(), &error)) {
+            qWarning() << error;
+        }
+    }
+    group.writeXdgListEntry(m_mimeType, {desktopFileName()});
+    group.sync();
+}
+
+void StubHandler::restoreDefault()
+{
+    QFile previous(previousDefaultPath());
+    if (!previous.open(QFile::ReadOnly)) {
+        return;
+    }
+    const QString entry = QString::fromUtf8(previous.readAll());
+    previous.remove();
+
+    KConfigGroup group = defaultApplications();
+    if (entry.isEmpty()) {
+        group.deleteEntry(m_mimeType);
+    } else {
+        group.writeEntry(m_mimeType, entry);
+    }
+    group.sync();
+}
+
+void StubHandler::refreshDatabases()
+{
+    // Whichever of these exist, the backend may look the handler up through any of them
+    const QList<QStringList> commands = {
+        {u"update-mime-database"_s, genericDataPath(u"mime"_s)},
+        {u"update-desktop-database"_s, genericDataPath(u"applications"_s)},
+        {u"kbuildsycoca6"_s},
+    };
+    for (const QStringList &command : commands) {
+        const QString program = QStandardPaths::findExecutable(command.constFirst());
+        if (program.isEmpty()) {
+            continue;
+        }
+        if (QProcess::execute(program, command.mid(1)) != 0) {
+            qWarning() << "Running" << command << "failed";
+        }
+    }
+}
+
+void StubHandler::watch()
+{
+    m_logOffset = QFileInfo(logPath()).size();
+    m_pollTimer.start();
+}
+
+void StubHandler::stopWatching()
+{
+    m_pollTimer.stop();
+}
+
+qint64 StubHandler::realtimeNsecs()
+{
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return qint64(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+void StubHandler::readLog()
+{
+    QFile log(logPath());
+    if (!log.open(QFile::ReadOnly) || log.size() <= m_logOffset) {
+        return;
+    }
+    log.seek(m_logOffset);
+    while (log.canReadLine()) {
+        const QByteArray line = log.readLine().trimmed();
+        const qsizetype space = line.indexOf(' ');
+        if (space < 0) {
+            continue;
+        }
+        bool ok = false;
+        const qint64 started = line.left(space).toLongLong(&ok);
+        if (ok) {
+            Q_EMIT launched(QString::fromUtf8(line.mid(space + 1)), started);
+        }
+    }
+    m_logOffset = log.pos();
+}
@@ -0,0 +1,65 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+
+/**
+ * A local handler installed into the user's data directory: a shell script behind a
+ * .desktop file that appends its CLOCK_REALTIME start time and argument to a log, so the
+ * log tells when a portal backend launched it and with what.
+ *
+ * For a MIME type of its own, a MIME package maps files with the given suffix to it. For
+ * a URL scheme (x-scheme-handler/...) it becomes the default handler instead, until it is
+ * uninstalled and the previous default comes back.
+ */
+class StubHandler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// @p name tells the handler files apart, e.g. "stub-handler"
+    explicit StubHandler(const QString &name, const QString &mimeType, const QString &suffix = QString(), QObject *parent = nullptr);
+
+    QString mimeType() const;
+    /// Files with this suffix open with the stub handler once it is installed, empty for schemes
+    QString suffix() const;
+
+    bool isInstalled() const;
+    /// Writes the handler, .desktop file and MIME package or association and refreshes the databases
+    bool install(QString *error);
+    void uninstall();
+
+    /// Starts following the log, only launches after this are reported
+    void watch();
+    void stopWatching();
+
+    /// CLOCK_REALTIME, the clock the handler records with
+    static qint64 realtimeNsecs();
+
+Q_SIGNALS:
+    void launched(const QString &argument, qint64 realtimeNsecs);
+
+private:
+    bool isSchemeHandler() const;
+    QString dataPath(const QString &relative) const;
+    QString scriptPath() const;
+    QString logPath() const;
+    QString desktopFileName() const;
+    QString mimePackagePath() const;
+    QString previousDefaultPath() const;
+    void makeDefault();
+    void restoreDefault();
+    void readLog();
+    static void refreshDatabases();
+
+    QString m_name;
+    QString m_mimeType;
+    QString m_suffix;
+    QTimer m_pollTimer;
+    qint64 m_logOffset = 0;
+};
@@ -0,0 +1,320 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "parentingstresswindow.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <QWindow>
+
+#include <KLocalizedString>
+#include <KWindowSystem>
+
+#include "portalcommon.h"
+#include "powerprofile/powerprofilewatcher.h"
+#include "xdgexporterv2.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+enum Column {
+    WindowColumn,
+    ParentColumn,
+    HandleColumn,
+    CallColumn,
+    MappedColumn,
+    CloseColumn,
+    ColumnCount,
+};
+
+constexpr int handleTimeout = 10000;
+constexpr int dialogTimeout = 5000;
+// Time for the compositor to activate a window before its dialog is requested
+constexpr int activationDelay = 200;
+
+QString formatLatency(qint64 nsecs)
+{
+    return nsecs < 0 ? QString() : LatencyStats::formatMsecs(nsecs);
+}
+}
+
+ParentingStressWindow::ParentingStressWindow(XdgExporterV2 *exporter, QWidget *parent)
+    : QWidget(parent)
+    , m_exporter(exporter)
+{
+    auto description = new QLabel(i18n("Opens top-level windows, exports each one and opens a FileChooser dialog parented to each in turn, "
+                                       "which is closed again through its request. Also runs headless, see --parenting-stress."));
+    description->setWordWrap(true);
+
+    m_windowCount = new QSpinBox;
+    m_windowCount->setRange(1, 500);
+    m_windowCount->setValue(8);
+    m_startButton = new QPushButton(i18n("Open windows and dialogs"));
+    connect(m_startButton, &QPushButton::clicked, this, [this] {
+        start(m_windowCount->value());
+    });
+    auto closeButton = new QPushButton(i18n("Close windows"));
+    connect(closeButton, &QPushButton::clicked, this, &ParentingStressWindow::closeWindows);
+
+    auto buttons = new QHBoxLayout;
+    buttons->addWidget(new QLabel(i18n("Windows:")));
+    buttons->addWidget(m_windowCount);
+    buttons->addWidget(m_startButton);
+    buttons->addWidget(closeButton);
+    buttons->addStretch();
+
+    m_summary = new QLabel;
+    m_summary->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    m_table = new QTableWidget(0, ColumnCount);
+    m_table->setHorizontalHeaderLabels({i18n("Window"), i18n("Parent"), i18n("Handle (ms)"), i18n("Call (ms)"), i18n("Mapped (ms)"), i18n("Close (ms)")});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(buttons);
+    layout->addWidget(m_summary);
+    layout->addWidget(m_table);
+
+    m_timeout.setSingleShot(true);
+    connect(&m_timeout, &QTimer::timeout, this, [this] {
+        if (m_current < 0) {
+            qWarning() << m_pendingHandles << "windows got no exported handle in time";
+            m_pendingHandles = 0;
+            nextDialog();
+        } else {
+            closeDialog();
+        }
+    });
+
+    m_clock.start();
+    updateSummary();
+}
+
+ParentingStressWindow::~ParentingStressWindow()
+{
+    closeWindows();
+}
+
+void ParentingStressWindow::start(int requested)
+{
+    closeWindows();
+    // Fewer windows open at once while power saving
+    const int windows = PowerProfileWatcher::instance().scaled(requested);
+    m_powerMode = PowerProfileWatcher::instance().modeName();
+    m_handleLatency.clear();
+    m_mappedLatency.clear();
+    m_closeLatency.clear();
+    m_table->setRowCount(windows);
+    m_startButton->setEnabled(false);
+
+    const bool wayland = KWindowSystem::platform() == KWindowSystem::Platform::Wayland;
+    // Set up front, handles may already be known when they are asked for
+    m_pendingHandles = windows;
+    m_timeout.start(handleTimeout);
+    for (int i = 0; i < windows; ++i) {
+        auto widget = new QLabel(i18n("Parenting stress window %1", i + 1));
+        widget->setAlignment(Qt::AlignCenter);
+        widget->resize(320, 120);
+
+        StressWindow window;
+        window.widget = widget;
+        window.shown = m_clock.nsecsElapsed();
+        m_windows.append(window);
+        widget->show();
+        updateRow(i);
+
+        if (wayland) {
+            XdgExportedV2 *exported = m_exporter->exportWidget(widget);
+            m_windows[i].exported = exported;
+            exported->whenHandleReady(this, [this, i](const QString &handle) {
+                handleReady(i, "wayland:"_L1 + handle);
+            });
+        } else {
+            handleReady(i, "x11:"_L1 + QString::number(widget->winId()));
+        }
+    }
+    updateSummary();
+}
+
+void ParentingStressWindow::handleReady(int index, const QString &parentWindow)
+{
+    if (index >= m_windows.size() || m_pendingHandles <= 0) {
+        return;
+    }
+
+    StressWindow &window = m_windows[index];
+    window.parentWindow = parentWindow;
+    window.handleNsecs = m_clock.nsecsElapsed() - window.shown;
+    m_handleLatency.add(window.handleNsecs);
+    updateRow(index);
+
+    if (--m_pendingHandles == 0) {
+        m_timeout.stop();
+        nextDialog();
+    }
+}
+
+void ParentingStressWindow::nextDialog()
+{
+    updateSummary();
+    if (++m_current >= m_windows.size()) {
+        m_current = -1;
+        m_startButton->setEnabled(true);
+        Q_EMIT finished();
+        return;
+    }
+
+    StressWindow &window = m_windows[m_current];
+    if (!window.widget || window.parentWindow.isEmpty()) {
+        nextDialog();
+        return;
+    }
+    window.widget->raise();
+    window.widget->activateWindow();
+
+    QTimer::singleShot(activationDelay, this, [this, index = m_current] {
+        if (index != m_current || !m_windows.at(index).widget) {
+            return;
+        }
+        StressWindow &window = m_windows[index];
+        QWindow *handle = window.widget->windowHandle();
+        window.wasActive = handle && handle->isActive();
+        if (window.wasActive) {
+            m_activeConnection = connect(handle, &QWindow::activeChanged, this, [this, handle] {
+                if (!handle->isActive()) {
+                    dialogMapped();
+                }
+            });
+        }
+
+        const QString token = nextRequestToken();
+        window.request = portalRequestPath(token);
+        QDBusMessage message =
+            QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), u"org.freedesktop.portal.FileChooser"_s, u"OpenFile"_s);
+        message << window.parentWindow << i18n("Parenting stress %1", index + 1) << QVariantMap{{u"handle_token"_s, token}, {u"modal"_s, true}};
+
+        m_dialogStart = m_clock.nsecsElapsed();
+        auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, index](QDBusPendingCallWatcher *watcher) {
+            watcher->deleteLater();
+            if (index >= m_windows.size()) {
+                return;
+            }
+            if (watcher->isError()) {
+                qWarning() << "OpenFile failed:" << watcher->error().message();
+            } else {
+                m_windows[index].callNsecs = m_clock.nsecsElapsed() - m_dialogStart;
+            }
+            updateRow(index);
+        });
+        m_timeout.start(dialogTimeout);
+    });
+}
+
+void ParentingStressWindow::dialogMapped()
+{
+    QObject::disconnect(m_activeConnection);
+    if (m_current < 0) {
+        return;
+    }
+    StressWindow &window = m_windows[m_current];
+    window.mappedNsecs = m_clock.nsecsElapsed() - m_dialogStart;
+    m_mappedLatency.add(window.mappedNsecs);
+    updateRow(m_current);
+    closeDialog();
+}
+
+void ParentingStressWindow::closeDialog()
+{
+    m_timeout.stop();
+    QObject::disconnect(m_activeConnection);
+    if (m_current < 0) {
+        return;
+    }
+
+    const int index = m_current;
+    const qint64 start = m_clock.nsecsElapsed();
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(QDBusMessage::createMethodCall(desktopPortalService(),
+                                                                                                                      m_windows.at(index).request,
+                                                                                                                      portalRequestInterface(),
+                                                                                                                      u"Close"_s)),
+                                               this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, index, start](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (index != m_current) {
+            return;
+        }
+        if (!watcher->isError()) {
+            m_windows[index].closeNsecs = m_clock.nsecsElapsed() - start;
+            m_closeLatency.add(m_windows.at(index).closeNsecs);
+        }
+        updateRow(index);
+        nextDialog();
+    });
+}
+
+void ParentingStressWindow::closeWindows()
+{
+    m_timeout.stop();
+    QObject::disconnect(m_activeConnection);
+    m_current = -1;
+    m_pendingHandles = 0;
+    for (const StressWindow &window : std::as_const(m_windows)) {
+        delete window.widget;
+    }
+    m_windows.clear();
+    m_startButton->setEnabled(true);
+    // The exports go away with their windows' next event loop pass
+    QTimer::singleShot(0, this, &ParentingStressWindow::updateSummary);
+}
+
+void ParentingStressWindow::updateRow(int row)
+{
+    const StressWindow &window = m_windows.at(row);
+    const auto set = [this, row](int column, const QString &text) {
+        m_table->setItem(row, column, new QTableWidgetItem(text));
+    };
+    set(WindowColumn, QString::number(row + 1));
+    set(ParentColumn, window.parentWindow);
+    set(HandleColumn, formatLatency(window.handleNsecs));
+    set(CallColumn, formatLatency(window.callNsecs));
+    set(MappedColumn, window.wasActive || window.callNsecs < 0 ? formatLatency(window.mappedNsecs) : i18n("not activated"));
+    set(CloseColumn, formatLatency(window.closeNsecs));
+}
+
+QString ParentingStressWindow::summary() const
+{
+    int notActivated = 0;
+    for (const StressWindow &window : m_windows) {
+        notActivated += window.callNsecs >= 0 && !window.wasActive;
+    }
+
+    QString summary = i18n("Windows: %1, live exported objects: %2, exports made: %3",
+                           m_windows.size(),
+                           m_exporter->liveExports(),
+                           m_exporter->exportCount())
+        + u'\n';
+    summary += i18n("Handle: %1", m_handleLatency.summary()) + u'\n';
+    summary += i18n("Mapped: %1, not activated: %2", m_mappedLatency.summary(), notActivated) + u'\n';
+    summary += i18n("Close: %1", m_closeLatency.summary()) + u'\n';
+    summary += i18n("Power mode: %1", m_powerMode.isEmpty() ? PowerProfileWatcher::instance().modeName() : m_powerMode);
+    return summary;
+}
+
+void ParentingStressWindow::updateSummary()
+{
+    m_summary->setText(summary());
+}
@@ -0,0 +1,87 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QPointer>
+#include <QTimer>
+#include <QWidget>
+
+#include "benchmark/latencystats.h"
+
+class QLabel;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+class XdgExportedV2;
+class XdgExporterV2;
+
+/**
+ * Opens many top-level windows and parents a portal dialog to each of them in turn.
+ *
+ * Handle latency runs from show() to the xdg-foreign handle. There's no way to see another
+ * client's window map, so the dialog counts as mapped when it takes the activation from its
+ * parent; windows that never got activated report no mapping time.
+ */
+class ParentingStressWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ParentingStressWindow(XdgExporterV2 *exporter, QWidget *parent = nullptr);
+    ~ParentingStressWindow() override;
+
+    QString summary() const;
+
+public Q_SLOTS:
+    /// Opens @p requested windows, a quarter of them while power saving
+    void start(int requested);
+    void closeWindows();
+
+Q_SIGNALS:
+    void finished();
+
+private:
+    struct StressWindow {
+        QPointer<QWidget> widget;
+        QPointer<XdgExportedV2> exported;
+        QString parentWindow;
+        QString request;
+        bool wasActive = false;
+        qint64 shown = 0;
+        qint64 handleNsecs = -1;
+        qint64 callNsecs = -1;
+        qint64 mappedNsecs = -1;
+        qint64 closeNsecs = -1;
+    };
+
+    void handleReady(int index, const QString &parentWindow);
+    void nextDialog();
+    void dialogMapped();
+    void closeDialog();
+    void updateRow(int row);
+    void updateSummary();
+
+    XdgExporterV2 *const m_exporter;
+
+    QSpinBox *m_windowCount;
+    QPushButton *m_startButton;
+    QLabel *m_summary;
+    QTableWidget *m_table;
+
+    QElapsedTimer m_clock;
+    QList<StressWindow> m_windows;
+    QString m_powerMode;
+    int m_pendingHandles = 0;
+    int m_current = -1;
+    qint64 m_dialogStart = 0;
+    QTimer m_timeout;
+    QMetaObject::Connection m_activeConnection;
+    LatencyStats m_handleLatency;
+    LatencyStats m_mappedLatency;
+    LatencyStats m_closeLatency;
+};
@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2016-2022 Red Hat Inc
+ * SPDX-FileContributor: Jan Grulich <jgrulich@redhat.com>
+ */
+
+#pragma once
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QString>
+
+#include <functional>
+
+/// Yields the parent_window identifier of the main window, see XdgPortalTest::parentWindowId()
+using ParentWindowIdFunction = std::function<QString()>;
+
+inline QString desktopPortalService()
+{
+    return QStringLiteral("org.freedesktop.portal.Desktop");
+}
+
+inline QString desktopPortalPath()
+{
+    return QStringLiteral("/org/freedesktop/portal/desktop");
+}
+
+inline QString portalRequestInterface()
+{
+    return QStringLiteral("org.freedesktop.portal.Request");
+}
+
+inline QString portalRequestResponse()
+{
+    return QStringLiteral("Response");
+}
+
+/// handle_token for requests issued outside of XdgPortalTest, which uses its own "u" prefixed counter
+inline QString nextRequestToken()
+{
+    static uint counter = 0;
+    return QStringLiteral("t%1").arg(++counter);
+}
+
+/// Object path of the Request created for @p token, known before the call so Response can't be missed
+inline QString portalRequestPath(const QString &token)
+{
+    QString sender = QDBusConnection::sessionBus().baseService().mid(1);
+    sender.replace(QLatin1Char('.'), QLatin1Char('_'));
+    return QStringLiteral("/org/freedesktop/portal/desktop/request/%1/%2").arg(sender, token);
+}
+
+/// Closes the org.freedesktop.portal.Session at @p sessionHandle without waiting for the reply
+inline void closePortalSession(const QString &sessionHandle)
+{
+    QDBusConnection::sessionBus().asyncCall(
+        QDBusMessage::createMethodCall(desktopPortalService(), sessionHandle, QStringLiteral("org.freedesktop.portal.Session"), QStringLiteral("Close")));
+}
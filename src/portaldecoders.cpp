@@ -0,0 +1,190 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "portaldecoders.h"
+
+#include <QDBusVariant>
+
+using namespace Qt::StringLiterals;
+
+namespace PortalDecoders
+{
+namespace
+{
+/// Calls @p handler for every entry of an a{sv}; the key and variant are reused across entries
+template<typename Handler>
+void forEachEntry(const QDBusArgument &argument, Handler handler)
+{
+    QString key;
+    QDBusVariant value;
+    argument.beginMap();
+    while (!argument.atEnd()) {
+        argument.beginMapEntry();
+        argument >> key >> value;
+        argument.endMapEntry();
+        handler(key, value.variant());
+    }
+    argument.endMap();
+}
+
+/// Reads a two-integer structure such as position (ii) or size (ii)
+std::pair<int, int> intPair(const QVariant &value)
+{
+    int first = 0;
+    int second = 0;
+    const auto argument = value.value<QDBusArgument>();
+    argument.beginStructure();
+    argument >> first >> second;
+    argument.endStructure();
+    return {first, second};
+}
+}
+
+bool decodeStreams(const QDBusArgument &argument, QList<Stream> &streams)
+{
+    if (argument.currentSignature() != "a(ua{sv})"_L1) {
+        return false;
+    }
+
+    qsizetype count = 0;
+    argument.beginArray();
+    while (!argument.atEnd()) {
+        if (count == streams.size()) {
+            streams.emplaceBack();
+        }
+        Stream &stream = streams[count++];
+        stream = {};
+
+        argument.beginStructure();
+        argument >> stream.nodeId;
+        forEachEntry(argument, [&stream](const QString &key, const QVariant &value) {
+            if (key == "id"_L1) {
+                stream.id = value.toString();
+            } else if (key == "position"_L1) {
+                const auto [x, y] = intPair(value);
+                stream.position = QPoint(x, y);
+            } else if (key == "size"_L1) {
+                const auto [width, height] = intPair(value);
+                stream.size = QSize(width, height);
+            } else if (key == "source_type"_L1) {
+                stream.sourceType = value.toUInt();
+            } else if (key == "mapping_id"_L1) {
+                stream.mappingId = value.toString();
+            }
+        });
+        argument.endStructure();
+    }
+    argument.endArray();
+    streams.resize(count);
+    return true;
+}
+
+bool decodeShortcuts(const QDBusArgument &argument, QList<Shortcut> &shortcuts)
+{
+    if (argument.currentSignature() != "a(sa{sv})"_L1) {
+        return false;
+    }
+
+    qsizetype count = 0;
+    argument.beginArray();
+    while (!argument.atEnd()) {
+        if (count == shortcuts.size()) {
+            shortcuts.emplaceBack();
+        }
+        Shortcut &shortcut = shortcuts[count++];
+        shortcut.description.clear();
+        shortcut.triggerDescription.clear();
+
+        argument.beginStructure();
+        argument >> shortcut.id;
+        forEachEntry(argument, [&shortcut](const QString &key, const QVariant &value) {
+            if (key == "description"_L1) {
+                shortcut.description = value.toString();
+            } else if (key == "trigger_description"_L1) {
+                shortcut.triggerDescription = value.toString();
+            }
+        });
+        argument.endStructure();
+    }
+    argument.endArray();
+    shortcuts.resize(count);
+    return true;
+}
+
+bool decodeLocation(const QDBusArgument &argument, Location &location)
+{
+    if (argument.currentSignature() != "a{sv}"_L1) {
+        return false;
+    }
+
+    location = {};
+    forEachEntry(argument, [&location](const QString &key, const QVariant &value) {
+        if (key == "Latitude"_L1) {
+            location.latitude = value.toDouble();
+        } else if (key == "Longitude"_L1) {
+            location.longitude = value.toDouble();
+        } else if (key == "Altitude"_L1) {
+            location.altitude = value.toDouble();
+        } else if (key == "Accuracy"_L1) {
+            location.accuracy = value.toDouble();
+        } else if (key == "Speed"_L1) {
+            location.speed = value.toDouble();
+        } else if (key == "Heading"_L1) {
+            location.heading = value.toDouble();
+        } else if (key == "Description"_L1) {
+            location.description = value.toString();
+        } else if (key == "Timestamp"_L1) {
+            // (tt): seconds and microseconds since the epoch
+            const auto timestamp = value.value<QDBusArgument>();
+            timestamp.beginStructure();
+            timestamp >> location.timestampSeconds >> location.timestampMicroseconds;
+            timestamp.endStructure();
+        }
+    });
+    return true;
+}
+
+void decodePrintSetup(const QVariantMap &results, PrintSetup &setup)
+{
+    setup = {};
+    setup.token = results.value(u"token"_s).toUInt();
+
+    // Each dictionary is optional, a missing or malformed one leaves its defaults in place
+    const auto settings = results.value(u"settings"_s).value<QDBusArgument>();
+    if (settings.currentSignature() == "a{sv}"_L1) {
+        // GTK print settings, every value is a string
+        forEachEntry(settings, [&setup](const QString &key, const QVariant &value) {
+            if (key == "n-copies"_L1) {
+                setup.copies = qMax(1, value.toString().toInt());
+            } else if (key == "page-ranges"_L1) {
+                setup.pageRanges = value.toString();
+            }
+        });
+    }
+
+    const auto pageSetup = results.value(u"page-setup"_s).value<QDBusArgument>();
+    if (pageSetup.currentSignature() == "a{sv}"_L1) {
+        int margins = 0;
+        forEachEntry(pageSetup, [&setup, &margins](const QString &key, const QVariant &value) {
+            if (key == "Orientation"_L1) {
+                setup.orientation = value.toString();
+            } else if (key == "MarginTop"_L1) {
+                setup.marginTop = value.toDouble();
+                ++margins;
+            } else if (key == "MarginBottom"_L1) {
+                setup.marginBottom = value.toDouble();
+                ++margins;
+            } else if (key == "MarginLeft"_L1) {
+                setup.marginLeft = value.toDouble();
+                ++margins;
+            } else if (key == "MarginRight"_L1) {
+                setup.marginRight = value.toDouble();
+                ++margins;
+            }
+        });
+        setup.hasMargins = margins == 4;
+    }
+}
+}
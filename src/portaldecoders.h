@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QDBusArgument>
+#include <QList>
+#include <QPoint>
+#include <QSize>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * Flat decoders for portal results.
+ *
+ * They read straight from the demarshalling QDBusArgument into plain structs,
+ * keep only the keys the portal documents and never build a QVariantMap.
+ * Output lists are overwritten in place so a caller that keeps them around
+ * doesn't reallocate on every response. QDBusArgument can't skip a value, so
+ * unknown entries are still read, into a variant that is reused and dropped.
+ */
+namespace PortalDecoders
+{
+/// One entry of the ScreenCast/RemoteDesktop "streams" result, a(ua{sv})
+struct Stream {
+    uint nodeId = 0;
+    QString id;
+    QPoint position;
+    QSize size;
+    uint sourceType = 0;
+    QString mappingId;
+};
+
+/// One entry of the GlobalShortcuts "shortcuts" result, a(sa{sv})
+struct Shortcut {
+    QString id;
+    QString description;
+    QString triggerDescription;
+};
+
+/// LocationUpdated location, a{sv}
+struct Location {
+    double latitude = 0;
+    double longitude = 0;
+    double altitude = 0;
+    double accuracy = 0;
+    double speed = -1;
+    double heading = -1;
+    QString description;
+    quint64 timestampSeconds = 0;
+    quint64 timestampMicroseconds = 0;
+};
+
+/// The parts of the PreparePrint result this application acts on
+struct PrintSetup {
+    uint token = 0;
+    int copies = 1;
+    QString pageRanges;
+    QString orientation;
+    bool hasMargins = false;
+    double marginTop = 0;
+    double marginBottom = 0;
+    double marginLeft = 0;
+    double marginRight = 0;
+};
+
+/// Returns false if @p argument doesn't have the expected signature, leaving the output untouched
+bool decodeStreams(const QDBusArgument &argument, QList<Stream> &streams);
+bool decodeShortcuts(const QDBusArgument &argument, QList<Shortcut> &shortcuts);
+bool decodeLocation(const QDBusArgument &argument, Location &location);
+/// PreparePrint results arrive as Response(u, a{sv}), whose top level QtDBus has already demarshalled.
+/// Never fails: settings or page-setup that are missing or malformed keep the defaults.
+void decodePrintSetup(const QVariantMap &results, PrintSetup &setup);
+}
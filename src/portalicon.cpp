@@ -0,0 +1,87 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2022 Harald Sitter <sitter@kde.org>
+ */
+
+#include "portalicon.h"
+
+#include <QDBusMetaType>
+#include <QDebug>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace Qt::StringLiterals;
+
+void PortalIcon::registerDBusType()
+{
+    qDBusRegisterMetaType<PortalIcon>();
+}
+
+PortalIcon PortalIcon::fromThemedNames(const QStringList &names)
+{
+    return {u"themed"_s, QDBusVariant(names)};
+}
+
+PortalIcon PortalIcon::fromBytes(const QByteArray &bytes)
+{
+    return {u"bytes"_s, QDBusVariant(bytes)};
+}
+
+PortalIcon PortalIcon::fromFileDescriptor(const QDBusUnixFileDescriptor &descriptor)
+{
+    return {u"file-descriptor"_s, QDBusVariant(QVariant::fromValue(descriptor))};
+}
+
+QDBusUnixFileDescriptor PortalIcon::sealedMemfd(const QByteArray &bytes)
+{
+    const int fd = memfd_create("xdg-portal-test-icon", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        qWarning() << "Couldn't create memfd:" << strerror(errno);
+        return {};
+    }
+
+    qsizetype written = 0;
+    while (written < bytes.size()) {
+        const ssize_t ret = write(fd, bytes.constData() + written, bytes.size() - written);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qWarning() << "Couldn't write icon to memfd:" << strerror(errno);
+            close(fd);
+            return {};
+        }
+        written += ret;
+    }
+
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+        qWarning() << "Couldn't seal memfd:" << strerror(errno);
+        close(fd);
+        return {};
+    }
+    lseek(fd, 0, SEEK_SET);
+
+    QDBusUnixFileDescriptor descriptor;
+    descriptor.giveFileDescriptor(fd);
+    return descriptor;
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const PortalIcon &icon)
+{
+    argument.beginStructure();
+    argument << icon.str << icon.data;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, PortalIcon &icon)
+{
+    argument.beginStructure();
+    argument >> icon.str >> icon.data;
+    argument.endStructure();
+    return argument;
+}
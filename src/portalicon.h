@@ -0,0 +1,30 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2022 Harald Sitter <sitter@kde.org>
+ */
+
+#pragma once
+
+#include <QDBusArgument>
+#include <QDBusUnixFileDescriptor>
+#include <QDBusVariant>
+#include <QStringList>
+
+/// (sv) icon serialization as used by the Notification and DynamicLauncher portals
+struct PortalIcon {
+    QString str;
+    QDBusVariant data;
+
+    static void registerDBusType();
+
+    static PortalIcon fromThemedNames(const QStringList &names);
+    static PortalIcon fromBytes(const QByteArray &bytes);
+    static PortalIcon fromFileDescriptor(const QDBusUnixFileDescriptor &descriptor);
+
+    /// Copies @p bytes into a memfd and seals it against further modification, as the portal requires for "file-descriptor" icons.
+    static QDBusUnixFileDescriptor sealedMemfd(const QByteArray &bytes);
+};
+Q_DECLARE_METATYPE(PortalIcon);
+
+QDBusArgument &operator<<(QDBusArgument &argument, const PortalIcon &icon);
+const QDBusArgument &operator>>(const QDBusArgument &argument, PortalIcon &icon);
@@ -0,0 +1,95 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "powerprofilewatcher.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusVariant>
+
+#include <KLocalizedString>
+
+#include "portalcommon.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+const QString s_interface = u"org.freedesktop.portal.PowerProfileMonitor"_s;
+const QString s_property = u"power-saver-enabled"_s;
+}
+
+PowerProfileWatcher &PowerProfileWatcher::instance()
+{
+    static PowerProfileWatcher watcher;
+    return watcher;
+}
+
+PowerProfileWatcher::PowerProfileWatcher()
+{
+    QDBusConnection::sessionBus().connect(desktopPortalService(),
+                                          desktopPortalPath(),
+                                          u"org.freedesktop.DBus.Properties"_s,
+                                          u"PropertiesChanged"_s,
+                                          this,
+                                          SLOT(propertiesChanged(QString,QVariantMap,QStringList)));
+    read();
+}
+
+void PowerProfileWatcher::read()
+{
+    QDBusMessage message =
+        QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), u"org.freedesktop.DBus.Properties"_s, u"Get"_s);
+    message << s_interface << s_property;
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<QDBusVariant> reply = *watcher;
+        if (reply.isError()) {
+            // Portals before 1.15 have no PowerProfileMonitor, which means full load
+            qDebug() << "Couldn't read power-saver-enabled:" << reply.error().message();
+            return;
+        }
+        const bool enabled = reply.value().variant().toBool();
+        if (enabled != m_powerSaver) {
+            m_powerSaver = enabled;
+            Q_EMIT powerSaverChanged(enabled);
+        }
+    });
+}
+
+bool PowerProfileWatcher::powerSaverEnabled() const
+{
+    return m_powerSaver;
+}
+
+QString PowerProfileWatcher::modeName() const
+{
+    return m_powerSaver ? i18n("power saver") : i18n("normal");
+}
+
+int PowerProfileWatcher::scaled(int full, int minimum) const
+{
+    return m_powerSaver ? qMax(minimum, full / powerSaverDivisor) : full;
+}
+
+void PowerProfileWatcher::propertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated)
+{
+    if (interface != s_interface) {
+        return;
+    }
+    if (invalidated.contains(s_property)) {
+        read();
+        return;
+    }
+    const auto it = changed.constFind(s_property);
+    if (it == changed.constEnd() || it->toBool() == m_powerSaver) {
+        return;
+    }
+    m_powerSaver = it->toBool();
+    Q_EMIT powerSaverChanged(m_powerSaver);
+}
@@ -0,0 +1,46 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVariantMap>
+
+/**
+ * Follows the power-saver-enabled property of org.freedesktop.portal.PowerProfileMonitor,
+ * so that load generators can scale themselves down while power saving is on and results
+ * can record the mode they were taken in.
+ */
+class PowerProfileWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static PowerProfileWatcher &instance();
+
+    bool powerSaverEnabled() const;
+    /// "power saver" or "normal", for result sets
+    QString modeName() const;
+
+    /// @p full scaled down for power saving, never below @p minimum
+    int scaled(int full, int minimum = 1) const;
+
+    /// Frame rate screencast previews are limited to while power saving
+    static constexpr int powerSaverFramerate = 10;
+    /// Share of the full load generators run at while power saving
+    static constexpr int powerSaverDivisor = 4;
+
+Q_SIGNALS:
+    void powerSaverChanged(bool enabled);
+
+private Q_SLOTS:
+    void propertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated);
+
+private:
+    PowerProfileWatcher();
+    void read();
+
+    bool m_powerSaver = false;
+};
@@ -0,0 +1,64 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "inputtargetwindow.h"
+
+#include <QElapsedTimer>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+
+#include <KLocalizedString>
+
+InputTargetWindow::InputTargetWindow(const QElapsedTimer &clock, QWidget *parent)
+    : QWidget(parent)
+    , m_clock(clock)
+{
+    setWindowTitle(i18n("RemoteDesktop Input Target"));
+    setMouseTracking(true);
+    setFocusPolicy(Qt::StrongFocus);
+    setCursor(Qt::CrossCursor);
+}
+
+void InputTargetWindow::mouseMoveEvent(QMouseEvent *event)
+{
+    // Taken first, so that nothing below adds to the latency
+    const qint64 nsecs = m_clock.nsecsElapsed();
+    m_position = event->position();
+    ++m_pointerEvents;
+    Q_EMIT pointerMoved(m_position, nsecs);
+    update();
+}
+
+void InputTargetWindow::keyPressEvent(QKeyEvent *event)
+{
+    const qint64 nsecs = m_clock.nsecsElapsed();
+    if (!event->isAutoRepeat()) {
+        ++m_keyEvents;
+        Q_EMIT keyChanged(event->nativeScanCode(), true, nsecs);
+    }
+}
+
+void InputTargetWindow::keyReleaseEvent(QKeyEvent *event)
+{
+    const qint64 nsecs = m_clock.nsecsElapsed();
+    if (!event->isAutoRepeat()) {
+        ++m_keyEvents;
+        Q_EMIT keyChanged(event->nativeScanCode(), false, nsecs);
+    }
+}
+
+void InputTargetWindow::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+    painter.setPen(palette().text().color());
+    painter.drawText(rect().adjusted(8, 8, -8, -8),
+                     Qt::AlignLeft | Qt::AlignTop,
+                     i18n("Pointer events: %1\nKey events: %2", m_pointerEvents, m_keyEvents));
+    painter.drawLine(QPointF(m_position.x(), 0), QPointF(m_position.x(), height()));
+    painter.drawLine(QPointF(0, m_position.y()), QPointF(width(), m_position.y()));
+}
@@ -0,0 +1,40 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QPointF>
+#include <QWidget>
+
+class QElapsedTimer;
+
+/**
+ * Window that receives injected input and timestamps every pointer motion and key event
+ * against @p clock as soon as Qt delivers it.
+ */
+class InputTargetWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit InputTargetWindow(const QElapsedTimer &clock, QWidget *parent = nullptr);
+
+Q_SIGNALS:
+    void pointerMoved(const QPointF &position, qint64 nsecs);
+    /// @p scanCode is the native one, i.e. the evdev code + 8
+    void keyChanged(quint32 scanCode, bool pressed, qint64 nsecs);
+
+protected:
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void keyReleaseEvent(QKeyEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    const QElapsedTimer &m_clock;
+    QPointF m_position;
+    quint64 m_pointerEvents = 0;
+    quint64 m_keyEvents = 0;
+};
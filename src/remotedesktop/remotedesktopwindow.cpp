@@ -0,0 +1,515 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "remotedesktopwindow.h"
+
+#include <QComboBox>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusObjectPath>
+#include <QDBusPendingCallWatcher>
+#include <QFormLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include "inputtargetwindow.h"
+#include "powerprofile/powerprofilewatcher.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+constexpr uint keyboardDevice = 1;
+constexpr uint pointerDevice = 2;
+
+// KEY_LEFTSHIFT from linux/input-event-codes.h, reported by Qt with the X keycode offset of 8
+constexpr int injectedKey = 42;
+constexpr quint32 injectedScanCode = injectedKey + 8;
+
+constexpr int sweepWidth = 64;
+// Injections that are caught up at once after a late timer
+constexpr int maxBurst = 50;
+constexpr int warmupInterval = 100;
+constexpr int warmupTimeout = 5000;
+// How long deliveries are still waited for after the last injection
+constexpr int drainTime = 500;
+
+QString remoteDesktopInterface()
+{
+    return u"org.freedesktop.portal.RemoteDesktop"_s;
+}
+}
+
+RemoteDesktopWindow::RemoteDesktopWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent)
+    : QWidget(parent)
+    , m_parentWindowId(parentWindowId)
+{
+    auto description = new QLabel(i18n("Injects pointer motion and Left Shift presses through a RemoteDesktop session into a full screen target "
+                                       "window, which timestamps what it receives. Latency runs from sending the call to Qt delivering the event. "
+                                       "Also runs headless, see --remote-desktop."));
+    description->setWordWrap(true);
+
+    m_rate = new QSpinBox;
+    m_rate->setRange(1, 1000);
+    m_rate->setValue(250);
+    m_rate->setSuffix(i18n(" Hz"));
+
+    m_duration = new QSpinBox;
+    m_duration->setRange(1, 600);
+    m_duration->setValue(10);
+    m_duration->setSuffix(i18n(" s"));
+
+    m_mode = new QComboBox;
+    m_mode->addItems({i18n("Pointer motion"), i18n("Keyboard"), i18n("Both, alternating")});
+
+    m_sessionButton = new QPushButton(i18n("Start session"));
+    connect(m_sessionButton, &QPushButton::clicked, this, [this] {
+        if (m_session.isEmpty()) {
+            startSession();
+        } else {
+            closeSession();
+        }
+    });
+    m_runButton = new QPushButton(i18n("Inject"));
+    m_runButton->setEnabled(false);
+    connect(m_runButton, &QPushButton::clicked, this, [this] {
+        if (m_running || m_warmingUp) {
+            stopRun();
+        } else {
+            startRun();
+        }
+    });
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Rate:"), m_rate);
+    form->addRow(i18n("Duration:"), m_duration);
+    form->addRow(i18n("Events:"), m_mode);
+    form->addRow(QString(), m_sessionButton);
+    form->addRow(QString(), m_runButton);
+
+    m_status = new QLabel(i18n("No session"));
+    m_report = new QLabel;
+    m_report->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_report->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_status);
+    layout->addWidget(m_report, 1);
+
+    m_tick.setTimerType(Qt::PreciseTimer);
+    m_tick.setInterval(1);
+    connect(&m_tick, &QTimer::timeout, this, &RemoteDesktopWindow::tick);
+
+    m_drainTimer.setSingleShot(true);
+    connect(&m_drainTimer, &QTimer::timeout, this, &RemoteDesktopWindow::finishRun);
+
+    m_warmupTimer.setInterval(warmupInterval);
+    connect(&m_warmupTimer, &QTimer::timeout, this, [this] {
+        if (m_clock.nsecsElapsed() - m_runStart > qint64(warmupTimeout) * 1000000) {
+            setStatus(i18n("The pointer doesn't reach the target window"));
+            stopRun();
+            Q_EMIT finished();
+            return;
+        }
+        injectMotion();
+    });
+
+    m_reportTimer.setInterval(250);
+    connect(&m_reportTimer, &QTimer::timeout, this, &RemoteDesktopWindow::updateReport);
+
+    m_clock.start();
+}
+
+RemoteDesktopWindow::~RemoteDesktopWindow()
+{
+    closeSession();
+}
+
+void RemoteDesktopWindow::request(const QString &method, const QString &token, const QList<QVariant> &arguments, const char *slot)
+{
+    // Subscribed before the call, so that an immediate Response can't be missed
+    m_requestPath = portalRequestPath(token);
+    QDBusConnection::sessionBus().connect(desktopPortalService(), m_requestPath, portalRequestInterface(), portalRequestResponse(), this, slot);
+
+    QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), remoteDesktopInterface(), method);
+    message.setArguments(arguments);
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, method, slot](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (watcher->isError()) {
+            qWarning() << method << "failed:" << watcher->error().message();
+            finishRequest(slot);
+            sessionFailed(i18n("%1 failed: %2", method, watcher->error().message()));
+        }
+    });
+}
+
+void RemoteDesktopWindow::finishRequest(const char *slot)
+{
+    QDBusConnection::sessionBus().disconnect(desktopPortalService(), m_requestPath, portalRequestInterface(), portalRequestResponse(), this, slot);
+    m_requestPath.clear();
+}
+
+void RemoteDesktopWindow::setStatus(const QString &status)
+{
+    m_status->setText(status);
+}
+
+void RemoteDesktopWindow::startSession()
+{
+    if (!m_session.isEmpty() || !m_requestPath.isEmpty()) {
+        return;
+    }
+    setStatus(i18n("Creating session…"));
+    m_sessionButton->setText(i18n("Close session"));
+    const QString token = nextRequestToken();
+    request(u"CreateSession"_s,
+            token,
+            {QVariantMap{{u"handle_token"_s, token}, {u"session_handle_token"_s, nextRequestToken()}}},
+            SLOT(createSessionResponse(uint,QVariantMap)));
+}
+
+void RemoteDesktopWindow::createSessionResponse(uint response, const QVariantMap &results)
+{
+    finishRequest(SLOT(createSessionResponse(uint,QVariantMap)));
+    if (response != 0) {
+        sessionFailed(i18n("CreateSession was denied: %1", response));
+        return;
+    }
+
+    m_session = results.value(u"session_handle"_s).toString();
+    setStatus(i18n("Selecting devices…"));
+    const QString token = nextRequestToken();
+    request(u"SelectDevices"_s,
+            token,
+            {QVariant::fromValue(QDBusObjectPath(m_session)), QVariantMap{{u"handle_token"_s, token}, {u"types"_s, keyboardDevice | pointerDevice}}},
+            SLOT(selectDevicesResponse(uint,QVariantMap)));
+}
+
+void RemoteDesktopWindow::selectDevicesResponse(uint response, const QVariantMap &results)
+{
+    Q_UNUSED(results)
+    finishRequest(SLOT(selectDevicesResponse(uint,QVariantMap)));
+    if (response != 0 || m_session.isEmpty()) {
+        sessionFailed(i18n("SelectDevices was denied: %1", response));
+        return;
+    }
+
+    setStatus(i18n("Starting session…"));
+    const QString token = nextRequestToken();
+    request(u"Start"_s,
+            token,
+            {QVariant::fromValue(QDBusObjectPath(m_session)), m_parentWindowId(), QVariantMap{{u"handle_token"_s, token}}},
+            SLOT(startResponse(uint,QVariantMap)));
+}
+
+void RemoteDesktopWindow::startResponse(uint response, const QVariantMap &results)
+{
+    finishRequest(SLOT(startResponse(uint,QVariantMap)));
+    if (response != 0 || m_session.isEmpty()) {
+        sessionFailed(i18n("Start was denied: %1", response));
+        return;
+    }
+
+    m_devices = results.value(u"devices"_s).toUInt();
+    QStringList devices;
+    if (m_devices & pointerDevice) {
+        devices.append(i18n("pointer"));
+    }
+    if (m_devices & keyboardDevice) {
+        devices.append(i18n("keyboard"));
+    }
+    setStatus(i18n("Session %1, devices: %2", m_session, devices.join(u", "_s)));
+    m_runButton->setEnabled(true);
+    if (m_runAfterStart) {
+        m_runAfterStart = false;
+        startRun();
+    }
+}
+
+void RemoteDesktopWindow::sessionFailed(const QString &status)
+{
+    closeSession();
+    setStatus(status);
+    if (m_runAfterStart) {
+        m_runAfterStart = false;
+        Q_EMIT finished();
+    }
+}
+
+void RemoteDesktopWindow::closeSession()
+{
+    stopRun();
+    if (!m_session.isEmpty()) {
+        closePortalSession(m_session);
+        m_session.clear();
+    }
+    m_devices = 0;
+    m_runButton->setEnabled(false);
+    m_sessionButton->setText(i18n("Start session"));
+}
+
+QStringList RemoteDesktopWindow::modeNames()
+{
+    return {u"pointer"_s, u"keyboard"_s, u"both"_s};
+}
+
+void RemoteDesktopWindow::runBatch(int rate, const QString &mode)
+{
+    m_rate->setValue(rate);
+    m_mode->setCurrentIndex(qMax(0, modeNames().indexOf(mode)));
+    if (m_devices != 0) {
+        startRun();
+        return;
+    }
+    m_runAfterStart = true;
+    startSession();
+}
+
+void RemoteDesktopWindow::startRun()
+{
+    if (m_session.isEmpty() || m_running || m_warmingUp) {
+        return;
+    }
+
+    m_runMode = Mode(m_mode->currentIndex());
+    if ((m_runMode != Mode::Keyboard && !(m_devices & pointerDevice)) || (m_runMode != Mode::Pointer && !(m_devices & keyboardDevice))) {
+        setStatus(i18n("The session wasn't granted the devices for these events"));
+        Q_EMIT finished();
+        return;
+    }
+
+    // A lower rate while power saving, so the load doesn't fight the profile
+    m_runRate = PowerProfileWatcher::instance().scaled(m_rate->value());
+    m_runPowerMode = PowerProfileWatcher::instance().modeName();
+    m_ticks = 0;
+    m_offset = 0;
+    m_direction = 1;
+    m_hasBaseline = false;
+    m_keyPressed = false;
+    m_pendingMotion.clear();
+    m_pendingKeys.clear();
+    m_pointer = {};
+    m_keyboard = {};
+    m_callLatency.clear();
+    m_callErrors = 0;
+
+    m_target = new InputTargetWindow(m_clock);
+    m_target->setAttribute(Qt::WA_DeleteOnClose);
+    connect(m_target, &InputTargetWindow::pointerMoved, this, &RemoteDesktopWindow::pointerMoved);
+    connect(m_target, &InputTargetWindow::keyChanged, this, &RemoteDesktopWindow::keyChanged);
+    // Full screen, so that the pointer is over it wherever it starts
+    m_target->showFullScreen();
+    m_target->activateWindow();
+
+    m_warmingUp = true;
+    m_runStart = m_clock.nsecsElapsed();
+    m_runButton->setText(i18n("Stop"));
+    m_reportTimer.start();
+    if (m_runMode == Mode::Keyboard) {
+        // Only needs the focus, which the compositor should have handed over by the first tick
+        QTimer::singleShot(warmupInterval, this, [this] {
+            if (!m_warmingUp) {
+                return;
+            }
+            m_warmingUp = false;
+            m_running = true;
+            m_runStart = m_clock.nsecsElapsed();
+            m_runEnd = m_runStart + qint64(m_duration->value()) * 1000000000;
+            m_tick.start();
+        });
+    } else {
+        // The first delivered motion sets the baseline the sweep positions are relative to
+        setStatus(i18n("Waiting for the pointer to reach the target window…"));
+        m_warmupTimer.start();
+    }
+}
+
+void RemoteDesktopWindow::stopRun()
+{
+    m_tick.stop();
+    m_warmupTimer.stop();
+    m_drainTimer.stop();
+    m_reportTimer.stop();
+    if (m_keyPressed) {
+        // Never leave Shift held down
+        injectKey();
+    }
+    const bool wasRunning = m_running || m_warmingUp;
+    if (m_running) {
+        m_runEnd = qMin(m_runEnd, m_clock.nsecsElapsed());
+    }
+    m_running = false;
+    m_warmingUp = false;
+    if (m_target) {
+        m_target->close();
+    }
+    m_runButton->setText(i18n("Inject"));
+    if (wasRunning) {
+        updateReport();
+    }
+}
+
+void RemoteDesktopWindow::tick()
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    if (now >= m_runEnd) {
+        m_tick.stop();
+        if (m_keyPressed) {
+            injectKey();
+        }
+        m_drainTimer.start(drainTime);
+        return;
+    }
+
+    // Timers don't fire every millisecond reliably, late ticks catch up on what is due
+    const quint64 due = quint64(double(now - m_runStart) * m_runRate / 1e9) + 1;
+    for (int burst = 0; m_ticks < due && burst < maxBurst; ++burst, ++m_ticks) {
+        if (m_runMode == Mode::Pointer || (m_runMode == Mode::Both && m_ticks % 2 == 0)) {
+            injectMotion();
+        } else {
+            injectKey();
+        }
+    }
+}
+
+void RemoteDesktopWindow::injectMotion()
+{
+    const int dx = m_direction;
+    m_offset += dx;
+    if (m_offset >= sweepWidth || m_offset <= 0) {
+        m_direction = -m_direction;
+    }
+    ++m_pointer.injected;
+    m_pendingMotion.enqueue({m_offset, m_clock.nsecsElapsed()});
+    call(u"NotifyPointerMotion"_s, {QVariant::fromValue(QDBusObjectPath(m_session)), QVariantMap(), double(dx), 0.0});
+}
+
+void RemoteDesktopWindow::injectKey()
+{
+    m_keyPressed = !m_keyPressed;
+    ++m_keyboard.injected;
+    m_pendingKeys.enqueue({m_keyPressed, m_clock.nsecsElapsed()});
+    call(u"NotifyKeyboardKeycode"_s, {QVariant::fromValue(QDBusObjectPath(m_session)), QVariantMap(), injectedKey, uint(m_keyPressed ? 1 : 0)});
+}
+
+void RemoteDesktopWindow::call(const QString &method, const QList<QVariant> &arguments)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), remoteDesktopInterface(), method);
+    message.setArguments(arguments);
+    const qint64 sent = m_clock.nsecsElapsed();
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, sent](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (watcher->isError()) {
+            if (m_callErrors++ == 0) {
+                qWarning() << "Injection failed:" << watcher->error().message();
+            }
+        } else {
+            m_callLatency.add(m_clock.nsecsElapsed() - sent);
+        }
+    });
+}
+
+void RemoteDesktopWindow::pointerMoved(const QPointF &position, qint64 nsecs)
+{
+    if (m_warmingUp && m_runMode != Mode::Keyboard) {
+        if (m_pendingMotion.isEmpty()) {
+            // Not ours, e.g. from the window appearing under the pointer
+            return;
+        }
+        m_warmupTimer.stop();
+        m_warmingUp = false;
+        m_baseline = position.x() - m_offset;
+        m_hasBaseline = true;
+        m_pendingMotion.clear();
+        m_pointer = {};
+
+        m_running = true;
+        m_runStart = m_clock.nsecsElapsed();
+        m_runEnd = m_runStart + qint64(m_duration->value()) * 1000000000;
+        setStatus(i18n("Injecting at %1 Hz…", m_runRate));
+        m_tick.start();
+        return;
+    }
+    if (!m_hasBaseline || (!m_running && !m_drainTimer.isActive())) {
+        return;
+    }
+
+    const int offset = qRound(position.x() - m_baseline);
+    for (qsizetype i = 0; i < m_pendingMotion.size(); ++i) {
+        if (m_pendingMotion.at(i).offset != offset) {
+            continue;
+        }
+        m_pointer.latency.add(nsecs - m_pendingMotion.at(i).sent);
+        ++m_pointer.delivered;
+        m_pointer.coalesced += i;
+        m_pendingMotion.remove(0, i + 1);
+        return;
+    }
+    // Pointer acceleration or a screen edge got in the way
+    ++m_pointer.unmatched;
+}
+
+void RemoteDesktopWindow::keyChanged(quint32 scanCode, bool pressed, qint64 nsecs)
+{
+    if (scanCode != injectedScanCode || (!m_running && !m_drainTimer.isActive())) {
+        return;
+    }
+    if (m_pendingKeys.isEmpty() || m_pendingKeys.head().pressed != pressed) {
+        ++m_keyboard.unmatched;
+        return;
+    }
+    m_keyboard.latency.add(nsecs - m_pendingKeys.dequeue().sent);
+    ++m_keyboard.delivered;
+}
+
+void RemoteDesktopWindow::finishRun()
+{
+    stopRun();
+    setStatus(i18n("Injected for %1 s", QString::number(double(m_runEnd - m_runStart) / 1e9, 'f', 1)));
+    Q_EMIT finished();
+}
+
+QString RemoteDesktopWindow::summary() const
+{
+    const qint64 elapsed = (m_running ? qMin(m_runEnd, m_clock.nsecsElapsed()) : m_runEnd) - m_runStart;
+    const quint64 injected = m_pointer.injected + m_keyboard.injected;
+    const auto delivery = [](const QString &name, const Delivery &delivery, qsizetype pending) {
+        return i18n("%1: injected %2, delivered %3, coalesced %4, unmatched %5, still pending %6; latency %7",
+                    name,
+                    delivery.injected,
+                    delivery.delivered,
+                    delivery.coalesced,
+                    delivery.unmatched,
+                    pending,
+                    delivery.latency.summary());
+    };
+
+    QString summary = i18n("Rate: %1 Hz requested, %2 Hz achieved",
+                           m_runRate,
+                           QString::number(elapsed > 0 ? double(injected) * 1e9 / double(elapsed) : 0, 'f', 0))
+        + u'\n';
+    if (m_runMode != Mode::Keyboard) {
+        summary += delivery(i18n("Pointer"), m_pointer, m_pendingMotion.size()) + u'\n';
+    }
+    if (m_runMode != Mode::Pointer) {
+        summary += delivery(i18n("Keyboard"), m_keyboard, m_pendingKeys.size()) + u'\n';
+    }
+    summary += i18n("D-Bus round trip: %1, errors: %2", m_callLatency.summary(), m_callErrors) + u'\n';
+    summary += i18n("Power mode: %1", m_runPowerMode.isEmpty() ? PowerProfileWatcher::instance().modeName() : m_runPowerMode);
+    return summary;
+}
+
+void RemoteDesktopWindow::updateReport()
+{
+    m_report->setText(summary());
+}
@@ -0,0 +1,140 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QQueue>
+#include <QTimer>
+#include <QWidget>
+
+#include "benchmark/latencystats.h"
+#include "portalcommon.h"
+
+class InputTargetWindow;
+class QComboBox;
+class QLabel;
+class QPushButton;
+class QSpinBox;
+
+/**
+ * Starts an org.freedesktop.portal.RemoteDesktop session and injects relative pointer
+ * motion and key presses at a fixed rate into a full screen target window, which
+ * timestamps what it receives.
+ *
+ * Pointer motion sweeps back and forth, so a delivered position tells which injection it
+ * belongs to; injections the compositor merged into a later event count as coalesced.
+ * Keys are Left Shift presses and releases, which don't type anything.
+ */
+class RemoteDesktopWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RemoteDesktopWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent = nullptr);
+    ~RemoteDesktopWindow() override;
+
+    QString summary() const;
+    /// Names of the event modes for runBatch(), in the order of the Events combo box
+    static QStringList modeNames();
+
+public Q_SLOTS:
+    void startSession();
+    void closeSession();
+    void startRun();
+    void stopRun();
+    /// Starts a session if needed and runs @p mode, one of modeNames(), at @p rate events per second; emits finished() when done
+    void runBatch(int rate, const QString &mode);
+
+Q_SIGNALS:
+    void finished();
+
+private Q_SLOTS:
+    void createSessionResponse(uint response, const QVariantMap &results);
+    void selectDevicesResponse(uint response, const QVariantMap &results);
+    void startResponse(uint response, const QVariantMap &results);
+
+private:
+    enum class Mode {
+        Pointer,
+        Keyboard,
+        Both,
+    };
+
+    struct PendingMotion {
+        int offset;
+        qint64 sent;
+    };
+
+    struct PendingKey {
+        bool pressed;
+        qint64 sent;
+    };
+
+    struct Delivery {
+        quint64 injected = 0;
+        quint64 delivered = 0;
+        quint64 coalesced = 0;
+        quint64 unmatched = 0;
+        LatencyStats latency;
+    };
+
+    void request(const QString &method, const QString &token, const QList<QVariant> &arguments, const char *slot);
+    void finishRequest(const char *slot);
+    void setStatus(const QString &status);
+    void sessionFailed(const QString &status);
+    void tick();
+    void injectMotion();
+    void injectKey();
+    void call(const QString &method, const QList<QVariant> &arguments);
+    void pointerMoved(const QPointF &position, qint64 nsecs);
+    void keyChanged(quint32 scanCode, bool pressed, qint64 nsecs);
+    void finishRun();
+    void updateReport();
+
+    ParentWindowIdFunction m_parentWindowId;
+
+    QSpinBox *m_rate;
+    QSpinBox *m_duration;
+    QComboBox *m_mode;
+    QPushButton *m_sessionButton;
+    QPushButton *m_runButton;
+    QLabel *m_status;
+    QLabel *m_report;
+    QTimer m_reportTimer;
+
+    QString m_requestPath;
+    QString m_session;
+    uint m_devices = 0;
+    bool m_runAfterStart = false;
+
+    QElapsedTimer m_clock;
+    QPointer<InputTargetWindow> m_target;
+    QTimer m_tick;
+    QTimer m_drainTimer;
+    QTimer m_warmupTimer;
+    bool m_running = false;
+    bool m_warmingUp = false;
+    Mode m_runMode = Mode::Pointer;
+    int m_runRate = 0;
+    QString m_runPowerMode;
+    qint64 m_runStart = 0;
+    qint64 m_runEnd = 0;
+    quint64 m_ticks = 0;
+
+    /// Pointer offset from the baseline the next motion leads to, and its direction
+    int m_offset = 0;
+    int m_direction = 1;
+    qreal m_baseline = 0;
+    bool m_hasBaseline = false;
+    bool m_keyPressed = false;
+    QQueue<PendingMotion> m_pendingMotion;
+    QQueue<PendingKey> m_pendingKeys;
+    Delivery m_pointer;
+    Delivery m_keyboard;
+    LatencyStats m_callLatency;
+    quint64 m_callErrors = 0;
+};
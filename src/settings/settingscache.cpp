@@ -0,0 +1,257 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "settingscache.h"
+
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusError>
+#include <QDBusMessage>
+#include <QDBusVariant>
+#include <QElapsedTimer>
+
+#include "portalcommon.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+QString settingsInterface()
+{
+    return u"org.freedesktop.portal.Settings"_s;
+}
+
+QVariant unwrap(QVariant value)
+{
+    while (value.userType() == qMetaTypeId<QDBusVariant>()) {
+        value = value.value<QDBusVariant>().variant();
+    }
+    return value;
+}
+
+QVariant readValue(const QString &method, const QString &nameSpace, const QString &key, QDBusError *error)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), settingsInterface(), method);
+    message << nameSpace << key;
+    const QDBusMessage reply = QDBusConnection::sessionBus().call(message);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        *error = QDBusError(reply);
+        return {};
+    }
+    return SettingsCache::normalized(reply.arguments().constFirst());
+}
+}
+
+SettingsCache::SettingsCache(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool SettingsCache::load(const QStringList &patterns, QString *error)
+{
+    if (!m_subscribed) {
+        m_subscribed = QDBusConnection::sessionBus().connect(desktopPortalService(),
+                                                             desktopPortalPath(),
+                                                             settingsInterface(),
+                                                             u"SettingChanged"_s,
+                                                             this,
+                                                             SLOT(changed(QDBusMessage)));
+    }
+
+    QString readError;
+    Namespaces namespaces = readAll(patterns, &readError);
+    if (!readError.isEmpty()) {
+        if (error) {
+            *error = readError;
+        }
+        return false;
+    }
+    // Reloading the same namespaces keeps counting the updates applied since they were first loaded
+    if (patterns != m_patterns) {
+        m_changes = 0;
+        m_changeCost.clear();
+    }
+    m_patterns = patterns;
+    m_namespaces = std::move(namespaces);
+    return true;
+}
+
+void SettingsCache::clear()
+{
+    m_patterns.clear();
+    m_namespaces.clear();
+}
+
+QVariant SettingsCache::value(const QString &nameSpace, const QString &key) const
+{
+    const auto it = m_namespaces.constFind(nameSpace);
+    return it == m_namespaces.constEnd() ? QVariant() : it->value(key);
+}
+
+const SettingsCache::Namespaces &SettingsCache::namespaces() const
+{
+    return m_namespaces;
+}
+
+qsizetype SettingsCache::size() const
+{
+    qsizetype size = 0;
+    for (const QVariantMap &values : m_namespaces) {
+        size += values.size();
+    }
+    return size;
+}
+
+quint64 SettingsCache::changes() const
+{
+    return m_changes;
+}
+
+const LatencyStats &SettingsCache::changeCost() const
+{
+    return m_changeCost;
+}
+
+SettingsCache::Namespaces SettingsCache::readAll(const QStringList &patterns, QString *error)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), settingsInterface(), u"ReadAll"_s);
+    message << patterns;
+    const QDBusMessage reply = QDBusConnection::sessionBus().call(message);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        if (error) {
+            *error = reply.errorMessage();
+        }
+        return {};
+    }
+
+    // a{sa{sv}}
+    Namespaces namespaces;
+    const QDBusArgument argument = reply.arguments().constFirst().value<QDBusArgument>();
+    argument.beginMap();
+    while (!argument.atEnd()) {
+        QString nameSpace;
+        QVariantMap values;
+        argument.beginMapEntry();
+        argument >> nameSpace >> values;
+        argument.endMapEntry();
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            *it = normalized(*it);
+        }
+        namespaces.insert(nameSpace, values);
+    }
+    argument.endMap();
+    return namespaces;
+}
+
+QVariant SettingsCache::readOne(const QString &nameSpace, const QString &key, QString *error)
+{
+    QDBusError dbusError;
+    QVariant value = readValue(u"ReadOne"_s, nameSpace, key, &dbusError);
+    if (dbusError.type() == QDBusError::UnknownMethod) {
+        dbusError = {};
+        value = readValue(u"Read"_s, nameSpace, key, &dbusError);
+    }
+    if (dbusError.isValid() && error) {
+        *error = dbusError.message();
+    }
+    return value;
+}
+
+QVariant SettingsCache::normalized(const QVariant &value)
+{
+    const QVariant unwrapped = unwrap(value);
+    if (unwrapped.userType() != qMetaTypeId<QDBusArgument>()) {
+        return unwrapped;
+    }
+
+    const QDBusArgument argument = unwrapped.value<QDBusArgument>();
+    switch (argument.currentType()) {
+    case QDBusArgument::StructureType: {
+        QVariantList fields;
+        argument.beginStructure();
+        while (!argument.atEnd()) {
+            fields.append(normalized(argument.asVariant()));
+        }
+        argument.endStructure();
+        return fields;
+    }
+    case QDBusArgument::ArrayType: {
+        QVariantList elements;
+        argument.beginArray();
+        while (!argument.atEnd()) {
+            elements.append(normalized(argument.asVariant()));
+        }
+        argument.endArray();
+        return elements;
+    }
+    case QDBusArgument::MapType: {
+        QVariantMap entries;
+        argument.beginMap();
+        while (!argument.atEnd()) {
+            argument.beginMapEntry();
+            const QString key = argument.asVariant().toString();
+            entries.insert(key, normalized(argument.asVariant()));
+            argument.endMapEntry();
+        }
+        argument.endMap();
+        return entries;
+    }
+    default:
+        return argument.asVariant();
+    }
+}
+
+QString SettingsCache::format(const QVariant &value)
+{
+    if (value.userType() == QMetaType::QVariantList) {
+        QStringList fields;
+        const QVariantList list = value.toList();
+        for (const QVariant &field : list) {
+            fields.append(format(field));
+        }
+        return u'(' + fields.join(u", "_s) + u')';
+    }
+    if (value.userType() == QMetaType::QVariantMap) {
+        QStringList entries;
+        const QVariantMap map = value.toMap();
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+            entries.append(it.key() + u": "_s + format(it.value()));
+        }
+        return u'{' + entries.join(u", "_s) + u'}';
+    }
+    return value.toString();
+}
+
+bool SettingsCache::matches(const QString &nameSpace) const
+{
+    for (const QString &pattern : m_patterns) {
+        if (pattern.endsWith(u'*') ? nameSpace.startsWith(QStringView(pattern).chopped(1)) : nameSpace == pattern) {
+            return true;
+        }
+    }
+    // An empty list reads everything
+    return m_patterns.isEmpty() && !m_namespaces.isEmpty();
+}
+
+void SettingsCache::changed(const QDBusMessage &message)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const QList<QVariant> arguments = message.arguments();
+    if (arguments.size() != 3) {
+        qWarning() << "Unexpected SettingChanged arguments" << message.signature();
+        return;
+    }
+    const QString nameSpace = arguments.at(0).toString();
+    if (!matches(nameSpace)) {
+        return;
+    }
+    const QString key = arguments.at(1).toString();
+    const QVariant value = normalized(arguments.at(2));
+    m_namespaces[nameSpace].insert(key, value);
+    ++m_changes;
+    m_changeCost.add(timer.nsecsElapsed());
+    Q_EMIT settingChanged(nameSpace, key, value);
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QVariantMap>
+
+#include "benchmark/latencystats.h"
+
+class QDBusMessage;
+
+/**
+ * Local copy of org.freedesktop.portal.Settings namespaces.
+ *
+ * Filled by a single ReadAll and from then on kept in sync through SettingChanged alone,
+ * so reading a setting never costs a D-Bus round trip. Structured values like the accent
+ * color are unpacked into variant lists, which makes them comparable.
+ */
+class SettingsCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Namespaces = QHash<QString, QVariantMap>;
+
+    explicit SettingsCache(QObject *parent = nullptr);
+
+    /// Replaces the cache with the namespaces matching @p patterns, which may end in '*' like for ReadAll
+    bool load(const QStringList &patterns, QString *error = nullptr);
+    void clear();
+
+    QVariant value(const QString &nameSpace, const QString &key) const;
+    const Namespaces &namespaces() const;
+    qsizetype size() const;
+
+    /// SettingChanged signals applied since the current namespaces were first loaded, and the time it took to apply each
+    quint64 changes() const;
+    const LatencyStats &changeCost() const;
+
+    static Namespaces readAll(const QStringList &patterns, QString *error = nullptr);
+    /// Falls back to the deprecated Read on portals older than version 2
+    static QVariant readOne(const QString &nameSpace, const QString &key, QString *error = nullptr);
+    /// Unpacks D-Bus structures, arrays and maps into plain variants
+    static QVariant normalized(const QVariant &value);
+    static QString format(const QVariant &value);
+
+Q_SIGNALS:
+    void settingChanged(const QString &nameSpace, const QString &key, const QVariant &value);
+
+private Q_SLOTS:
+    void changed(const QDBusMessage &message);
+
+private:
+    bool matches(const QString &nameSpace) const;
+
+    QStringList m_patterns;
+    Namespaces m_namespaces;
+    bool m_subscribed = false;
+    quint64 m_changes = 0;
+    LatencyStats m_changeCost;
+};
@@ -0,0 +1,295 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "settingswindow.h"
+
+#include <QElapsedTimer>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include <algorithm>
+#include <tuple>
+
+#include "benchmark/latencystats.h"
+#include "settingscache.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+enum BenchmarkColumn {
+    ApproachColumn,
+    StartupCallsColumn,
+    StartupColumn,
+    LookupColumn,
+    LookupCallsColumn,
+    UpdatesColumn,
+    BenchmarkColumnCount,
+};
+
+enum ValueColumn {
+    NamespaceColumn,
+    KeyColumn,
+    ValueColumn,
+    ValueColumnCount,
+};
+
+struct Setting {
+    QString nameSpace;
+    QString key;
+};
+
+QList<Setting> sortedSettings(const SettingsCache::Namespaces &namespaces)
+{
+    QList<Setting> settings;
+    for (auto it = namespaces.constBegin(); it != namespaces.constEnd(); ++it) {
+        for (auto key = it->constBegin(); key != it->constEnd(); ++key) {
+            settings.append({it.key(), key.key()});
+        }
+    }
+    std::sort(settings.begin(), settings.end(), [](const Setting &a, const Setting &b) {
+        return std::tie(a.nameSpace, a.key) < std::tie(b.nameSpace, b.key);
+    });
+    return settings;
+}
+
+QString formatUsecs(qint64 nsecs)
+{
+    return QString::number(double(nsecs) / 1000.0, 'f', 3);
+}
+}
+
+SettingsWindow::SettingsWindow(QWidget *parent)
+    : QWidget(parent)
+    , m_cache(new SettingsCache(this))
+{
+    auto description = new QLabel(i18n("Startup reads every setting of the namespaces, once with a single ReadAll and once with a ReadOne call "
+                                       "per setting. Lookups then read settings round robin, from the cache that SettingChanged keeps up to "
+                                       "date or with a ReadOne call each."));
+    description->setWordWrap(true);
+
+    m_namespaces = new QLineEdit(u"org.freedesktop.appearance, org.kde.kdeglobals.General, org.kde.kdeglobals.KDE"_s);
+    auto reloadButton = new QPushButton(i18n("Load"));
+    connect(reloadButton, &QPushButton::clicked, this, &SettingsWindow::reload);
+    auto verifyButton = new QPushButton(i18n("Verify against ReadAll"));
+    connect(verifyButton, &QPushButton::clicked, this, &SettingsWindow::verify);
+    auto namespacesLayout = new QHBoxLayout;
+    namespacesLayout->addWidget(m_namespaces);
+    namespacesLayout->addWidget(reloadButton);
+    namespacesLayout->addWidget(verifyButton);
+
+    m_repetitions = new QSpinBox;
+    m_repetitions->setRange(1, 1000);
+    m_repetitions->setValue(10);
+
+    m_lookups = new QSpinBox;
+    m_lookups->setRange(1, 100000);
+    m_lookups->setValue(500);
+
+    m_benchmarkButton = new QPushButton(i18n("Run benchmark"));
+    connect(m_benchmarkButton, &QPushButton::clicked, this, &SettingsWindow::runBenchmark);
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Namespaces:"), namespacesLayout);
+    form->addRow(i18n("Startup repetitions:"), m_repetitions);
+    form->addRow(i18n("Lookups:"), m_lookups);
+    form->addRow(QString(), m_benchmarkButton);
+
+    m_status = new QLabel;
+    m_status->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_status->setWordWrap(true);
+
+    m_benchmarkTable = new QTableWidget(0, BenchmarkColumnCount);
+    m_benchmarkTable->setHorizontalHeaderLabels({i18n("Approach"),
+                                                 i18n("Startup calls"),
+                                                 i18n("Startup p50 (ms)"),
+                                                 i18n("Per lookup (µs)"),
+                                                 i18n("Calls per lookup"),
+                                                 i18n("Updates applied")});
+    m_benchmarkTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_benchmarkTable->horizontalHeader()->setStretchLastSection(true);
+
+    m_valuesTable = new QTableWidget(0, ValueColumnCount);
+    m_valuesTable->setHorizontalHeaderLabels({i18n("Namespace"), i18n("Key"), i18n("Value")});
+    m_valuesTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_valuesTable->horizontalHeader()->setStretchLastSection(true);
+    m_valuesTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_status);
+    layout->addWidget(m_benchmarkTable);
+    layout->addWidget(m_valuesTable, 1);
+
+    // Theme switches change dozens of settings in a burst, redraw once for all of them
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(100);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &SettingsWindow::refresh);
+    connect(m_cache, &SettingsCache::settingChanged, this, &SettingsWindow::scheduleRefresh);
+
+    reload();
+}
+
+QStringList SettingsWindow::patterns() const
+{
+    QStringList patterns = m_namespaces->text().split(u',', Qt::SkipEmptyParts);
+    for (QString &pattern : patterns) {
+        pattern = pattern.trimmed();
+    }
+    return patterns;
+}
+
+void SettingsWindow::reload()
+{
+    QString error;
+    if (!m_cache->load(patterns(), &error)) {
+        m_status->setText(i18n("ReadAll failed: %1", error));
+    }
+    refresh();
+}
+
+void SettingsWindow::runBenchmark()
+{
+    const QStringList patterns = this->patterns();
+    QString error;
+    if (!m_cache->load(patterns, &error)) {
+        m_status->setText(i18n("ReadAll failed: %1", error));
+        return;
+    }
+
+    // The same settings for both approaches, the ones ReadAll returns
+    const QList<Setting> settings = sortedSettings(m_cache->namespaces());
+    if (settings.isEmpty()) {
+        m_status->setText(i18n("The namespaces hold no settings"));
+        return;
+    }
+
+    m_benchmarkButton->setEnabled(false);
+    m_status->setText(i18n("Running…"));
+    QElapsedTimer timer;
+
+    LatencyStats readAllStartup;
+    LatencyStats readOneStartup;
+    int readOneErrors = 0;
+    for (int i = 0; i < m_repetitions->value(); ++i) {
+        timer.start();
+        SettingsCache::readAll(patterns, &error);
+        readAllStartup.add(timer.nsecsElapsed());
+
+        timer.start();
+        for (const Setting &setting : settings) {
+            QString readError;
+            SettingsCache::readOne(setting.nameSpace, setting.key, &readError);
+            readOneErrors += !readError.isEmpty();
+        }
+        readOneStartup.add(timer.nsecsElapsed());
+    }
+
+    const int lookups = m_lookups->value();
+    qsizetype found = 0;
+    timer.start();
+    for (int i = 0; i < lookups; ++i) {
+        const Setting &setting = settings.at(i % settings.size());
+        found += m_cache->value(setting.nameSpace, setting.key).isValid();
+    }
+    const qint64 cachedLookups = timer.nsecsElapsed();
+
+    timer.start();
+    for (int i = 0; i < lookups; ++i) {
+        const Setting &setting = settings.at(i % settings.size());
+        found += SettingsCache::readOne(setting.nameSpace, setting.key).isValid();
+    }
+    const qint64 readOneLookups = timer.nsecsElapsed();
+
+    m_benchmarkTable->setRowCount(2);
+    const auto set = [this](int row, int column, const QString &text) {
+        m_benchmarkTable->setItem(row, column, new QTableWidgetItem(text));
+    };
+    set(0, ApproachColumn, i18n("ReadAll and cache"));
+    set(0, StartupCallsColumn, QString::number(1));
+    set(0, StartupColumn, LatencyStats::formatMsecs(readAllStartup.percentile(0.5)));
+    set(0, LookupColumn, formatUsecs(cachedLookups / lookups));
+    set(0, LookupCallsColumn, QString::number(0));
+    set(0,
+        UpdatesColumn,
+        i18n("%1 since loading, %2 µs each", m_cache->changes(), m_cache->changeCost().count() > 0 ? formatUsecs(m_cache->changeCost().mean()) : u"-"_s));
+    set(1, ApproachColumn, i18n("ReadOne per setting"));
+    set(1, StartupCallsColumn, QString::number(settings.size()));
+    set(1, StartupColumn, LatencyStats::formatMsecs(readOneStartup.percentile(0.5)));
+    set(1, LookupColumn, formatUsecs(readOneLookups / lookups));
+    set(1, LookupCallsColumn, QString::number(1));
+    set(1, UpdatesColumn, i18n("not needed"));
+    m_benchmarkTable->resizeColumnsToContents();
+
+    const qint64 saved = readOneStartup.percentile(0.5) - readAllStartup.percentile(0.5) + (readOneLookups - cachedLookups);
+    QString status = i18n("%1 settings in %2 namespaces; caching saves %3 ms at startup and over the %4 lookups",
+                          settings.size(),
+                          m_cache->namespaces().size(),
+                          LatencyStats::formatMsecs(saved),
+                          lookups);
+    if (readOneErrors > 0) {
+        status += u'\n' + i18n("%1 ReadOne calls failed", readOneErrors);
+    }
+    if (found != 2 * qsizetype(lookups)) {
+        status += u'\n' + i18n("%1 lookups found no value", 2 * qsizetype(lookups) - found);
+    }
+    m_status->setText(status);
+    m_benchmarkButton->setEnabled(true);
+    refresh();
+}
+
+void SettingsWindow::verify()
+{
+    QString error;
+    const SettingsCache::Namespaces fresh = SettingsCache::readAll(patterns(), &error);
+    if (!error.isEmpty()) {
+        m_status->setText(i18n("ReadAll failed: %1", error));
+        return;
+    }
+
+    int mismatches = 0;
+    for (auto it = fresh.constBegin(); it != fresh.constEnd(); ++it) {
+        for (auto key = it->constBegin(); key != it->constEnd(); ++key) {
+            if (m_cache->value(it.key(), key.key()) != key.value()) {
+                qWarning() << "Cached setting differs:" << it.key() << key.key() << m_cache->value(it.key(), key.key()) << key.value();
+                ++mismatches;
+            }
+        }
+    }
+    m_status->setText(mismatches == 0 ? i18n("The cache matches ReadAll after %1 updates", m_cache->changes())
+                                      : i18np("%1 setting differs from ReadAll", "%1 settings differ from ReadAll", mismatches));
+}
+
+void SettingsWindow::scheduleRefresh()
+{
+    if (!m_refreshTimer.isActive()) {
+        m_refreshTimer.start();
+    }
+}
+
+void SettingsWindow::refresh()
+{
+    const QList<Setting> settings = sortedSettings(m_cache->namespaces());
+
+    m_valuesTable->setRowCount(settings.size());
+    for (int row = 0; row < settings.size(); ++row) {
+        const Setting &setting = settings.at(row);
+        m_valuesTable->setItem(row, NamespaceColumn, new QTableWidgetItem(setting.nameSpace));
+        m_valuesTable->setItem(row, KeyColumn, new QTableWidgetItem(setting.key));
+        m_valuesTable->setItem(row, ValueColumn, new QTableWidgetItem(SettingsCache::format(m_cache->value(setting.nameSpace, setting.key))));
+    }
+    m_valuesTable->resizeColumnToContents(NamespaceColumn);
+    m_valuesTable->resizeColumnToContents(KeyColumn);
+}
@@ -0,0 +1,50 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QWidget>
+
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+class SettingsCache;
+
+/**
+ * Shows the cached Settings namespaces as SettingChanged keeps them up to date, and
+ * compares what an application pays for its settings with one ReadAll plus the cache
+ * against a ReadOne call per setting, both at startup and for every later lookup.
+ */
+class SettingsWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SettingsWindow(QWidget *parent = nullptr);
+
+public Q_SLOTS:
+    void reload();
+    void runBenchmark();
+    void verify();
+
+private:
+    QStringList patterns() const;
+    void scheduleRefresh();
+    void refresh();
+
+    SettingsCache *m_cache;
+
+    QLineEdit *m_namespaces;
+    QSpinBox *m_repetitions;
+    QSpinBox *m_lookups;
+    QPushButton *m_benchmarkButton;
+    QLabel *m_status;
+    QTableWidget *m_benchmarkTable;
+    QTableWidget *m_valuesTable;
+    QTimer m_refreshTimer;
+};
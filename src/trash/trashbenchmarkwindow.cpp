@@ -0,0 +1,316 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "trashbenchmarkwindow.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusUnixFileDescriptor>
+#include <QDir>
+#include <QFile>
+#include <QFont>
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+#include "portalcommon.h"
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+enum Column {
+    DepthColumn,
+    TrashedColumn,
+    FailedColumn,
+    TotalColumn,
+    RateColumn,
+    SpeedupColumn,
+    MedianColumn,
+    TailColumn,
+    MaxColumn,
+    ColumnCount,
+};
+
+double filesPerSecond(qsizetype files, qint64 nsecs)
+{
+    return nsecs > 0 ? double(files) * 1e9 / double(nsecs) : 0;
+}
+}
+
+TrashBenchmarkWindow::TrashBenchmarkWindow(QWidget *parent)
+    : QWidget(parent)
+{
+    auto description = new QLabel(i18n("Creates a tree of empty files and trashes them one TrashFile call per file, with up to the given number "
+                                       "of calls in flight. The files really end up in the trash, named xdg-portal-test-trash-*."));
+    description->setWordWrap(true);
+
+    m_fileCount = new QSpinBox;
+    m_fileCount->setRange(1, 100000);
+    m_fileCount->setValue(2000);
+
+    m_filesPerDirectory = new QSpinBox;
+    m_filesPerDirectory->setRange(1, 100000);
+    m_filesPerDirectory->setValue(100);
+
+    m_depths = new QLineEdit(u"1,2,4,8,16,32,64,128,256"_s);
+
+    m_startButton = new QPushButton(i18n("Run"));
+    connect(m_startButton, &QPushButton::clicked, this, [this] {
+        if (m_running) {
+            stop();
+        } else {
+            start();
+        }
+    });
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Files:"), m_fileCount);
+    form->addRow(i18n("Files per directory:"), m_filesPerDirectory);
+    form->addRow(i18n("Calls in flight:"), m_depths);
+    form->addRow(QString(), m_startButton);
+
+    m_status = new QLabel;
+    m_status->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_status->setWordWrap(true);
+
+    m_table = new QTableWidget(0, ColumnCount);
+    m_table->setHorizontalHeaderLabels({i18n("In flight"),
+                                        i18n("Trashed"),
+                                        i18n("Failed"),
+                                        i18n("Total (s)"),
+                                        i18n("Files/s"),
+                                        i18n("Speedup"),
+                                        i18n("Call p50 (ms)"),
+                                        i18n("Call p99 (ms)"),
+                                        i18n("Call max (ms)")});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_status);
+    layout->addWidget(m_table);
+}
+
+TrashBenchmarkWindow::~TrashBenchmarkWindow()
+{
+    stop();
+}
+
+bool TrashBenchmarkWindow::createFixture(int count)
+{
+    m_directory = std::make_unique<QTemporaryDir>();
+    m_files.clear();
+    m_files.reserve(count);
+    const int perDirectory = m_filesPerDirectory->value();
+    QDir directory(m_directory->path());
+    for (int i = 0; i < count; ++i) {
+        const QString subdirectory = u"dir%1"_s.arg(i / perDirectory);
+        if (i % perDirectory == 0 && !directory.mkdir(subdirectory)) {
+            qWarning() << "Couldn't create" << directory.filePath(subdirectory);
+            return false;
+        }
+        const QString path = directory.filePath(u"%1/xdg-portal-test-trash-%2"_s.arg(subdirectory).arg(i));
+        QFile file(path);
+        if (!file.open(QFile::WriteOnly)) {
+            qWarning() << "Couldn't create" << path << file.errorString();
+            return false;
+        }
+        m_files.append(path);
+    }
+    return true;
+}
+
+void TrashBenchmarkWindow::start()
+{
+    m_steps.clear();
+    const QStringList depths = m_depths->text().split(u',', Qt::SkipEmptyParts);
+    for (const QString &text : depths) {
+        bool ok = false;
+        const int depth = text.trimmed().toInt(&ok);
+        if (ok && depth > 0) {
+            Step step;
+            step.depth = depth;
+            m_steps.append(step);
+        }
+    }
+    if (m_steps.isEmpty()) {
+        return;
+    }
+
+    m_table->setRowCount(m_steps.size());
+    for (int row = 0; row < m_steps.size(); ++row) {
+        updateRow(row);
+    }
+    m_currentStep = -1;
+    m_running = true;
+    ++m_generation;
+    m_startButton->setText(i18n("Stop"));
+    QTimer::singleShot(0, this, &TrashBenchmarkWindow::runNext);
+}
+
+void TrashBenchmarkWindow::stop()
+{
+    // Calls still in flight finish into the void
+    m_running = false;
+    ++m_generation;
+    m_currentStep = -1;
+    m_inFlight = 0;
+    m_startButton->setText(i18n("Run"));
+}
+
+void TrashBenchmarkWindow::runNext()
+{
+    if (!m_running) {
+        return;
+    }
+    ++m_currentStep;
+    if (m_currentStep >= m_steps.size()) {
+        finish();
+        return;
+    }
+
+    Step &step = m_steps[m_currentStep];
+    m_status->setText(i18n("Creating %1 files…", m_fileCount->value()));
+    if (!createFixture(m_fileCount->value())) {
+        step.error = i18n("Couldn't create the files");
+        updateRow(m_currentStep);
+        finish();
+        return;
+    }
+
+    m_status->setText(i18n("Trashing %1 files, %2 in flight", m_files.size(), step.depth));
+    m_nextFile = 0;
+    m_inFlight = 0;
+    m_stepClock.start();
+    fill();
+}
+
+void TrashBenchmarkWindow::fill()
+{
+    const int step = m_currentStep;
+    const uint generation = m_generation;
+    while (m_inFlight < m_steps.at(step).depth && m_nextFile < m_files.size()) {
+        const QString &path = m_files.at(m_nextFile++);
+        QFile file(path);
+        if (!file.open(QFile::ReadOnly)) {
+            qWarning() << "Couldn't open" << path << file.errorString();
+            ++m_steps[step].failed;
+            continue;
+        }
+
+        QDBusMessage message =
+            QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), u"org.freedesktop.portal.Trash"_s, u"TrashFile"_s);
+        // QDBusUnixFileDescriptor holds a duplicate, the file can close right away
+        message << QVariant::fromValue(QDBusUnixFileDescriptor(file.handle()));
+        const qint64 sent = m_stepClock.nsecsElapsed();
+        auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, step, generation, sent](QDBusPendingCallWatcher *watcher) {
+            watcher->deleteLater();
+            if (generation != m_generation || step != m_currentStep) {
+                return;
+            }
+            Step &current = m_steps[step];
+            current.latency.add(m_stepClock.nsecsElapsed() - sent);
+            QDBusPendingReply<uint> reply = *watcher;
+            if (reply.isError()) {
+                if (current.error.isEmpty()) {
+                    current.error = reply.error().message();
+                    qWarning() << "TrashFile failed:" << current.error;
+                }
+                ++current.failed;
+            } else if (reply.value() != 1) {
+                ++current.failed;
+            } else {
+                ++current.trashed;
+            }
+            --m_inFlight;
+            if (m_inFlight == 0 && m_nextFile >= m_files.size()) {
+                finishStep();
+            } else {
+                fill();
+            }
+        });
+        ++m_inFlight;
+    }
+    if (m_inFlight == 0 && m_nextFile >= m_files.size()) {
+        finishStep();
+    }
+}
+
+void TrashBenchmarkWindow::finishStep()
+{
+    m_steps[m_currentStep].totalNsecs = m_stepClock.nsecsElapsed();
+    updateRow(m_currentStep);
+    // Leaves the reply dispatch before creating the next tree
+    QTimer::singleShot(0, this, &TrashBenchmarkWindow::runNext);
+}
+
+void TrashBenchmarkWindow::updateRow(int row)
+{
+    const Step &step = m_steps.at(row);
+    const auto set = [this, row](int column, const QString &text) {
+        m_table->setItem(row, column, new QTableWidgetItem(text));
+    };
+    const bool done = step.totalNsecs > 0;
+    const double rate = filesPerSecond(step.trashed, step.totalNsecs);
+
+    set(DepthColumn, QString::number(step.depth));
+    set(TrashedColumn, done ? QString::number(step.trashed) : QString());
+    set(FailedColumn, step.error.isEmpty() ? (done ? QString::number(step.failed) : QString()) : step.error);
+    set(TotalColumn, done ? QString::number(double(step.totalNsecs) / 1e9, 'f', 2) : QString());
+    set(RateColumn, done ? QString::number(rate, 'f', 0) : QString());
+    // Against the first depth, normally a single call in flight
+    const Step &baseline = m_steps.constFirst();
+    const double baselineRate = filesPerSecond(baseline.trashed, baseline.totalNsecs);
+    set(SpeedupColumn, done && baselineRate > 0 ? u"%1×"_s.arg(rate / baselineRate, 0, 'f', 2) : QString());
+    set(MedianColumn, step.latency.count() > 0 ? LatencyStats::formatMsecs(step.latency.percentile(0.5)) : QString());
+    set(TailColumn, step.latency.count() > 0 ? LatencyStats::formatMsecs(step.latency.percentile(0.99)) : QString());
+    set(MaxColumn, step.latency.count() > 0 ? LatencyStats::formatMsecs(step.latency.max()) : QString());
+}
+
+void TrashBenchmarkWindow::finish()
+{
+    stop();
+    m_directory.reset();
+    m_files.clear();
+
+    int best = -1;
+    double bestRate = 0;
+    for (int row = 0; row < m_steps.size(); ++row) {
+        const Step &step = m_steps.at(row);
+        const double rate = filesPerSecond(step.trashed, step.totalNsecs);
+        if (rate > bestRate) {
+            best = row;
+            bestRate = rate;
+        }
+    }
+    if (best < 0) {
+        m_status->setText(i18n("Nothing was trashed"));
+        return;
+    }
+
+    for (int column = 0; column < ColumnCount; ++column) {
+        if (QTableWidgetItem *item = m_table->item(best, column)) {
+            QFont font = item->font();
+            font.setBold(true);
+            item->setFont(font);
+        }
+    }
+    m_status->setText(i18n("Highest throughput with %1 calls in flight: %2 files/s", m_steps.at(best).depth, QString::number(bestRate, 'f', 0)));
+}
@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QWidget>
+
+#include <memory>
+
+#include "benchmark/latencystats.h"
+
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+class QTemporaryDir;
+
+/**
+ * Trashes a generated tree of files through org.freedesktop.portal.Trash, which takes one
+ * fd per TrashFile call, keeping a bounded number of calls in flight.
+ *
+ * Every pipeline depth gets a fresh tree; throughput is reported in files per second
+ * together with the per call latency, whose tail grows once the depth exceeds what the
+ * backend processes concurrently.
+ */
+class TrashBenchmarkWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TrashBenchmarkWindow(QWidget *parent = nullptr);
+    ~TrashBenchmarkWindow() override;
+
+public Q_SLOTS:
+    void start();
+    void stop();
+
+private:
+    struct Step {
+        int depth = 0;
+        int trashed = 0;
+        int failed = 0;
+        qint64 totalNsecs = 0;
+        QString error;
+        LatencyStats latency;
+    };
+
+    bool createFixture(int count);
+    void runNext();
+    void fill();
+    void finishStep();
+    void updateRow(int row);
+    void finish();
+
+    QSpinBox *m_fileCount;
+    QSpinBox *m_filesPerDirectory;
+    QLineEdit *m_depths;
+    QPushButton *m_startButton;
+    QLabel *m_status;
+    QTableWidget *m_table;
+
+    std::unique_ptr<QTemporaryDir> m_directory;
+    QStringList m_files;
+
+    QList<Step> m_steps;
+    int m_currentStep = -1;
+    int m_nextFile = 0;
+    int m_inFlight = 0;
+    bool m_running = false;
+    /// Bumped per run and by stop(), so that replies from an earlier run are recognized
+    uint m_generation = 0;
+    QElapsedTimer m_stepClock;
+};
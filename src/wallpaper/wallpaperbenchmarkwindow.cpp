@@ -0,0 +1,365 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#include "wallpaperbenchmarkwindow.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusUnixFileDescriptor>
+#include <QFile>
+#include <QFileInfo>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QImage>
+#include <QImageWriter>
+#include <QLabel>
+#include <QLineEdit>
+#include <QLinearGradient>
+#include <QLocale>
+#include <QPainter>
+#include <QPushButton>
+#include <QRegularExpression>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QTemporaryDir>
+#include <QVBoxLayout>
+
+#include <KLocalizedString>
+
+using namespace Qt::StringLiterals;
+
+namespace
+{
+enum Column {
+    ResolutionColumn,
+    FileSizeColumn,
+    EncodeColumn,
+    PreviewColumn,
+    CallColumn,
+    AcceptedColumn,
+    AcceptedTailColumn,
+    FailuresColumn,
+    ColumnCount,
+};
+
+constexpr int responseTimeout = 30000;
+// The preview waits for somebody to confirm it
+constexpr int previewResponseTimeout = 120000;
+constexpr int callFailed = -1;
+constexpr int timedOut = -2;
+}
+
+WallpaperBenchmarkWindow::WallpaperBenchmarkWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent)
+    : QWidget(parent)
+    , m_parentWindowId(parentWindowId)
+{
+    auto description = new QLabel(i18n("Generates a wallpaper per resolution and sets it through SetWallpaperFile, passing a file descriptor. "
+                                       "This really changes the wallpaper. Acceptance runs until the backend responds; with the preview it "
+                                       "includes confirming the dialog."));
+    description->setWordWrap(true);
+
+    m_resolutions = new QLineEdit(u"1920x1080, 3840x2160, 7680x4320, 11520x2160, 15360x8640"_s);
+
+    m_format = new QComboBox;
+    m_format->addItems({u"png"_s, u"jpg"_s, u"webp"_s});
+
+    m_setOn = new QComboBox;
+    m_setOn->addItem(i18n("Background"), u"background"_s);
+    m_setOn->addItem(i18n("Lock screen"), u"lockscreen"_s);
+    m_setOn->addItem(i18n("Both"), u"both"_s);
+
+    m_withoutPreview = new QCheckBox(i18n("Without preview"));
+    m_withoutPreview->setChecked(true);
+    m_withPreview = new QCheckBox(i18n("With preview"));
+    auto variants = new QHBoxLayout;
+    variants->addWidget(m_withoutPreview);
+    variants->addWidget(m_withPreview);
+    variants->addStretch();
+
+    m_repetitions = new QSpinBox;
+    m_repetitions->setRange(1, 100);
+    m_repetitions->setValue(3);
+
+    m_startButton = new QPushButton(i18n("Run"));
+    connect(m_startButton, &QPushButton::clicked, this, [this] {
+        if (m_running) {
+            stop();
+        } else {
+            start();
+        }
+    });
+
+    auto form = new QFormLayout;
+    form->addRow(i18n("Resolutions:"), m_resolutions);
+    form->addRow(i18n("Format:"), m_format);
+    form->addRow(i18n("Set on:"), m_setOn);
+    form->addRow(i18n("Variants:"), variants);
+    form->addRow(i18n("Repetitions:"), m_repetitions);
+    form->addRow(QString(), m_startButton);
+
+    m_status = new QLabel;
+    m_status->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    m_table = new QTableWidget(0, ColumnCount);
+    m_table->setHorizontalHeaderLabels({i18n("Resolution"),
+                                        i18n("File"),
+                                        i18n("Encode (ms)"),
+                                        i18n("Preview"),
+                                        i18n("Call p50 (ms)"),
+                                        i18n("Accepted p50 (ms)"),
+                                        i18n("Accepted max (ms)"),
+                                        i18n("Failed / timed out")});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(description);
+    layout->addLayout(form);
+    layout->addWidget(m_status);
+    layout->addWidget(m_table, 1);
+
+    m_timeout.setSingleShot(true);
+    connect(&m_timeout, &QTimer::timeout, this, [this] {
+        // Dismisses a preview nobody confirmed
+        QDBusConnection::sessionBus().asyncCall(
+            QDBusMessage::createMethodCall(desktopPortalService(), m_requestPath, portalRequestInterface(), u"Close"_s));
+        finishRequest(timedOut);
+    });
+}
+
+WallpaperBenchmarkWindow::~WallpaperBenchmarkWindow()
+{
+    stop();
+}
+
+QString WallpaperBenchmarkWindow::imageFile(const QSize &size, qint64 *encodeNsecs)
+{
+    const QString format = m_format->currentText();
+    const QString key = u"%1x%2.%3"_s.arg(size.width()).arg(size.height()).arg(format);
+    if (const auto it = m_files.constFind(key); it != m_files.constEnd()) {
+        if (encodeNsecs) {
+            *encodeNsecs = it->second;
+        }
+        return it->first;
+    }
+
+    if (!m_directory) {
+        m_directory = std::make_unique<QTemporaryDir>();
+    }
+    QImage image(size, QImage::Format_RGB32);
+    if (image.isNull()) {
+        qWarning() << "Couldn't allocate a wallpaper of" << size;
+        return {};
+    }
+    {
+        // A gradient with some structure, so encoders can't collapse it to nothing
+        QPainter painter(&image);
+        QLinearGradient gradient(0, 0, size.width(), size.height());
+        gradient.setColorAt(0, QColor(0x1d, 0x99, 0xf3));
+        gradient.setColorAt(1, QColor(0x23, 0x26, 0x29));
+        painter.fillRect(image.rect(), gradient);
+        painter.setPen(Qt::white);
+        for (int x = 0; x < size.width(); x += 97) {
+            painter.drawLine(x, 0, size.width() - x, size.height());
+        }
+    }
+
+    const QString fileName = m_directory->filePath(key);
+    QElapsedTimer timer;
+    timer.start();
+    QImageWriter writer(fileName);
+    if (!writer.write(image)) {
+        qWarning() << "Couldn't write" << fileName << writer.errorString();
+        return {};
+    }
+    const qint64 encoded = timer.nsecsElapsed();
+    if (encodeNsecs) {
+        *encodeNsecs = encoded;
+    }
+    m_files.insert(key, {fileName, encoded});
+    return fileName;
+}
+
+void WallpaperBenchmarkWindow::start()
+{
+    QList<bool> previews;
+    if (m_withoutPreview->isChecked()) {
+        previews.append(false);
+    }
+    if (m_withPreview->isChecked()) {
+        previews.append(true);
+    }
+
+    m_steps.clear();
+    static const QRegularExpression resolution(u"^\\s*(\\d+)\\s*x\\s*(\\d+)\\s*$"_s);
+    const QStringList resolutions = m_resolutions->text().split(u',', Qt::SkipEmptyParts);
+    for (const QString &text : resolutions) {
+        const QRegularExpressionMatch match = resolution.match(text);
+        const QSize size(match.captured(1).toInt(), match.captured(2).toInt());
+        if (!match.hasMatch() || size.isEmpty()) {
+            continue;
+        }
+        for (const bool preview : std::as_const(previews)) {
+            Step step;
+            step.size = size;
+            step.preview = preview;
+            m_steps.append(step);
+        }
+    }
+    if (m_steps.isEmpty()) {
+        return;
+    }
+
+    m_table->setRowCount(m_steps.size());
+    for (int row = 0; row < m_steps.size(); ++row) {
+        Step &step = m_steps[row];
+        m_status->setText(i18n("Generating %1×%2…", step.size.width(), step.size.height()));
+        step.fileName = imageFile(step.size, &step.encodeNsecs);
+        step.fileBytes = QFileInfo(step.fileName).size();
+        updateRow(row);
+    }
+
+    m_currentStep = 0;
+    m_currentRepetition = 0;
+    m_running = true;
+    m_startButton->setText(i18n("Stop"));
+    runNext();
+}
+
+void WallpaperBenchmarkWindow::stop()
+{
+    if (!m_requestPath.isEmpty()) {
+        QDBusConnection::sessionBus().disconnect(desktopPortalService(),
+                                                 m_requestPath,
+                                                 portalRequestInterface(),
+                                                 portalRequestResponse(),
+                                                 this,
+                                                 SLOT(wallpaperResponse(uint,QVariantMap)));
+        m_requestPath.clear();
+    }
+    m_timeout.stop();
+    m_running = false;
+    m_currentStep = -1;
+    m_startButton->setText(i18n("Run"));
+}
+
+void WallpaperBenchmarkWindow::runNext()
+{
+    if (!m_running) {
+        return;
+    }
+    if (m_currentRepetition >= m_repetitions->value()) {
+        m_currentRepetition = 0;
+        ++m_currentStep;
+    }
+    if (m_currentStep >= m_steps.size()) {
+        stop();
+        m_status->setText(i18n("Finished"));
+        return;
+    }
+
+    const Step &step = m_steps.at(m_currentStep);
+    QFile file(step.fileName);
+    if (step.fileName.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+        m_currentRepetition = m_repetitions->value();
+        m_steps[m_currentStep].failures = m_repetitions->value();
+        updateRow(m_currentStep);
+        runNext();
+        return;
+    }
+    m_status->setText(i18n("%1×%2, %3, run %4 of %5",
+                           step.size.width(),
+                           step.size.height(),
+                           step.preview ? i18n("with preview") : i18n("without preview"),
+                           m_currentRepetition + 1,
+                           m_repetitions->value()));
+
+    const QString token = nextRequestToken();
+    m_requestPath = portalRequestPath(token);
+    QDBusConnection::sessionBus().connect(desktopPortalService(),
+                                          m_requestPath,
+                                          portalRequestInterface(),
+                                          portalRequestResponse(),
+                                          this,
+                                          SLOT(wallpaperResponse(uint,QVariantMap)));
+
+    QDBusMessage message =
+        QDBusMessage::createMethodCall(desktopPortalService(), desktopPortalPath(), u"org.freedesktop.portal.Wallpaper"_s, u"SetWallpaperFile"_s);
+    // QDBusUnixFileDescriptor holds a duplicate, the file can close right away
+    message << m_parentWindowId() << QVariant::fromValue(QDBusUnixFileDescriptor(file.handle()))
+            << QVariantMap{{u"handle_token"_s, token}, {u"show-preview"_s, step.preview}, {u"set-on"_s, m_setOn->currentData()}};
+
+    m_requestClock.start();
+    const QString requestPath = m_requestPath;
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, requestPath](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (requestPath != m_requestPath) {
+            return;
+        }
+        if (watcher->isError()) {
+            qWarning() << "SetWallpaperFile failed:" << watcher->error().message();
+            finishRequest(callFailed);
+            return;
+        }
+        m_steps[m_currentStep].call.add(m_requestClock.nsecsElapsed());
+    });
+    m_timeout.start(step.preview ? previewResponseTimeout : responseTimeout);
+}
+
+void WallpaperBenchmarkWindow::wallpaperResponse(uint response, const QVariantMap &results)
+{
+    Q_UNUSED(results)
+    finishRequest(int(response));
+}
+
+void WallpaperBenchmarkWindow::finishRequest(int response)
+{
+    const qint64 elapsed = m_requestClock.nsecsElapsed();
+    QDBusConnection::sessionBus().disconnect(desktopPortalService(),
+                                             m_requestPath,
+                                             portalRequestInterface(),
+                                             portalRequestResponse(),
+                                             this,
+                                             SLOT(wallpaperResponse(uint,QVariantMap)));
+    m_requestPath.clear();
+    m_timeout.stop();
+    if (!m_running) {
+        return;
+    }
+
+    Step &step = m_steps[m_currentStep];
+    if (response == 0) {
+        step.accepted.add(elapsed);
+    } else if (response == timedOut) {
+        ++step.timeouts;
+    } else {
+        ++step.failures;
+    }
+    updateRow(m_currentStep);
+    ++m_currentRepetition;
+    // Outside of the D-Bus dispatch
+    QTimer::singleShot(0, this, &WallpaperBenchmarkWindow::runNext);
+}
+
+void WallpaperBenchmarkWindow::updateRow(int row)
+{
+    const Step &step = m_steps.at(row);
+    const auto set = [this, row](int column, const QString &text) {
+        m_table->setItem(row, column, new QTableWidgetItem(text));
+    };
+    set(ResolutionColumn, u"%1×%2"_s.arg(step.size.width()).arg(step.size.height()));
+    set(FileSizeColumn, QLocale().formattedDataSize(step.fileBytes));
+    set(EncodeColumn, step.encodeNsecs > 0 ? LatencyStats::formatMsecs(step.encodeNsecs) : QString());
+    set(PreviewColumn, step.preview ? i18n("yes") : i18n("no"));
+    set(CallColumn, step.call.count() > 0 ? LatencyStats::formatMsecs(step.call.percentile(0.5)) : QString());
+    set(AcceptedColumn, step.accepted.count() > 0 ? LatencyStats::formatMsecs(step.accepted.percentile(0.5)) : QString());
+    set(AcceptedTailColumn, step.accepted.count() > 0 ? LatencyStats::formatMsecs(step.accepted.max()) : QString());
+    set(FailuresColumn, u"%1 / %2"_s.arg(step.failures).arg(step.timeouts));
+}
@@ -0,0 +1,92 @@
+/*
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ * SPDX-FileCopyrightText: 2026 xdg-portal-test-kde contributors
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPair>
+#include <QSize>
+#include <QTimer>
+#include <QWidget>
+
+#include <memory>
+
+#include "benchmark/latencystats.h"
+#include "portalcommon.h"
+
+class QCheckBox;
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+class QTemporaryDir;
+
+/**
+ * Generates wallpapers of the given resolutions and hands each to SetWallpaperFile as a file
+ * descriptor, with and without the preview dialog.
+ *
+ * The call time covers marshalling the fd and creating the request; acceptance runs until
+ * the backend's Response, so with the preview it includes the time taken to confirm it.
+ */
+class WallpaperBenchmarkWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit WallpaperBenchmarkWindow(const ParentWindowIdFunction &parentWindowId, QWidget *parent = nullptr);
+    ~WallpaperBenchmarkWindow() override;
+
+public Q_SLOTS:
+    void start();
+    void stop();
+
+private Q_SLOTS:
+    void wallpaperResponse(uint response, const QVariantMap &results);
+
+private:
+    struct Step {
+        QSize size;
+        bool preview = false;
+        QString fileName;
+        qint64 fileBytes = 0;
+        qint64 encodeNsecs = 0;
+        LatencyStats call;
+        LatencyStats accepted;
+        int failures = 0;
+        int timeouts = 0;
+    };
+
+    QString imageFile(const QSize &size, qint64 *encodeNsecs);
+    void runNext();
+    void finishRequest(int response);
+    void updateRow(int row);
+
+    ParentWindowIdFunction m_parentWindowId;
+
+    QLineEdit *m_resolutions;
+    QComboBox *m_format;
+    QComboBox *m_setOn;
+    QCheckBox *m_withPreview;
+    QCheckBox *m_withoutPreview;
+    QSpinBox *m_repetitions;
+    QPushButton *m_startButton;
+    QLabel *m_status;
+    QTableWidget *m_table;
+
+    std::unique_ptr<QTemporaryDir> m_directory;
+    /// "WxH.format" -> generated file and the time it took to encode
+    QHash<QString, QPair<QString, qint64>> m_files;
+
+    QList<Step> m_steps;
+    int m_currentStep = -1;
+    int m_currentRepetition = 0;
+    bool m_running = false;
+    QString m_requestPath;
+    QElapsedTimer m_requestClock;
+    QTimer m_timeout;
+};
@@ -9,9 +9,12 @@
 #include <qpa/qplatformnativeinterface.h>
 #include <QDebug>
 #include <QGuiApplication>
+#include <QPlatformSurfaceEvent>
 #include <QWindow>
 #include <QWidget>
 
+using namespace Qt::StringLiterals;
+
 class WidgetWatcher : public QObject
 {
 public:
@@ -30,7 +33,8 @@ public:
 
     bool eventFilter(QObject * watched, QEvent * event) override {
         Q_ASSERT(watched == parent());
-        if (event->type() == QEvent::PlatformSurface) {
+        if (event->type() == QEvent::PlatformSurface && m_toExport
+            && static_cast<QPlatformSurfaceEvent *>(event)->surfaceEventType() == QPlatformSurfaceEvent::SurfaceCreated) {
             m_toExport->setWindow(m_widget->windowHandle());
         }
         return false;
@@ -49,29 +53,60 @@ XdgExportedV2::XdgExportedV2(XdgExporterV2* exporter)
 
 XdgExportedV2::~XdgExportedV2()
 {
-    destroy();
+    release();
 }
 
 void XdgExportedV2::setWindow(QWindow* window) {
     Q_ASSERT(window);
 
+    if (m_window == window) {
+        useWindow(window);
+        return;
+    }
+    if (m_window) {
+        m_window->removeEventFilter(this);
+        disconnect(m_window, nullptr, this, nullptr);
+        release();
+    }
+    m_window = window;
+
+    window->installEventFilter(this);
     useWindow(window);
     connect(window, &QWindow::visibilityChanged, this, [this, window] (QWindow::Visibility visibility) {
-        if (visibility != QWindow::Hidden) {
+        // Hiding destroys the toplevel the export refers to
+        if (visibility == QWindow::Hidden) {
+            release();
+        } else {
             useWindow(window);
         }
     });
     connect(window, &QWindow::destroyed, this, &QObject::deleteLater);
 }
 
+bool XdgExportedV2::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_window && event->type() == QEvent::PlatformSurface
+        && static_cast<QPlatformSurfaceEvent *>(event)->surfaceEventType() == QPlatformSurfaceEvent::SurfaceAboutToBeDestroyed) {
+        release();
+    }
+    return false;
+}
+
 void XdgExportedV2::useWindow(QWindow* window)
 {
+    // Already exported, keep the handle portals have been given
+    if (isInitialized()) {
+        return;
+    }
+
     QPlatformNativeInterface *nativeInterface = qGuiApp->platformNativeInterface();
     auto surface = static_cast<wl_surface *>(nativeInterface->nativeResourceForWindow("surface", window));
     if (surface) {
+        m_exportClock.start();
         auto tl = m_exporter->export_toplevel(surface);
         if (tl) {
             init(tl);
+            m_exporter->exportCreated();
         } else {
             qDebug() << "could not export top level";
         }
@@ -80,11 +115,40 @@ void XdgExportedV2::useWindow(QWindow* window)
     }
 }
 
+void XdgExportedV2::release()
+{
+    m_handle.reset();
+    if (!isInitialized()) {
+        return;
+    }
+    destroy();
+    m_exporter->exportDestroyed();
+}
+
+void XdgExportedV2::zxdg_exported_v2_handle(const QString &handle)
+{
+    m_handle = handle;
+    if (m_exportClock.isValid()) {
+        m_exporter->addRoundTrip(m_exportClock.nsecsElapsed());
+        m_exportClock.invalidate();
+    }
+    Q_EMIT handleReceived(handle);
+}
+
 std::optional<QString> XdgExportedV2::handle() const
 {
     return m_handle;
 }
 
+void XdgExportedV2::whenHandleReady(QObject *context, const std::function<void(const QString &)> &callback)
+{
+    if (m_handle) {
+        callback(*m_handle);
+        return;
+    }
+    connect(this, &XdgExportedV2::handleReceived, context, callback, Qt::SingleShotConnection);
+}
+
 ///////////////////////////////////////////////////////////
 
 XdgExporterV2::XdgExporterV2()
@@ -100,17 +164,33 @@ XdgExporterV2::XdgExporterV2()
 
 XdgExporterV2::~XdgExporterV2()
 {
+    // The exports report back to us when they go away, so they can't outlive the exporter
+    const QList<XdgExportedV2 *> exports = m_exports.values();
+    m_exports.clear();
+    qDeleteAll(exports);
     destroy();
 }
 
+XdgExportedV2 *XdgExporterV2::cached(QObject *key)
+{
+    return m_exports.value(key);
+}
+
 XdgExportedV2* XdgExporterV2::exportWindow(QWindow* window)
 {
     if (!window) {
         qDebug() << "no window!";
         return nullptr;
     }
+    if (auto exported = cached(window)) {
+        return exported;
+    }
 
     auto exported = new XdgExportedV2(this);
+    m_exports.insert(window, exported);
+    QObject::connect(exported, &QObject::destroyed, this, [this, window] {
+        m_exports.remove(window);
+    });
     exported->setWindow(window);
     return exported;
 }
@@ -120,7 +200,51 @@ XdgExportedV2* XdgExporterV2::exportWidget(QWidget* widget)
     if (widget->windowHandle()) {
         return exportWindow(widget->windowHandle());
     }
+    if (auto exported = cached(widget)) {
+        return exported;
+    }
+
     auto nakedExporter = new XdgExportedV2(this);
+    m_exports.insert(widget, nakedExporter);
+    QObject::connect(nakedExporter, &QObject::destroyed, this, [this, widget] {
+        m_exports.remove(widget);
+    });
     new WidgetWatcher(this, nakedExporter, widget);
     return nakedExporter;
 }
+
+int XdgExporterV2::liveExports() const
+{
+    return m_liveExports;
+}
+
+quint64 XdgExporterV2::exportCount() const
+{
+    return m_exportCount;
+}
+
+const LatencyStats &XdgExporterV2::roundTrips() const
+{
+    return m_roundTrips;
+}
+
+QString XdgExporterV2::summary() const
+{
+    return u"exports: %1, live: %2, round trip: %3"_s.arg(m_exportCount).arg(m_liveExports).arg(m_roundTrips.summary());
+}
+
+void XdgExporterV2::exportCreated()
+{
+    ++m_exportCount;
+    ++m_liveExports;
+}
+
+void XdgExporterV2::exportDestroyed()
+{
+    --m_liveExports;
+}
+
+void XdgExporterV2::addRoundTrip(qint64 nsecs)
+{
+    m_roundTrips.add(nsecs);
+}
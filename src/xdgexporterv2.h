@@ -6,33 +6,57 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QHash>
 #include <QPointer>
 #include <QWaylandClientExtensionTemplate>
 #include "qwayland-xdg-foreign-unstable-v2.h"
+#include <functional>
 #include <optional>
 
+#include "benchmark/latencystats.h"
+
 class QWindow;
 class XdgExporterV2;
 
+/**
+ * The export of one window. The surface is exported once while it is shown and the handle
+ * reused for every portal call; hiding the window destroys the export, showing it again
+ * creates a new one.
+ */
 class XdgExportedV2 : public QObject, public QtWayland::zxdg_exported_v2
 {
+    Q_OBJECT
+
 public:
     XdgExportedV2(XdgExporterV2* exporter);
     ~XdgExportedV2();
 
+    /// Empty until the compositor sent the handle of the current export
     std::optional<QString> handle() const;
     void setWindow(QWindow *window);
 
+    /// Calls @p callback with the handle as soon as there is one, right away if it is already known
+    void whenHandleReady(QObject *context, const std::function<void(const QString &)> &callback);
+
+Q_SIGNALS:
+    void handleReceived(const QString &handle);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private:
-    void zxdg_exported_v2_handle(const QString &handle) override {
-        m_handle = handle;
-    }
+    void zxdg_exported_v2_handle(const QString &handle) override;
     void useWindow(QWindow *window);
+    void release();
 
     std::optional<QString> m_handle;
     XdgExporterV2 *const m_exporter;
+    QPointer<QWindow> m_window;
+    QElapsedTimer m_exportClock;
 };
 
+/// Hands out one XdgExportedV2 per window or widget and keeps count of them
 class XdgExporterV2 : public QWaylandClientExtensionTemplate<XdgExporterV2>, public QtWayland::zxdg_exporter_v2
 {
 public:
@@ -41,4 +65,24 @@ public:
 
     XdgExportedV2 *exportWindow(QWindow *window);
     XdgExportedV2 *exportWidget(QWidget *widget);
+
+    /// zxdg_exported_v2 objects currently alive on the compositor side
+    int liveExports() const;
+    /// export_toplevel requests made so far
+    quint64 exportCount() const;
+    /// Time from export_toplevel to the handle event
+    const LatencyStats &roundTrips() const;
+    QString summary() const;
+
+private:
+    friend class XdgExportedV2;
+    void exportCreated();
+    void exportDestroyed();
+    void addRoundTrip(qint64 nsecs);
+    XdgExportedV2 *cached(QObject *key);
+
+    QHash<QObject *, XdgExportedV2 *> m_exports;
+    int m_liveExports = 0;
+    quint64 m_exportCount = 0;
+    LatencyStats m_roundTrips;
 };
@@ -7,7 +7,6 @@
 
 #include "xdgportaltest.h"
 
-#include <QBuffer>
 #include <QDBusArgument>
 #include <QDBusConnection>
 #include <QDBusConnectionInterface>
@@ -20,12 +19,16 @@
 #include <QMenuBar>
 #include <QPainter>
 #include <QPdfWriter>
+#include <QScreen>
 #include <QStandardPaths>
+#include <QStatusBar>
 #include <QSystemTrayIcon>
 #include <QTemporaryFile>
+#include <QTextStream>
 #include <QWindow>
 
 #include <KIO/OpenUrlJob>
+#include <KLocalizedString>
 #include <KNotification>
 #include <KNotificationReplyAction>
 #include <KWindowSystem>
@@ -33,97 +36,47 @@
 #include <gst/gst.h>
 #include <optional>
 
+#include "camera/camerabenchmarkwindow.h"
 #include "dropsite/dropsitewindow.h"
+#include "dynamiclauncher/launcherchurnwindow.h"
+#include "email/emailbenchmarkwindow.h"
+#include "filetransfer/filetransferbenchmarkwindow.h"
+#include "globalshortcuts/globalshortcutswindow.h"
+#include "inhibit/inhibitmatrixwindow.h"
+#include "location/locationanalyzerwindow.h"
+#include "location/locationmonitor.h"
+#include "location/locationsessionswindow.h"
+#include "memorymonitor/cacheregistry.h"
+#include "memorymonitor/memorymonitorwindow.h"
+#include "notifications/notificationportalwindow.h"
+#include "openuri/openuribenchmarkwindow.h"
+#include "parenting/parentingstresswindow.h"
+#include "powerprofile/powerprofilewatcher.h"
+#include "remotedesktop/remotedesktopwindow.h"
+#include "settings/settingswindow.h"
+#include "trash/trashbenchmarkwindow.h"
+#include "wallpaper/wallpaperbenchmarkwindow.h"
 #include <globalshortcuts_portal_interface.h>
 #include <portalsrequest_interface.h>
 
+#include "portalcommon.h"
+#include "iconcache.h"
+#include "portaldecoders.h"
+#include "portalicon.h"
 #include "xdgexporterv2.h"
 
 Q_LOGGING_CATEGORY(XdgPortalTestKde, "xdg-portal-test-kde")
 
-Q_DECLARE_METATYPE(XdgPortalTest::Stream);
-Q_DECLARE_METATYPE(XdgPortalTest::Streams);
-
 using namespace Qt::StringLiterals;
 
-struct PortalIcon {
-    QString str;
-    QDBusVariant data;
-
-    static void registerDBusType()
-    {
-        qDBusRegisterMetaType<PortalIcon>();
-    }
-};
-Q_DECLARE_METATYPE(PortalIcon);
-
-QDBusArgument &operator<<(QDBusArgument &argument, const PortalIcon &icon)
-{
-    argument.beginStructure();
-    argument << icon.str << icon.data;
-    argument.endStructure();
-    return argument;
-}
-
-const QDBusArgument &operator>>(const QDBusArgument &argument, PortalIcon &icon)
-{
-    argument.beginStructure();
-    argument >> icon.str >> icon.data;
-    argument.endStructure();
-    return argument;
-}
-
-/// a(sa{sv})
-using Shortcuts = QList<QPair<QString, QVariantMap>>;
-
-const QDBusArgument &operator >> (const QDBusArgument &arg, XdgPortalTest::Stream &stream)
-{
-    arg.beginStructure();
-    arg >> stream.node_id;
-
-    arg.beginMap();
-    while (!arg.atEnd()) {
-        QString key;
-        QVariant map;
-        arg.beginMapEntry();
-        arg >> key >> map;
-        arg.endMapEntry();
-        stream.map.insert(key, map);
-    }
-    arg.endMap();
-    arg.endStructure();
-
-    return arg;
-}
-
-static QString desktopPortalService()
-{
-    return QStringLiteral("org.freedesktop.portal.Desktop");
-}
-
-static QString desktopPortalPath()
-{
-    return QStringLiteral("/org/freedesktop/portal/desktop");
-}
-
-static QString portalRequestInterface()
-{
-    return QStringLiteral("org.freedesktop.portal.Request");
-}
-
-static QString portalRequestResponse()
-{
-    return QStringLiteral("Response");
-}
-
 QString XdgPortalTest::parentWindowId() const
 {
     switch (KWindowSystem::platform()) {
     case KWindowSystem::Platform::X11:
         return QLatin1String("x11:") + QString::number(winId());
     case KWindowSystem::Platform::Wayland:
-        if (!m_xdgExported) {
-            qDebug() << "nope!";
+        if (!m_xdgExported || !m_xdgExported->handle()) {
+            qWarning() << "The window has no exported handle yet, use whenParentWindowIdReady() to wait for it";
             return {};
         }
         return QLatin1String("wayland:") + *m_xdgExported->handle();
@@ -133,6 +86,17 @@ QString XdgPortalTest::parentWindowId() const
     return {};
 }
 
+void XdgPortalTest::whenParentWindowIdReady(const std::function<void(const QString &)> &callback)
+{
+    if (KWindowSystem::platform() != KWindowSystem::Platform::Wayland || !m_xdgExported) {
+        callback(parentWindowId());
+        return;
+    }
+    m_xdgExported->whenHandleReady(this, [callback](const QString &handle) {
+        callback(QLatin1String("wayland:") + handle);
+    });
+}
+
 XdgPortalTest::XdgPortalTest(QWidget *parent, Qt::WindowFlags f)
     : QMainWindow(parent, f)
     , m_mainWindow(std::make_unique<Ui::XdgPortalTest>())
@@ -151,6 +115,65 @@ XdgPortalTest::XdgPortalTest(QWidget *parent, Qt::WindowFlags f)
     auto dropSite = new DropSiteWindow(m_mainWindow->dropSite);
     dropSiteLayout->addWidget(dropSite);
 
+    auto notificationPortalLayout = new QVBoxLayout(m_mainWindow->notificationPortal);
+    notificationPortalLayout->addWidget(new NotificationPortalWindow(m_mainWindow->notificationPortal));
+
+    auto launcherChurnLayout = new QVBoxLayout(m_mainWindow->launcherChurn);
+    launcherChurnLayout->addWidget(new LauncherChurnWindow([this] {
+        return parentWindowId();
+    }, m_mainWindow->launcherChurn));
+
+    auto inhibitMatrixLayout = new QVBoxLayout(m_mainWindow->inhibitMatrix);
+    inhibitMatrixLayout->addWidget(new InhibitMatrixWindow([this] {
+        return parentWindowId();
+    }, m_mainWindow->inhibitMatrix));
+
+    auto locationAnalyzerLayout = new QVBoxLayout(m_mainWindow->locationAnalyzer);
+    locationAnalyzerLayout->addWidget(new LocationAnalyzerWindow([this] {
+        return parentWindowId();
+    }, m_mainWindow->locationAnalyzer));
+
+    auto locationSessionsLayout = new QVBoxLayout(m_mainWindow->locationSessions);
+    locationSessionsLayout->addWidget(new LocationSessionsWindow([this] {
+        return parentWindowId();
+    }, m_mainWindow->locationSessions));
+
+    auto fileTransferBenchmarkLayout = new QVBoxLayout(m_mainWindow->fileTransferBenchmark);
+    fileTransferBenchmarkLayout->addWidget(new FileTransferBenchmarkWindow(m_mainWindow->fileTransferBenchmark));
+
+    auto remoteDesktopLayout = new QVBoxLayout(m_mainWindow->remoteDesktop);
+    m_remoteDesktopWindow = new RemoteDesktopWindow([this] {
+        return parentWindowId();
+    }, m_mainWindow->remoteDesktop);
+    remoteDesktopLayout->addWidget(m_remoteDesktopWindow);
+
+    auto settingsLayout = new QVBoxLayout(m_mainWindow->settings);
+    settingsLayout->addWidget(new SettingsWindow(m_mainWindow->settings));
+
+    auto memoryMonitorLayout = new QVBoxLayout(m_mainWindow->memoryMonitor);
+    memoryMonitorLayout->addWidget(new MemoryMonitorWindow(m_mainWindow->memoryMonitor));
+
+    auto wallpaperLayout = new QVBoxLayout(m_mainWindow->wallpaper);
+    wallpaperLayout->addWidget(new WallpaperBenchmarkWindow([this] {
+        return parentWindowId();
+    }, m_mainWindow->wallpaper));
+
+    auto trashLayout = new QVBoxLayout(m_mainWindow->trash);
+    trashLayout->addWidget(new TrashBenchmarkWindow(m_mainWindow->trash));
+
+    auto openUriLayout = new QVBoxLayout(m_mainWindow->openUri);
+    openUriLayout->addWidget(new OpenUriBenchmarkWindow([this] {
+        return parentWindowId();
+    }, m_mainWindow->openUri));
+
+    auto cameraLayout = new QVBoxLayout(m_mainWindow->camera);
+    cameraLayout->addWidget(new CameraBenchmarkWindow(m_mainWindow->camera));
+
+    auto emailLayout = new QVBoxLayout(m_mainWindow->email);
+    emailLayout->addWidget(new EmailBenchmarkWindow([this] {
+        return parentWindowId();
+    }, m_mainWindow->email));
+
     m_mainWindow->sandboxLabel->setText(isRunningSandbox() ? QLatin1String("yes") : QLatin1String("no"));
     m_mainWindow->printWarning->setText(QLatin1String("Select an image in JPG format using FileChooser part!!"));
 
@@ -214,6 +237,22 @@ XdgPortalTest::XdgPortalTest(QWidget *parent, Qt::WindowFlags f)
     connect(m_mainWindow->removeWebAppButton, &QPushButton::clicked, this, &XdgPortalTest::removeLauncher);
     connect(m_mainWindow->startLocationSession, &QPushButton::clicked, this, &XdgPortalTest::requestLocation);
 
+    m_locationMonitor = new LocationMonitor(this);
+    // GNSS sources deliver faster than a label can sensibly be redrawn, so refresh at most once per frame
+    m_locationRefreshTimer.setSingleShot(true);
+    connect(&m_locationRefreshTimer, &QTimer::timeout, this, &XdgPortalTest::updateLocationResults);
+    connect(m_locationMonitor, &LocationMonitor::updated, this, [this] {
+        if (!m_locationRefreshTimer.isActive()) {
+            m_locationRefreshTimer.start(qMax(1, qRound(1000.0 / qMax(1.0, screen()->refreshRate()))));
+        }
+    });
+    connect(m_mainWindow->exportLocationCsv, &QPushButton::clicked, this, [this] {
+        const QString fileName = QFileDialog::getSaveFileName(this, i18n("Export Location Samples"), u"location.csv"_s, i18n("CSV files (*.csv)"));
+        if (!fileName.isEmpty()) {
+            m_locationMonitor->exportCsv(fileName);
+        }
+    });
+
     // launcher buttons only work correctly inside sandboxes
     m_mainWindow->webAppButton->setEnabled(isRunningSandbox());
     m_mainWindow->removeWebAppButton->setEnabled(isRunningSandbox());
@@ -227,6 +266,12 @@ XdgPortalTest::XdgPortalTest(QWidget *parent, Qt::WindowFlags f)
                                                                       QLatin1String("/org/freedesktop/portal/desktop"),
                                                                       QDBusConnection::sessionBus(), this);
 
+    auto globalShortcutsLayout = new QVBoxLayout(m_mainWindow->globalShortcuts);
+    m_globalShortcutsWindow = new GlobalShortcutsWindow(m_shortcuts, [this] {
+        return parentWindowId();
+    }, m_mainWindow->globalShortcuts);
+    globalShortcutsLayout->addWidget(m_globalShortcutsWindow);
+
     connect(m_shortcuts, &OrgFreedesktopPortalGlobalShortcutsInterface::Activated, this, [this] (const QDBusObjectPath &session_handle, const QString &shortcut_id, qulonglong timestamp, const QVariantMap &options) {
         qDebug() << "activated" << session_handle.path() << shortcut_id << timestamp << options;
         m_mainWindow->shortcutState->setText(QStringLiteral("Active!"));
@@ -234,6 +279,8 @@ XdgPortalTest::XdgPortalTest(QWidget *parent, Qt::WindowFlags f)
     connect(m_shortcuts, &OrgFreedesktopPortalGlobalShortcutsInterface::Deactivated, this, [this] {
         m_mainWindow->shortcutState->setText(QStringLiteral("Deactivated!"));
     });
+    connect(m_shortcuts, &OrgFreedesktopPortalGlobalShortcutsInterface::Activated, m_globalShortcutsWindow, &GlobalShortcutsWindow::activated);
+    connect(m_shortcuts, &OrgFreedesktopPortalGlobalShortcutsInterface::Deactivated, m_globalShortcutsWindow, &GlobalShortcutsWindow::deactivated);
 
     auto reply = m_shortcuts->CreateSession({
         { QLatin1String("session_handle_token"), "XdpPortalTest" },
@@ -255,12 +302,93 @@ XdgPortalTest::XdgPortalTest(QWidget *parent, Qt::WindowFlags f)
 
     gst_init(nullptr, nullptr);
 
+    CacheRegistry::instance().add(i18n("Icon cache"),
+                                  CacheRegistry::Low,
+                                  nullptr,
+                                  [] {
+                                      return IconCache::instance().cost();
+                                  },
+                                  [] {
+                                      IconCache::instance().clear();
+                                  });
+    connect(&PowerProfileWatcher::instance(), &PowerProfileWatcher::powerSaverChanged, this, [this] {
+        for (GstElement *pipeline : std::as_const(m_screenCastPipelines)) {
+            applyScreenCastFramerate(pipeline);
+        }
+    });
+    // The buffers of a running preview can't be measured, only RSS shows what stopping it gave back
+    CacheRegistry::instance().add(i18n("Screencast previews"), CacheRegistry::Critical, this, nullptr, [this] {
+        stopScreenCastPipelines();
+    });
+
     m_xdgExporter.reset(new XdgExporterV2);
     m_xdgExported = m_xdgExporter->exportWidget(this);
+
+    auto parentingStressLayout = new QVBoxLayout(m_mainWindow->parentingStress);
+    m_parentingStressWindow = new ParentingStressWindow(m_xdgExporter.data(), m_mainWindow->parentingStress);
+    parentingStressLayout->addWidget(m_parentingStressWindow);
+    connect(m_xdgExported, &XdgExportedV2::handleReceived, this, [this](const QString &handle) {
+        statusBar()->showMessage(i18n("Exported as %1; %2", handle, m_xdgExporter->summary()));
+    });
 }
 
 XdgPortalTest::~XdgPortalTest()
 {
+    stopScreenCastPipelines();
+    if (!m_locationMonitor->session().path().isEmpty()) {
+        closePortalSession(m_locationMonitor->session().path());
+    }
+}
+
+void XdgPortalTest::applyScreenCastFramerate(GstElement *pipeline)
+{
+    GstElement *rate = gst_bin_get_by_name(GST_BIN(pipeline), "rate");
+    if (!rate) {
+        return;
+    }
+    GstCaps *caps = PowerProfileWatcher::instance().powerSaverEnabled()
+        ? gst_caps_new_simple("video/x-raw", "framerate", GST_TYPE_FRACTION, PowerProfileWatcher::powerSaverFramerate, 1, nullptr)
+        : gst_caps_new_any();
+    g_object_set(rate, "caps", caps, nullptr);
+    gst_caps_unref(caps);
+    gst_object_unref(rate);
+}
+
+void XdgPortalTest::stopScreenCastPipelines()
+{
+    for (GstElement *pipeline : std::as_const(m_screenCastPipelines)) {
+        gst_element_set_state(pipeline, GST_STATE_NULL);
+        gst_object_unref(pipeline);
+    }
+    m_screenCastPipelines.clear();
+}
+
+void XdgPortalTest::runParentingStress(int windows)
+{
+    m_mainWindow->tabWidget->setCurrentWidget(m_mainWindow->parentingStress);
+    connect(m_parentingStressWindow, &ParentingStressWindow::finished, this, [this] {
+        QTextStream(stdout) << m_parentingStressWindow->summary() << Qt::endl;
+        m_parentingStressWindow->closeWindows();
+        qApp->quit();
+    });
+    // Once the main window is mapped, so that the stress windows don't race its own export
+    whenParentWindowIdReady([this, windows](const QString &) {
+        m_parentingStressWindow->start(windows);
+    });
+}
+
+void XdgPortalTest::runRemoteDesktop(int rate, const QString &mode)
+{
+    m_mainWindow->tabWidget->setCurrentWidget(m_mainWindow->remoteDesktop);
+    connect(m_remoteDesktopWindow, &RemoteDesktopWindow::finished, this, [this] {
+        QTextStream(stdout) << m_remoteDesktopWindow->summary() << Qt::endl;
+        m_remoteDesktopWindow->closeSession();
+        qApp->quit();
+    });
+    // Start needs the parent window for its dialog
+    whenParentWindowIdReady([this, rate, mode](const QString &) {
+        m_remoteDesktopWindow->runBatch(rate, mode);
+    });
 }
 
 void XdgPortalTest::notificationActivated(const QString &action)
@@ -356,14 +484,8 @@ void XdgPortalTest::gotPrintResponse(uint response, const QVariantMap &results)
 void XdgPortalTest::gotPreparePrintResponse(uint response, const QVariantMap &results)
 {
     if (!response) {
-        QVariantMap settings;
-        QVariantMap pageSetup;
-
-        QDBusArgument dbusArgument = results.value(QLatin1String("settings")).value<QDBusArgument>();
-        dbusArgument >> settings;
-
-        QDBusArgument dbusArgument1 = results.value(QLatin1String("page-setup")).value<QDBusArgument>();
-        dbusArgument1 >> pageSetup;
+        PortalDecoders::PrintSetup setup;
+        PortalDecoders::decodePrintSetup(results, setup);
 
         QTemporaryFile tempFile;
         tempFile.setAutoRemove(false);
@@ -375,24 +497,14 @@ void XdgPortalTest::gotPreparePrintResponse(uint response, const QVariantMap &re
         QPdfWriter writer(tempFile.fileName());
         QPainter painter(&writer);
 
-        if (pageSetup.contains(QLatin1String("Orientation"))) {
-            const QString orientation = pageSetup.value(QLatin1String("Orientation")).toString();
-            if (orientation == QLatin1String("portrait") || orientation == QLatin1String("revers-portrait")) {
-                writer.setPageOrientation(QPageLayout::Portrait);
-            } else if (orientation == QLatin1String("landscape") || orientation == QLatin1String("reverse-landscape")) {
-                writer.setPageOrientation(QPageLayout::Landscape);
-            }
+        if (setup.orientation == QLatin1String("portrait") || setup.orientation == QLatin1String("revers-portrait")) {
+            writer.setPageOrientation(QPageLayout::Portrait);
+        } else if (setup.orientation == QLatin1String("landscape") || setup.orientation == QLatin1String("reverse-landscape")) {
+            writer.setPageOrientation(QPageLayout::Landscape);
         }
 
-        if (pageSetup.contains(QLatin1String("MarginTop")) &&
-            pageSetup.contains(QLatin1String("MarginBottom")) &&
-            pageSetup.contains(QLatin1String("MarginLeft")) &&
-            pageSetup.contains(QLatin1String("MarginRight"))) {
-            const int marginTop = pageSetup.value(QLatin1String("MarginTop")).toInt();
-            const int marginBottom = pageSetup.value(QLatin1String("MarginBottom")).toInt();
-            const int marginLeft = pageSetup.value(QLatin1String("MarginLeft")).toInt();
-            const int marginRight = pageSetup.value(QLatin1String("MarginRight")).toInt();
-            writer.setPageMargins(QMarginsF(marginLeft, marginTop, marginRight, marginBottom), QPageLayout::Millimeter);
+        if (setup.hasMargins) {
+            writer.setPageMargins(QMarginsF(setup.marginLeft, setup.marginTop, setup.marginRight, setup.marginBottom), QPageLayout::Millimeter);
         }
 
         // TODO num-copies, pages
@@ -410,7 +522,7 @@ void XdgPortalTest::gotPreparePrintResponse(uint response, const QVariantMap &re
                                                             QLatin1String("org.freedesktop.portal.Print"),
                                                             QLatin1String("Print"));
 
-        message << parentWindowId() << QLatin1String("Print dialog") << QVariant::fromValue<QDBusUnixFileDescriptor>(descriptor) << QVariantMap{{QLatin1String("token"), results.value(QLatin1String("token")).toUInt()}, { QLatin1String("handle_token"), getRequestToken() }};
+        message << parentWindowId() << QLatin1String("Print dialog") << QVariant::fromValue<QDBusUnixFileDescriptor>(descriptor) << QVariantMap{{QLatin1String("token"), setup.token}, { QLatin1String("handle_token"), getRequestToken() }};
 
         QDBusPendingCall pendingCall = QDBusConnection::sessionBus().asyncCall(message);
         auto watcher = new QDBusPendingCallWatcher(pendingCall);
@@ -590,8 +702,11 @@ void XdgPortalTest::sendNotificationPixmap()
         this->notificationActivated(action2->label());
     });
 
-    QPixmap pixmap(64, 64);
-    pixmap.fill(Qt::red);
+    const QPixmap pixmap = IconCache::instance().pixmap(QStringLiteral("red-64"), [] {
+        QPixmap pixmap(64, 64);
+        pixmap.fill(Qt::red);
+        return pixmap;
+    });
 
     notify->setPixmap(pixmap);
 
@@ -816,8 +931,9 @@ void XdgPortalTest::gotStartResponse(uint response, const QVariantMap &results)
         qWarning() << "Failed to start: " << response;
     }
 
-    Streams streams = qdbus_cast<Streams>(results.value(QLatin1String("streams")));
-    for (const auto &stream : streams) {
+    QList<PortalDecoders::Stream> streams;
+    PortalDecoders::decodeStreams(results.value(QLatin1String("streams")).value<QDBusArgument>(), streams);
+    for (const auto &stream : std::as_const(streams)) {
         QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(),
                                                               desktopPortalPath(),
                                                               QLatin1String("org.freedesktop.portal.ScreenCast"),
@@ -829,12 +945,17 @@ void XdgPortalTest::gotStartResponse(uint response, const QVariantMap &results)
         pendingCall.waitForFinished();
         QDBusPendingReply<QDBusUnixFileDescriptor> reply = pendingCall.reply();
         if (reply.isError()) {
-            qWarning() << "Failed to get fd for node_id " << stream.node_id;
+            qWarning() << "Failed to get fd for node_id " << stream.nodeId;
         }
 
-        QString gstLaunch = QString("pipewiresrc fd=%1 path=%2 ! videoconvert ! xvimagesink").arg(reply.value().fileDescriptor()).arg(stream.node_id);
+        // videorate only drops frames, its caps limit the rate while power saving
+        QString gstLaunch = QString("pipewiresrc fd=%1 path=%2 ! videorate drop-only=true ! capsfilter name=rate ! videoconvert ! xvimagesink")
+                                .arg(reply.value().fileDescriptor())
+                                .arg(stream.nodeId);
         GstElement *element = gst_parse_launch(gstLaunch.toUtf8(), nullptr);
+        applyScreenCastFramerate(element);
         gst_element_set_state(element, GST_STATE_PLAYING);
+        m_screenCastPipelines.append(element);
     }
 }
 
@@ -931,10 +1052,10 @@ void XdgPortalTest::addLauncher()
                                                           QLatin1String("org.freedesktop.portal.DynamicLauncher"),
                                                           QLatin1String("PrepareInstall"));
 
-    QBuffer buffer;
     static constexpr auto maxSize = 512;
-    QIcon::fromTheme("utilities-terminal").pixmap(maxSize, maxSize).save(&buffer,"PNG");
-    PortalIcon icon {QStringLiteral("bytes"), QDBusVariant(buffer.buffer())};
+    auto &iconCache = IconCache::instance();
+    // PrepareInstall only takes "bytes" icons, g_icon_deserialize() can't turn a fd into a GBytesIcon
+    const PortalIcon icon = iconCache.portalIcon(iconCache.themedIcon(QStringLiteral("utilities-terminal"), maxSize), false);
 
     message << parentWindowId() << QStringLiteral("Patschen")
             << QVariant::fromValue(QDBusVariant(QVariant::fromValue(icon)))
@@ -1019,6 +1140,7 @@ void XdgPortalTest::gotGlobalShortcutsCreateSessionResponse(uint res, const QVar
     }
 
     m_globalShortcutsSession = QDBusObjectPath(results["session_handle"].toString());
+    m_globalShortcutsWindow->setSession(m_globalShortcutsSession);
 
     auto reply = m_shortcuts->ListShortcuts(m_globalShortcutsSession, {});
     reply.waitForFinished();
@@ -1047,14 +1169,11 @@ void XdgPortalTest::gotListShortcutsResponse(uint code, const QVariantMap& resul
         return;
     }
 
-    Shortcuts s;
-    const auto arg = results["shortcuts"].value<QDBusArgument>();
-    arg >> s;
-    QString desc;
-    for (auto it = s.cbegin(), itEnd = s.cend(); it != itEnd; ++it) {
-        desc += i18n("%1: %2 %3", it->first, it->second["description"].toString(), it->second["trigger_description"].toString());
-    }
-    m_mainWindow->shortcutsDescriptions->setText(desc);
+    QList<PortalDecoders::Shortcut> s;
+    PortalDecoders::decodeShortcuts(results["shortcuts"].value<QDBusArgument>(), s);
+    // The full list lives in the Global Shortcuts tab, re-rendering it here doesn't scale to thousands of shortcuts
+    m_globalShortcutsWindow->model()->apply(s);
+    m_mainWindow->shortcutsDescriptions->setText(i18np("%1 shortcut bound", "%1 shortcuts bound", s.size()));
 }
 
 void XdgPortalTest::configureShortcuts()
@@ -1078,6 +1197,12 @@ void XdgPortalTest::configureShortcuts()
 
 void XdgPortalTest::requestLocation()
 {
+    // One session at a time here, the Location Sessions tab runs them in parallel
+    if (!m_locationMonitor->session().path().isEmpty()) {
+        closePortalSession(m_locationMonitor->session().path());
+        m_locationMonitor->setSession({});
+    }
+
     QDBusMessage message = QDBusMessage::createMethodCall(desktopPortalService(),
                                                           desktopPortalPath(),
                                                           "org.freedesktop.portal.Location"_L1,
@@ -1097,16 +1222,10 @@ void XdgPortalTest::requestLocation()
             qWarning() << "Couldn't get reply";
             qWarning() << "Error: " << reply.error().message();
         } else {
+            m_locationMonitor->setSession(reply.value());
             startLocation(reply.value());
         }
     });
-
-    QDBusConnection::sessionBus().connect(desktopPortalService(),
-                                        desktopPortalPath(),
-                                        "org.freedesktop.portal.Location"_L1,
-                                        "LocationUpdated"_L1,
-                                        this,
-                                        SLOT(gotLocationUpdated(QDBusObjectPath,QVariantMap)));
 }
 
 void XdgPortalTest::startLocation(QDBusObjectPath session)
@@ -1116,31 +1235,37 @@ void XdgPortalTest::startLocation(QDBusObjectPath session)
                                                           "org.freedesktop.portal.Location"_L1,
                                                           "Start"_L1);
 
-    message << QVariant::fromValue(session)
-            << parentWindowId()
-            << QVariantMap { { "handle_token"_L1, getRequestToken() } };
+    // Start may show an access dialog, which needs a valid parent
+    whenParentWindowIdReady([this, message, session](const QString &parentWindow) mutable {
+        message << QVariant::fromValue(session)
+                << parentWindow
+                << QVariantMap { { "handle_token"_L1, getRequestToken() } };
 
-    QDBusPendingCall pendingCall = QDBusConnection::sessionBus().asyncCall(message);
-    pendingCall.waitForFinished();
-    QDBusPendingReply<QDBusObjectPath> reply = pendingCall.reply();
-    if (reply.isError()) {
-        qWarning() << "Failed to start location session:" << reply.error();
-    }
+        QDBusPendingCall pendingCall = QDBusConnection::sessionBus().asyncCall(message);
+        pendingCall.waitForFinished();
+        QDBusPendingReply<QDBusObjectPath> reply = pendingCall.reply();
+        if (reply.isError()) {
+            qWarning() << "Failed to start location session:" << reply.error();
+        }
+    });
 }
 
-void XdgPortalTest::gotLocationUpdated(const QDBusObjectPath &session_handle, const QVariantMap &results)
+void XdgPortalTest::updateLocationResults()
 {
-    qDebug() << "Location updated:" << results;
-
+    const auto &samples = m_locationMonitor->samples();
     QString resultsString = u"Location results:\n"_s;
-    resultsString += u"    Session handle: %1\n"_s.arg(session_handle.path());
-    resultsString += u"    Latitude: %1\n"_s.arg(results["Latitude"].toDouble());
-    resultsString += u"    Longitude: %1\n"_s.arg(results["Longitude"].toDouble());
-    resultsString += u"    Altitude: %1\n"_s.arg(results["Altitude"].toDouble());
-    resultsString += u"    Accuracy: %1\n"_s.arg(results["Accuracy"].toDouble());
-    resultsString += u"    Speed: %1\n"_s.arg(results["Speed"].toDouble());
-    resultsString += u"    Heading: %1\n"_s.arg(results["Heading"].toDouble());
-    resultsString += u"    Timestamp: %1\n"_s.arg(results["Timestamp"].toLongLong());
+    resultsString += u"    Session handle: %1\n"_s.arg(m_locationMonitor->session().path());
+    if (!samples.isEmpty()) {
+        const PortalDecoders::Location &location = samples.last().location;
+        resultsString += u"    Latitude: %1\n"_s.arg(location.latitude);
+        resultsString += u"    Longitude: %1\n"_s.arg(location.longitude);
+        resultsString += u"    Altitude: %1\n"_s.arg(location.altitude);
+        resultsString += u"    Accuracy: %1\n"_s.arg(location.accuracy);
+        resultsString += u"    Speed: %1\n"_s.arg(location.speed);
+        resultsString += u"    Heading: %1\n"_s.arg(location.heading);
+        resultsString += u"    Timestamp: %1\n"_s.arg(location.timestampSeconds);
+    }
+    resultsString += m_locationMonitor->summary();
     m_mainWindow->locationResultsLabel->setText(resultsString);
 }
 
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include <QDBusObjectPath>
@@ -14,11 +15,16 @@
 #include <QPointer>
 #include <QLoggingCategory>
 #include <QMainWindow>
+#include <QTimer>
 
 #include "ui_xdgportaltest.h"
 
 class QDBusMessage;
+class GlobalShortcutsWindow;
+class LocationMonitor;
 class OrgFreedesktopPortalGlobalShortcutsInterface;
+class ParentingStressWindow;
+class RemoteDesktopWindow;
 
 namespace Ui
 {
@@ -29,20 +35,20 @@ Q_DECLARE_LOGGING_CATEGORY(XdgPortalTestKde)
 
 class XdgExporterV2;
 class XdgExportedV2;
+typedef struct _GstElement GstElement;
 
 class XdgPortalTest : public QMainWindow
 {
     Q_OBJECT
 public:
-    struct Stream {
-        uint node_id;
-        QVariantMap map;
-    } ;
-    using Streams = QList<Stream>;
-
     explicit XdgPortalTest(QWidget *parent = Q_NULLPTR, Qt::WindowFlags f = Qt::WindowFlags());
     ~XdgPortalTest();
 
+    /// Runs the parenting stress test with @p windows windows, prints its summary and quits
+    void runParentingStress(int windows);
+    /// Injects @p mode input (pointer, keyboard or both) through a RemoteDesktop session at @p rate events per second, prints the latencies and quits
+    void runRemoteDesktop(int rate, const QString &mode);
+
 public Q_SLOTS:
     void gotCreateSessionResponse(uint response, const QVariantMap &results);
     void gotSelectSourcesResponse(uint response, const QVariantMap &results);
@@ -53,7 +59,6 @@ public Q_SLOTS:
     void gotAccountResponse(uint response, const QVariantMap &results);
     void gotGlobalShortcutsCreateSessionResponse(uint, const QVariantMap &results);
     void gotListShortcutsResponse(uint, const QVariantMap &results);
-    void gotLocationUpdated(const QDBusObjectPath &session_handle, const QVariantMap &results);
     void inhibitRequested();
     void uninhibitRequested();
     void notificationActivated(const QString &label);
@@ -84,6 +89,12 @@ private:
     QString getSessionToken();
     QString getRequestToken();
     QString parentWindowId() const;
+    /// Calls @p callback with the parent_window identifier once it is known, on Wayland after the export handle arrived
+    void whenParentWindowIdReady(const std::function<void(const QString &)> &callback);
+    void updateLocationResults();
+    /// Limits the preview frame rate while power saving, see PowerProfileWatcher
+    void applyScreenCastFramerate(GstElement *pipeline);
+    void stopScreenCastPipelines();
 
     QDBusObjectPath m_inhibitionRequest;
     QString m_session;
@@ -93,7 +104,13 @@ private:
 
     QScopedPointer<XdgExporterV2> m_xdgExporter;
     QPointer<XdgExportedV2> m_xdgExported;
+    ParentingStressWindow *m_parentingStressWindow;
+    RemoteDesktopWindow *m_remoteDesktopWindow;
     QString m_globalShortcutsSessionToken;
     QDBusObjectPath m_globalShortcutsSession;
     OrgFreedesktopPortalGlobalShortcutsInterface *m_shortcuts;
+    GlobalShortcutsWindow *m_globalShortcutsWindow;
+    LocationMonitor *m_locationMonitor;
+    QTimer m_locationRefreshTimer;
+    QList<GstElement *> m_screenCastPipelines;
 };